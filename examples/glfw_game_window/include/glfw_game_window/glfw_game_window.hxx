@@ -83,6 +83,7 @@ namespace mope::glfw
 
         // Implementation of mope::I_game_window.
         auto get_context() -> std::unique_ptr<gl::context> override;
+        auto make_shared_context() -> std::unique_ptr<gl::shared_context> override;
         auto get_gl_loader() -> void* (*)(char const*) override;
         void process_inputs() override;
         void swap() override;
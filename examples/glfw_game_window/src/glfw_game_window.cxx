@@ -14,6 +14,7 @@ namespace
 {
     void init_glfw();
     void deinit_glfw();
+    void set_context_hints(mope::gl::version_and_profile profile);
     auto remap_glfw_key(int key) -> std::optional<mope::glfw::key>;
     void throw_glfw_error(int code, const char* description);
 } // namespace
@@ -28,6 +29,21 @@ namespace mope::glfw
         GLFWwindow* m_previous_context;
     };
 
+    /// A hidden window, whose only purpose is to own a context that shares
+    /// objects with a visible window's.
+    struct shared_context : public gl::shared_context
+    {
+        shared_context(GLFWwindow* share, gl::version_and_profile profile);
+        ~shared_context();
+
+        shared_context(shared_context const&) = delete;
+        auto operator=(shared_context const&) -> shared_context& = delete;
+
+        auto make_current() -> std::unique_ptr<gl::context> override;
+
+        GLFWwindow* m_glfw_window;
+    };
+
     struct window::imp
     {
         imp(
@@ -44,6 +60,7 @@ namespace mope::glfw
         operator GLFWwindow*();
 
         GLFWwindow* m_glfw_window;
+        gl::version_and_profile m_profile;
         static int s_glfw_use_count;
     };
 
@@ -61,11 +78,36 @@ mope::glfw::context::~context()
     ::glfwMakeContextCurrent(m_previous_context);
 }
 
+mope::glfw::shared_context::shared_context(GLFWwindow* share, gl::version_and_profile profile)
+    : m_glfw_window{ nullptr }
+{
+    set_context_hints(profile);
+    ::glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    m_glfw_window = ::glfwCreateWindow(1, 1, "", nullptr, share);
+    ::glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+
+    if (nullptr == m_glfw_window) {
+        throw glfw_error{ "Failed to create a shared GLFW context." };
+    }
+}
+
+mope::glfw::shared_context::~shared_context()
+{
+    ::glfwDestroyWindow(m_glfw_window);
+}
+
+auto mope::glfw::shared_context::make_current() -> std::unique_ptr<gl::context>
+{
+    return std::make_unique<context>(m_glfw_window);
+}
+
 mope::glfw::window::imp::imp(
     char const* title,
     vec2i dimensions,
     glfw::window_mode mode,
     gl::version_and_profile profile)
+    : m_glfw_window{ nullptr }
+    , m_profile{ profile }
 {
     if (++s_glfw_use_count == 1) {
         init_glfw();
@@ -74,24 +116,7 @@ mope::glfw::window::imp::imp(
     auto monitor
         = mope::glfw::window_mode::fullscreen == mode ? ::glfwGetPrimaryMonitor() : nullptr;
 
-    ::glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, profile.major_version);
-    ::glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, profile.minor_version);
-
-    if (profile.major_version < 3
-        || (profile.major_version == 3 && profile.minor_version < 2))
-    {
-        ::glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_ANY_PROFILE);
-    }
-    else if (profile.profile == profile.core) {
-        ::glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    }
-    else if (profile.profile == profile.compat) {
-        ::glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_COMPAT_PROFILE);
-    }
-
-#if defined(DEBUG)
-    ::glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
-#endif // defined(DEBUG)
+    set_context_hints(profile);
 
     if (!(m_glfw_window
         = ::glfwCreateWindow(dimensions.x(), dimensions.y(), title, monitor, nullptr)))
@@ -214,6 +239,11 @@ auto mope::glfw::window::get_context() -> std::unique_ptr<gl::context>
     return std::make_unique<context>(*m_imp);
 }
 
+auto mope::glfw::window::make_shared_context() -> std::unique_ptr<gl::shared_context>
+{
+    return std::make_unique<shared_context>(*m_imp, m_imp->m_profile);
+}
+
 auto mope::glfw::window::get_gl_loader() -> void* (*)(char const*)
 {
     // We're putting the "fine" in "undefined behavior"
@@ -300,6 +330,28 @@ namespace
         ::glfwTerminate();
     }
 
+    void set_context_hints(mope::gl::version_and_profile profile)
+    {
+        ::glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, profile.major_version);
+        ::glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, profile.minor_version);
+
+        if (profile.major_version < 3
+            || (profile.major_version == 3 && profile.minor_version < 2))
+        {
+            ::glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_ANY_PROFILE);
+        }
+        else if (profile.profile == profile.core) {
+            ::glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        }
+        else if (profile.profile == profile.compat) {
+            ::glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_COMPAT_PROFILE);
+        }
+
+#if defined(DEBUG)
+        ::glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+#endif // defined(DEBUG)
+    }
+
     void throw_glfw_error(int code, const char* description)
     {
         std::string what = "Error code " + std::to_string(code) + ": " + description;
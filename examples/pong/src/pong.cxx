@@ -5,6 +5,8 @@
 #include "mope_game_engine/components/logger.hxx"
 #include "mope_game_engine/components/sprite.hxx"
 #include "mope_game_engine/components/transform.hxx"
+#include "mope_game_engine/component_manager.hxx"
+#include "mope_game_engine/events/event_traits.hxx"
 #include "mope_game_engine/events/tick.hxx"
 #include "mope_game_engine/font.hxx"
 #include "mope_game_engine/game_engine.hxx"
@@ -55,6 +57,7 @@ namespace
 
             auto engine = mope::game_engine_create();
             engine->set_tick_rate(60.0);
+            engine->set_flight_recorder("pong.flight");
             engine->add_scene(std::make_unique<pong>());
             engine->run(window, logger);
 
@@ -183,6 +186,43 @@ namespace
         mope::entity_id entity;
         int increment;
     };
+}
+
+// Scoring waits until the ball has finished moving for the tick, and then
+// happens at most once per competitor (and round reset) per tick.
+template <>
+struct mope::event_traits<all_collisions_resolved_event>
+{
+    static constexpr auto phase = event_phase::post_tick;
+    static constexpr auto coalescing = event_coalescing::dedupe;
+};
+
+template <>
+struct mope::event_traits<score_changed_event>
+{
+    static constexpr auto phase = event_phase::post_tick;
+    static constexpr auto coalescing = event_coalescing::merge;
+
+    static auto key(score_changed_event const& event) -> entity_id
+    {
+        return event.entity;
+    }
+
+    static void merge(score_changed_event& waiting, score_changed_event const& event)
+    {
+        waiting.increment += event.increment;
+    }
+};
+
+template <>
+struct mope::event_traits<reset_round_event>
+{
+    static constexpr auto phase = event_phase::post_tick;
+    static constexpr auto coalescing = event_coalescing::dedupe;
+};
+
+namespace
+{
 
     void exit_on_escape(mope::game_scene& scene, mope::tick_event const& event)
     {
@@ -338,18 +378,30 @@ namespace
         }
     };
 
-    void resolve_collisions(mope::game_scene& scene, collision_detected_event const& event)
+    class resolve_collisions : public mope::game_system<collision_detected_event>
     {
-        if (auto opt = scene
-            .query<ball_behavior, mope::transform_component>(event.ball_entity)
-            .exec())
+        // The ball is looked up several times every tick, so hold on to where
+        // its components are.
+        mope::component_ref<ball_behavior> m_ball;
+        mope::component_ref<mope::transform_component> m_ball_transform;
+
+        void operator()(mope::game_scene& scene, collision_detected_event const& event) override
         {
-            auto&& [ball, ball_transform] = *opt;
+            if (event.ball_entity != m_ball.entity()) {
+                m_ball = mope::component_ref<ball_behavior>{ event.ball_entity };
+                m_ball_transform = mope::component_ref<mope::transform_component>{ event.ball_entity };
+            }
+
+            auto ball = scene.get_component(m_ball);
+            auto ball_transform = scene.get_component(m_ball_transform);
+            if (nullptr == ball || nullptr == ball_transform) {
+                return;
+            }
 
             // Move the ball by the amount of time before the collision occurred.
-            ball_transform.slide(mope::vec3f{ event.collision.contact_time * ball.velocity });
+            ball_transform->slide(mope::vec3f{ event.collision.contact_time * ball->velocity });
 
-            auto new_velocity = mope::vec3d{ ball.velocity };
+            auto new_velocity = mope::vec3d{ ball->velocity };
 
             // Subtract twice the magnitude of the velocity projected along the
             // contact normal.
@@ -370,14 +422,14 @@ namespace
                 }
             }
 
-            ball.velocity = mope::vec3f{ new_velocity };
+            ball->velocity = mope::vec3f{ new_velocity };
 
             // Tell the collision detection system to look for more collisions
             // with our new velocity and remaining time.
             scene.emplace_event<collision_resolved_event>(
                 event.previous_remaining_time - event.collision.contact_time);
         }
-    }
+    };
 
     void end_round(mope::game_scene& scene, all_collisions_resolved_event const&)
     {
@@ -491,13 +543,13 @@ namespace
         );
         set_projection_matrix(projection);
 
-        add_game_system(exit_on_escape);
-        add_game_system(reset_round);
-        add_game_system(player_movement);
-        add_game_system(opponent_movement);
+        add_game_system("exit_on_escape", exit_on_escape);
+        add_game_system("reset_round", reset_round);
+        add_game_system("player_movement", player_movement);
+        add_game_system("opponent_movement", opponent_movement);
         emplace_game_system<ball_movement>();
-        add_game_system(resolve_collisions);
-        add_game_system(end_round);
+        emplace_game_system<resolve_collisions>();
+        add_game_system("end_round", end_round);
         emplace_game_system<set_score>(engine);
 
         auto player = create_entity();
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "mope_game_engine/components/component.hxx"
+#include "mope_game_engine/events/scene_reset.hxx"
+#include "mope_game_engine/events/tick.hxx"
+#include "mope_game_engine/game_system.hxx"
+#include "mope_vec/mope_vec.hxx"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace mope
+{
+    class game_scene;
+
+    /// Marks an entity's @ref transform_component as a solid box in the
+    /// @ref collision_world.
+    struct collider_component : public entity_component
+    {
+    };
+
+    /// Pushed by the @ref collision_world for each pair of colliders that
+    /// overlap during a tick, with `first < second`.
+    struct contact_event
+    {
+        entity_id first;
+        entity_id second;
+    };
+
+    struct collision_world_options
+    {
+        /// The width and height of a broadphase grid cell, in world units.
+        /// Somewhere around the size of a typical collider works best.
+        float cell_size = 64.0f;
+
+        /// How many ticks a collider has to stay where it is before it goes
+        /// to sleep.
+        std::uint32_t sleep_after_ticks = 30;
+    };
+
+    /// A game system that finds overlapping colliders every tick, and pushes a
+    /// @ref contact_event for each pair.
+    ///
+    /// Colliders are the boxes spanned by the x and y position and size of
+    /// entities that have both a @ref collider_component and a
+    /// @ref transform_component. Colliders are sorted into a grid, so only
+    /// colliders sharing a cell are tested against each other.
+    ///
+    /// A collider that hasn't moved or changed size for a while goes to
+    /// sleep: it stays where it is in the grid, and is only tested against
+    /// colliders that are awake. Pairs of sleeping colliders are never
+    /// tested. A sleeping collider wakes when its transform changes, when a
+    /// collider that is awake touches it, or when @ref wake() is called. So
+    /// walls and props cost next to nothing once they have settled.
+    class collision_world final : public game_system<tick_event, scene_reset_event>
+    {
+    public:
+        explicit collision_world(collision_world_options options = { });
+
+        void operator()(game_scene& scene, tick_event const&) override;
+        void operator()(game_scene& scene, scene_reset_event const&) override;
+
+        auto is_asleep(entity_id entity) const -> bool;
+        void wake(entity_id entity);
+
+    private:
+        struct bounds
+        {
+            vec2f min;
+            vec2f max;
+        };
+
+        struct body
+        {
+            entity_id entity;
+            bounds box;
+            vec2i min_cell;
+            vec2i max_cell;
+            std::uint32_t resting_ticks;
+            std::uint64_t last_seen;
+            bool asleep;
+        };
+
+        void update_bodies(game_scene& scene);
+        void find_contacts(game_scene& scene);
+
+        void insert_into_grid(std::size_t index);
+        void remove_from_grid(std::size_t index);
+        void remove_body(std::size_t index);
+
+        collision_world_options m_options;
+        std::uint64_t m_tick;
+        std::vector<body> m_bodies;
+        std::unordered_map<entity_id, std::size_t> m_index_map;
+        std::unordered_map<std::uint64_t, std::vector<std::size_t>> m_grid;
+        std::vector<std::size_t> m_woken;
+    };
+} // namespace mope
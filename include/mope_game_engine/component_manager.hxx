@@ -1,11 +1,17 @@
 #pragma once
 
 #include "mope_game_engine/components/component.hxx"
+#include "mope_game_engine/component_serializer.hxx"
 #include "mope_game_engine/iterable_box.hxx"
 
 #include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <memory_resource>
 #include <ranges>
+#include <span>
 #include <typeindex>
 #include <type_traits>
 #include <unordered_map>
@@ -33,6 +39,28 @@ namespace mope::detail
         ///
         /// @param entity The entity whose component to remove.
         virtual void remove(entity_id) = 0;
+
+        /// Take the component managed by this away from the given entity,
+        /// without destroying it, for a dormant entity.
+        ///
+        /// Components that are a @ref serializable_component are appended to
+        /// `out`, to be compressed. Others are moved to a side store, which
+        /// queries don't visit.
+        ///
+        /// @return Whether the entity had the component.
+        virtual auto make_dormant(entity_id entity, std::vector<std::byte>& out) -> bool = 0;
+
+        /// Give back a component taken by @ref make_dormant().
+        ///
+        /// @param bytes What @ref make_dormant() appended, if anything.
+        virtual void wake(entity_id entity, std::span<std::byte const> bytes) = 0;
+
+        /// How many components (or relationships) are stored.
+        virtual auto size() const -> std::size_t = 0;
+
+        /// Remove every component, including those of dormant entities, but
+        /// keep the memory that holds them, for @ref game_scene::reset().
+        virtual void clear() = 0;
     };
 
     template <component Component>
@@ -101,6 +129,11 @@ namespace mope::detail
     class component_storage<Component> final : public entity_component_storage_base
     {
     public:
+        explicit component_storage(std::pmr::memory_resource* memory)
+            : m_data{ memory }
+        {
+        }
+
         template <typename T>
             requires std::same_as<std::remove_cvref_t<T>, Component>
         void add_or_set(T&& t)
@@ -112,6 +145,7 @@ namespace mope::detail
             else {
                 m_data.push_back(std::forward<T>(t));
                 m_index_map.emplace(entity, m_data.size() - 1);
+                ++m_version;
             }
         }
 
@@ -138,6 +172,37 @@ namespace mope::detail
                 // Erase the index map entry for the component that we just
                 // removed.
                 m_index_map.erase(iter);
+                ++m_version;
+            }
+            m_dormant.erase(entity);
+        }
+
+        auto make_dormant(entity_id entity, std::vector<std::byte>& out) -> bool override
+        {
+            auto component = get(entity);
+            if (nullptr == component) {
+                return false;
+            }
+
+            if constexpr (serializable_component<Component>) {
+                component_serializer<Component>::save(*component, out);
+                remove(entity);
+            }
+            else {
+                auto dormant = std::move(*component);
+                remove(entity);
+                m_dormant.insert_or_assign(entity, std::move(dormant));
+            }
+            return true;
+        }
+
+        void wake(entity_id entity, std::span<std::byte const> bytes) override
+        {
+            if constexpr (serializable_component<Component>) {
+                add_or_set(component_serializer<Component>::load(entity, bytes));
+            }
+            else if (auto node = m_dormant.extract(entity)) {
+                add_or_set(std::move(node.mapped()));
             }
         }
 
@@ -151,14 +216,48 @@ namespace mope::detail
             }
         }
 
+        /// Same as @ref get(), but reuse `index` if nothing has been added or
+        /// removed since `version`; otherwise, look up the entity and update
+        /// both.
+        auto get(entity_id entity, std::size_t& index, std::uint64_t& version) -> Component*
+        {
+            if (version != m_version) {
+                auto iter = m_index_map.find(entity);
+                index = m_index_map.end() != iter ? iter->second : NoIndex;
+                version = m_version;
+            }
+            return NoIndex != index ? &m_data[index] : nullptr;
+        }
+
         auto all()
         {
             return std::ranges::ref_view{ m_data };
         }
 
+        auto size() const -> std::size_t override
+        {
+            return m_data.size();
+        }
+
+        void clear() override
+        {
+            m_data.clear();
+            m_index_map.clear();
+            m_dormant.clear();
+            ++m_version;
+        }
+
     private:
-        std::vector<Component> m_data;
+        static constexpr auto NoIndex = std::numeric_limits<std::size_t>::max();
+
+        std::pmr::vector<Component> m_data;
         std::unordered_map<entity_id, std::size_t> m_index_map;
+        std::unordered_map<entity_id, Component> m_dormant;
+
+        /// Changes whenever components are added or removed, which is when
+        /// they may move. Starts above zero, which a fresh
+        /// @ref component_ref has, so that it looks up the entity.
+        std::uint64_t m_version = 1;
     };
 
     template <derived_from_entity_component Relationship>
@@ -166,6 +265,11 @@ namespace mope::detail
     class component_storage<Relationship> final : public entity_component_storage_base
     {
     public:
+        explicit component_storage(std::pmr::memory_resource* memory)
+            : m_data{ memory }
+        {
+        }
+
         template <typename T>
             requires std::same_as<std::remove_cvref_t<T>, Relationship>
         void add_or_set(T&& t)
@@ -216,6 +320,33 @@ namespace mope::detail
                 // entity again.)
                 iter->second.clear();
             }
+            m_dormant.erase(entity);
+        }
+
+        // Relationships aren't serializable, so they always go to the side
+        // store.
+        auto make_dormant(entity_id entity, std::vector<std::byte>&) -> bool override
+        {
+            auto dormant = std::vector<Relationship>{};
+            for (auto&& relationship : get(entity)) {
+                dormant.push_back(std::move(relationship));
+            }
+            if (dormant.empty()) {
+                return false;
+            }
+
+            remove(entity);
+            m_dormant.insert_or_assign(entity, std::move(dormant));
+            return true;
+        }
+
+        void wake(entity_id entity, std::span<std::byte const>) override
+        {
+            if (auto node = m_dormant.extract(entity)) {
+                for (auto&& relationship : node.mapped()) {
+                    add_or_set(std::move(relationship));
+                }
+            }
         }
 
         auto get(entity_id entity)
@@ -236,18 +367,88 @@ namespace mope::detail
             return std::ranges::ref_view{ m_data };
         }
 
+        auto size() const -> std::size_t override
+        {
+            return m_data.size();
+        }
+
+        void clear() override
+        {
+            m_data.clear();
+
+            // As in remove(), keep the inner maps, since entity ids are handed
+            // out again from the start after a reset.
+            for (auto&& [entity, inner_map] : m_index_map) {
+                inner_map.clear();
+            }
+            m_dormant.clear();
+        }
+
     private:
-        std::vector<Relationship> m_data;
+        std::pmr::vector<Relationship> m_data;
         std::unordered_map<entity_id, std::unordered_map<entity_id, std::size_t>>
             m_index_map;
+        std::unordered_map<entity_id, std::vector<Relationship>> m_dormant;
     };
 }
 
 namespace mope
 {
+    class component_manager;
+
+    /// A handle to one entity's component of type `Component`, which finds it
+    /// faster than @ref component_manager::get_component() on repeat calls.
+    ///
+    /// The handle remembers where the component was in its storage. Until a
+    /// component of the same type is added to or removed from some entity,
+    /// which may move it, getting the component costs a comparison and an
+    /// array index instead of a hash lookup. Changing a component that an
+    /// entity already has doesn't move anything.
+    ///
+    /// Keep the handle around (e.g. as a member of a game system) and pass it
+    /// to @ref component_manager::get_component() each time.
+    template <derived_from_entity_component Component>
+        requires (!std::derived_from<Component, relationship>)
+    class component_ref
+    {
+    public:
+        component_ref() = default;
+
+        explicit component_ref(entity_id entity)
+            : m_entity{ entity }
+        {
+        }
+
+        auto entity() const -> entity_id
+        {
+            return m_entity;
+        }
+
+    private:
+        friend class component_manager;
+
+        entity_id m_entity = NoEntity;
+        component_manager const* m_owner = nullptr;
+        detail::component_storage<Component>* m_storage = nullptr;
+        std::size_t m_index = 0;
+        std::uint64_t m_version = 0;
+    };
+
     class component_manager
     {
     public:
+        /// @param component_memory Where to allocate the arrays that hold
+        ///     each type of entity component, e.g. a
+        ///     @ref huge_page_resource for scenes with many entities. It must
+        ///     outlive the component manager.
+        explicit component_manager(
+            std::pmr::memory_resource* component_memory = std::pmr::get_default_resource())
+            : m_component_memory{ component_memory }
+            , m_entity_component_stores{ }
+            , m_singleton_component_stores{ }
+        {
+        }
+
         template <
             typename ComponentRef,
             component Component = std::remove_cvref_t<ComponentRef>
@@ -285,6 +486,19 @@ namespace mope
             return ensure_storage<Component>().get(entity);
         }
 
+        /// Get the component that `ref` refers to, or nullptr if its entity
+        /// doesn't have one, q.v. @ref component_ref.
+        template <derived_from_entity_component Component>
+        auto get_component(component_ref<Component>& ref) -> Component*
+        {
+            if (this != ref.m_owner) {
+                ref.m_owner = this;
+                ref.m_storage = &ensure_storage<Component>();
+                ref.m_version = 0;
+            }
+            return ref.m_storage->get(ref.m_entity, ref.m_index, ref.m_version);
+        }
+
         template <component Component>
         auto get_components()
         {
@@ -304,22 +518,22 @@ namespace mope
         }
 
     private:
-        template <component Component, typename StorageMap>
-        auto ensure_storage(StorageMap& storage_map)
+        template <component Component, typename StorageMap, typename... Args>
+        auto ensure_storage(StorageMap& storage_map, Args... args)
             -> detail::component_storage<Component>&
         {
             auto type_idx = std::type_index{ typeid(Component) };
             auto iter = storage_map.find(type_idx);
             if (storage_map.end() == iter) {
                 iter = storage_map.insert(
-                    { type_idx, std::make_unique<detail::component_storage<Component>>() }
+                    { type_idx, std::make_unique<detail::component_storage<Component>>(args...) }
                 ).first;
             }
             // Other code may leave empty unique_ptrs in the map by using the
             // subscript operator, so we want to check for both missing AND
             // nullptr.
             else if (!iter->second) {
-                iter->second = std::make_unique<detail::component_storage<Component>>();
+                iter->second = std::make_unique<detail::component_storage<Component>>(args...);
             }
             return static_cast<detail::component_storage<Component>&>(*iter->second);
         }
@@ -333,10 +547,13 @@ namespace mope
         template <derived_from_entity_component Component>
         auto ensure_storage() -> detail::component_storage<Component>&
         {
-            return ensure_storage<Component>(m_entity_component_stores);
+            return ensure_storage<Component>(m_entity_component_stores, m_component_memory);
         }
 
     protected:
+        /// Where the arrays of entity components are allocated.
+        std::pmr::memory_resource* m_component_memory;
+
         std::unordered_map<std::type_index, std::unique_ptr<detail::entity_component_storage_base>>
             m_entity_component_stores;
         std::unordered_map<std::type_index, std::unique_ptr<detail::singleton_component_storage_base>>
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "mope_game_engine/components/component.hxx"
+#include "mope_game_engine/components/transform.hxx"
+#include "mope_vec/mope_vec.hxx"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace mope
+{
+    /// Turns a component into bytes and back, so that it can be written out of
+    /// a scene and read back into another entity later.
+    ///
+    /// The primary template copies the bytes of trivially copyable components.
+    /// Specialize it for any other component that should be streamed, with the
+    /// same two static members:
+    /// ```
+    ///     static void save(Component const&, std::vector<std::byte>& out);
+    ///     static auto load(entity_id, std::span<std::byte const>) -> Component;
+    /// ```
+    /// `save()` appends to `out`, and `load()` is given exactly the bytes that
+    /// `save()` appended. The saved bytes may be read by a later run of the
+    /// game, so they must not contain pointers or handles.
+    template <typename Component>
+    struct component_serializer;
+
+    template <typename Component>
+        requires std::is_trivially_copyable_v<Component>
+    struct component_serializer<Component>
+    {
+        static void save(Component const& component, std::vector<std::byte>& out)
+        {
+            auto bytes = std::as_bytes(std::span{ &component, 1 });
+            out.insert(out.end(), bytes.begin(), bytes.end());
+        }
+
+        static auto load(entity_id entity, std::span<std::byte const> bytes) -> Component
+        {
+            auto storage = std::array<std::byte, sizeof(Component)>{};
+            std::memcpy(storage.data(), bytes.data(), std::min(bytes.size(), storage.size()));
+            auto component = std::bit_cast<Component>(storage);
+            component.entity = entity;
+            return component;
+        }
+    };
+
+    /// Only the position and size are saved; the model matrix is rebuilt from
+    /// them, and interpolation starts over.
+    template <>
+    struct component_serializer<transform_component>
+    {
+        static void save(transform_component const& transform, std::vector<std::byte>& out)
+        {
+            auto values = std::array<float, 6>{
+                transform.x_position(), transform.y_position(), transform.z_position(),
+                transform.x_size(), transform.y_size(), transform.z_size(),
+            };
+            auto bytes = std::as_bytes(std::span{ values });
+            out.insert(out.end(), bytes.begin(), bytes.end());
+        }
+
+        static auto load(entity_id entity, std::span<std::byte const> bytes) -> transform_component
+        {
+            auto values = std::array<float, 6>{};
+            std::memcpy(values.data(), bytes.data(), std::min(bytes.size(), sizeof(values)));
+            return transform_component{
+                entity,
+                vec3f{ values[0], values[1], values[2] },
+                vec3f{ values[3], values[4], values[5] }
+            };
+        }
+    };
+
+    /// An entity component that can be written out of a scene, q.v.
+    /// @ref component_serializer.
+    ///
+    /// Relationships are excluded, because the entity on the other end may not
+    /// exist (or may have a different id) when the component is read back.
+    template <typename Component>
+    concept serializable_component =
+        derived_from_entity_component<Component>
+        && !std::derived_from<Component, relationship>
+        && requires (Component const& component, std::vector<std::byte>& out, std::span<std::byte const> bytes)
+        {
+            component_serializer<Component>::save(component, out);
+            { component_serializer<Component>::load(entity_id{ }, bytes) } -> std::same_as<Component>;
+        };
+} // namespace mope
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "mope_game_engine/components/component.hxx"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mope
+{
+    /// Where the numbers in @ref perf_counts come from.
+    enum class perf_counter_source
+    {
+        /// Counting is off, or the platform has no counters we can read.
+        none,
+
+        /// CPU counters, plus the software counters. Linux only.
+        hardware,
+
+        /// Only the task clock and page faults, which the kernel counts
+        /// itself. Used where the CPU counters aren't available, as is
+        /// often the case in containers and virtual machines.
+        software,
+    };
+
+    /// Counts taken around some piece of work, on the thread that did it.
+    /// Counters that aren't available stay zero.
+    struct perf_counts
+    {
+        std::uint64_t cycles;
+        std::uint64_t instructions;
+        std::uint64_t cache_misses;
+        std::uint64_t branch_misses;
+
+        /// Data loads that missed the TLB, which huge pages make rarer, q.v.
+        /// @ref huge_page_resource.
+        std::uint64_t dtlb_misses;
+        std::uint64_t task_clock_ns;
+        std::uint64_t page_faults;
+
+        auto operator+=(perf_counts const& that) -> perf_counts&
+        {
+            cycles += that.cycles;
+            instructions += that.instructions;
+            cache_misses += that.cache_misses;
+            branch_misses += that.branch_misses;
+            dtlb_misses += that.dtlb_misses;
+            task_clock_ns += that.task_clock_ns;
+            page_faults += that.page_faults;
+            return *this;
+        }
+
+        friend auto operator-(perf_counts const& a, perf_counts const& b) -> perf_counts
+        {
+            return perf_counts{
+                a.cycles - b.cycles,
+                a.instructions - b.instructions,
+                a.cache_misses - b.cache_misses,
+                a.branch_misses - b.branch_misses,
+                a.dtlb_misses - b.dtlb_misses,
+                a.task_clock_ns - b.task_clock_ns,
+                a.page_faults - b.page_faults,
+            };
+        }
+    };
+
+    /// What was sent to the GPU to draw sprites.
+    struct sprite_stats
+    {
+        std::uint64_t sprites;
+        std::uint64_t draws;
+
+        /// The size of the per-sprite data, which is packed into 20 bytes a
+        /// sprite rather than sent as a 64-byte model matrix.
+        std::uint64_t instance_bytes;
+    };
+
+    /// The totals for one system's handler of one event type, in one scene.
+    struct system_stats
+    {
+        /// The name of the event type, as given by `typeid`.
+        std::string event;
+
+        /// The name of the system's type, as given by `typeid`. For systems
+        /// added as functions or lambdas, this is the type of the callable.
+        std::string system;
+
+        std::uint64_t invocations;
+        perf_counts counts;
+    };
+
+    /// What the engine has measured since counting was turned on with
+    /// @ref I_game_engine::set_perf_counters(). Every scene has this as a
+    /// singleton component, so a system can show it in game.
+    struct engine_stats : public singleton_component
+    {
+        perf_counter_source source;
+
+        /// One entry per system and event type, added the first time the
+        /// system handles the event while counting.
+        std::vector<system_stats> systems;
+
+        /// How many frames were rendered, and the counts for rendering
+        /// every scene during them.
+        std::uint64_t frames;
+        perf_counts render;
+        sprite_stats sprites;
+    };
+}
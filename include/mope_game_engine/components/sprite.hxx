@@ -2,7 +2,10 @@
 
 #include "mope_game_engine/components/component.hxx"
 #include "mope_game_engine/texture.hxx"
+#include "mope_game_engine/texture_array.hxx"
+#include "mope_vec/mope_vec.hxx"
 
+#include <cstdint>
 #include <utility>
 
 namespace mope
@@ -12,8 +15,42 @@ namespace mope
         sprite_component(entity_id entity, gl::texture texture)
             : entity_component{ entity }
             , texture{ std::move(texture) }
+            , uv_offset{ 0.0f, 0.0f }
+            , uv_size{ 1.0f, 1.0f }
+            , page{ 0 }
+        { }
+
+        /// Draw only part of @p texture, e.g. one image out of an atlas.
+        ///
+        /// @param uv_offset The corner of the part, in texture coordinates.
+        /// @param uv_size Its size, in texture coordinates.
+        /// @param page Which layer of the texture the part is on, if it was
+        ///     made with @ref gl::texture::make_array.
+        sprite_component(
+            entity_id entity,
+            gl::texture texture,
+            vec2f uv_offset,
+            vec2f uv_size,
+            std::uint8_t page = 0)
+            : entity_component{ entity }
+            , texture{ std::move(texture) }
+            , uv_offset{ std::move(uv_offset) }
+            , uv_size{ std::move(uv_size) }
+            , page{ page }
+        { }
+
+        /// Draw one layer of a texture array, as returned by
+        /// @ref gl::texture_array::allocate.
+        sprite_component(entity_id entity, gl::texture_array const& array, std::uint8_t layer)
+            : sprite_component{ entity, array.texture(), { 0.0f, 0.0f }, { 1.0f, 1.0f }, layer }
         { }
 
         gl::texture texture;
+
+        /// Texture coordinates are in [0, 1], and are sent to the GPU at
+        /// 16 bits each.
+        vec2f uv_offset;
+        vec2f uv_size;
+        std::uint8_t page;
     };
 } // namespace mope
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "mope_game_engine/components/component.hxx"
+#include "mope_vec/mope_vec.hxx"
+
+namespace mope
+{
+    /// The point in the world that matters most, usually the camera or the
+    /// player. Systems that scale their work by distance, such as the
+    /// @ref world_partition and the @ref simulation_lod_system, measure from
+    /// here. Keep it up to date from a game system.
+    struct world_focus : public singleton_component
+    {
+        vec2f position;
+    };
+} // namespace mope
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+
+namespace mope
+{
+    /// The stages of a tick, in the order in which their events are handled.
+    ///
+    /// Each phase has its own queue. A phase runs until its queue is empty,
+    /// including events pushed while it runs, before the next phase starts.
+    /// If an event is pushed to a phase that already ran, the phases run again
+    /// from the earliest one with events, until every queue is empty. Every
+    /// phase runs within @ref game_scene::tick.
+    enum class event_phase
+    {
+        /// Before the @ref tick_event, for events pushed between ticks, e.g.
+        /// from @ref game_scene::on_load. Those pushed during a tick are
+        /// handled in the same tick, once the phase running when they were
+        /// pushed is done, i.e. after the tick_event.
+        pre_tick,
+        simulate,   ///< The @ref tick_event, and most events. The default.
+        post_tick,  ///< After the simulation has settled, e.g. scoring.
+
+        /// Last in the tick, and so before the next frame is drawn; frames
+        /// drawn between ticks don't run it again.
+        pre_render,
+    };
+
+    constexpr auto EventPhaseCount = std::size_t{ 4 };
+
+    /// What to do when an event is pushed while an event of the same type and
+    /// key (q.v. @ref event_traits) is still waiting in its queue.
+    enum class event_coalescing
+    {
+        none,       ///< Queue both. The default.
+        keep_last,  ///< Replace the waiting event with the new one.
+        merge,      ///< Fold the new event into the waiting one.
+        dedupe,     ///< Drop the new event.
+    };
+
+    /// Specialize this to change how events of type `Event` are queued. Every
+    /// member is optional:
+    /// ```
+    ///     template <>
+    ///     struct mope::event_traits<score_changed_event>
+    ///     {
+    ///         static constexpr auto phase = event_phase::post_tick;
+    ///         static constexpr auto coalescing = event_coalescing::merge;
+    ///
+    ///         // Events coalesce only with events of the same key. Without
+    ///         // this, all events of the type share a key.
+    ///         static auto key(score_changed_event const& e) { return e.entity; }
+    ///
+    ///         // Required for event_coalescing::merge.
+    ///         static void merge(score_changed_event& waiting, score_changed_event const& e)
+    ///         {
+    ///             waiting.increment += e.increment;
+    ///         }
+    ///     };
+    /// ```
+    template <typename Event>
+    struct event_traits
+    {
+    };
+} // namespace mope
+
+namespace mope::detail
+{
+    template <typename Event>
+    consteval auto phase_of() -> event_phase
+    {
+        if constexpr (requires { { event_traits<Event>::phase } -> std::convertible_to<event_phase>; }) {
+            return event_traits<Event>::phase;
+        }
+        else {
+            return event_phase::simulate;
+        }
+    }
+
+    template <typename Event>
+    consteval auto coalescing_of() -> event_coalescing
+    {
+        if constexpr (requires { { event_traits<Event>::coalescing } -> std::convertible_to<event_coalescing>; }) {
+            return event_traits<Event>::coalescing;
+        }
+        else {
+            return event_coalescing::none;
+        }
+    }
+
+    template <typename Event>
+    auto same_key(Event const& a, Event const& b) -> bool
+    {
+        if constexpr (requires { event_traits<Event>::key(a); }) {
+            return event_traits<Event>::key(a) == event_traits<Event>::key(b);
+        }
+        else {
+            return true;
+        }
+    }
+} // namespace mope::detail
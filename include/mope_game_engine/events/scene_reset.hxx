@@ -0,0 +1,15 @@
+#pragma once
+
+namespace mope
+{
+    /// Handed to the systems of a scene by @ref game_scene::reset(), once the
+    /// scene has been emptied.
+    ///
+    /// Systems that keep state about entities (caches, spatial indices and
+    /// so on) should forget it here, but hold on to their memory, since the
+    /// scene is about to be filled again. Unlike other events, this isn't
+    /// queued: the systems get it before reset() returns.
+    struct scene_reset_event
+    {
+    };
+}
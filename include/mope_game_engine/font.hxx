@@ -3,8 +3,14 @@
 #include "mope_game_engine/texture.hxx"
 #include "mope_vec/mope_vec.hxx"
 
+#include <memory>
 #include <utility>
 
+namespace mope::detail
+{
+    struct font_face;
+}
+
 namespace mope
 {
     struct glyph final
@@ -15,26 +21,31 @@ namespace mope
         gl::texture texture;
     };
 
+    /// A font face, as made by @ref I_game_engine::make_font.
+    ///
+    /// Copies of a font share the same face, including its pixel size and its
+    /// cache of glyphs.
     struct font final
     {
         font();
-        font(void* imp);
-        font(font const&);
-        font(font&&) noexcept;
-        ~font() noexcept;
-
-        auto operator=(font) noexcept -> font&;
+        explicit font(std::shared_ptr<detail::font_face> face);
 
         void set_px(unsigned int px_size);
+
+        /// Return the glyph for @p character_code at the current pixel size.
+        ///
+        /// Glyphs are only rasterized the first time they are asked for, so
+        /// the texture of the returned glyph is shared with every other call
+        /// for the same character and size.
         auto make_glyph(unsigned long character_code) const -> glyph;
 
         friend void swap(font& a, font& b) noexcept
         {
             using std::swap;
-            swap(a.m_imp, b.m_imp);
+            swap(a.m_face, b.m_face);
         }
 
     private:
-        void* m_imp;
+        std::shared_ptr<detail::font_face> m_face;
     };
 }
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "mope_game_engine/texture.hxx"
+#include "mope_vec/mope_vec.hxx"
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace mope
+{
+    namespace gl
+    {
+        class framebuffer;
+    }
+
+    /// Names a render target in a @ref frame_graph, for one frame.
+    struct render_target_handle
+    {
+        std::uint32_t index;
+    };
+
+    /// What a transient render target is made of.
+    struct render_target_desc
+    {
+        /// In pixels; zero means the size of the window.
+        vec2i size = vec2i{ 0, 0 };
+        gl::pixel_format format = gl::pixel_format::rgba;
+
+        /// Whether to give the target a depth buffer.
+        bool depth = false;
+    };
+
+    /// What the last @ref frame_graph::compile came to.
+    struct frame_graph_stats
+    {
+        std::size_t passes;
+
+        /// Passes left out because nothing that reaches the window uses what
+        /// they draw.
+        std::size_t culled_passes;
+
+        /// Transient targets that some pass that runs uses.
+        std::size_t transient_targets;
+
+        /// Framebuffers those targets share, since targets of the same
+        /// description whose uses don't overlap are given the same one.
+        std::size_t framebuffers;
+    };
+
+    /// The passes that draw a frame, and the render targets they draw to and
+    /// sample from.
+    ///
+    /// Each frame, passes are added with the targets they read and write,
+    /// then the graph is compiled: passes whose output never reaches the
+    /// window are culled, the rest are ordered so that every target is
+    /// written before it is read, and transient targets are assigned
+    /// framebuffers, with targets whose lifetimes don't overlap sharing one.
+    /// Framebuffers are kept from frame to frame, as long as they are used.
+    ///
+    /// Compiling needs no graphics context, so the plan can be checked on
+    /// its own, q.v. @ref order and @ref framebuffer_of.
+    class frame_graph
+    {
+    public:
+        /// Declares what one pass reads and writes, while it is added.
+        class pass_builder
+        {
+        public:
+            /// Add a transient render target, which lives for this frame.
+            /// Its pixels start out undefined, so the first pass to write it
+            /// should clear it.
+            auto create(render_target_desc const& desc) -> render_target_handle;
+
+            /// Sample @p target in this pass, which makes it depend on every
+            /// pass that writes @p target. The window can't be read.
+            void read(render_target_handle target);
+
+            /// Draw to @p target in this pass. Each pass writes at most one
+            /// target, and not one it reads. Passes that write the same
+            /// target run in the order they were added.
+            void write(render_target_handle target);
+
+            /// Run this pass even though nothing reads what it draws.
+            void keep();
+
+        private:
+            friend class frame_graph;
+
+            pass_builder(frame_graph& graph, std::size_t pass);
+
+            frame_graph& m_graph;
+            std::size_t m_pass;
+        };
+
+        /// What a pass is given when it runs. Its target is already bound,
+        /// with the viewport covering it.
+        class pass_context
+        {
+        public:
+            /// The color texture of @p target, which this pass reads.
+            auto texture(render_target_handle target) const -> gl::texture const&;
+
+            /// The size of the target this pass writes.
+            auto size() const -> vec2i;
+
+        private:
+            friend class frame_graph;
+
+            pass_context(frame_graph const& graph, std::size_t pass, vec2i size);
+
+            frame_graph const& m_graph;
+            std::size_t m_pass;
+            vec2i m_size;
+        };
+
+        using execute_function = std::function<void(pass_context const&)>;
+
+        frame_graph();
+        ~frame_graph();
+
+        frame_graph(frame_graph const&) = delete;
+        auto operator=(frame_graph const&) -> frame_graph& = delete;
+
+        /// The window's framebuffer. Passes that write it are never culled.
+        auto backbuffer() const -> render_target_handle;
+
+        /// Add a pass, calling @p setup with a @ref pass_builder to declare
+        /// its targets. @p execute is called when the pass runs, if it isn't
+        /// culled. @p name must outlive the frame, e.g. a string literal.
+        template <std::invocable<pass_builder&> Setup>
+        void add_pass(char const* name, Setup&& setup, execute_function execute)
+        {
+            auto builder = begin_pass(name, std::move(execute));
+            std::forward<Setup>(setup)(builder);
+        }
+
+        /// Cull, order and assign framebuffers to the passes added since the
+        /// last @ref reset.
+        ///
+        /// Throws @ref game_engine_error if the passes depend on each other
+        /// in a cycle.
+        void compile();
+
+        /// Run the compiled passes, making any framebuffers that are needed.
+        void execute(vec2i window_size);
+
+        /// Forget this frame's passes and targets, to add the next frame's.
+        /// Framebuffers and memory are kept.
+        void reset();
+
+        /// @ref reset, and drop the framebuffers kept for later frames,
+        /// e.g. before the graphics context goes away.
+        void release();
+
+        /// After @ref compile, the names of the passes that run, in order.
+        auto order() const -> std::vector<char const*>;
+
+        /// After @ref compile, which of the frame's framebuffers @p target
+        /// was given, or -1 if nothing that runs uses it (or it's the
+        /// window).
+        auto framebuffer_of(render_target_handle target) const -> int;
+
+        auto stats() const -> frame_graph_stats;
+
+    private:
+        /// The window has no description; @ref backbuffer is always target 0.
+        static constexpr auto NoTarget = ~std::uint32_t{ 0 };
+
+        struct pass
+        {
+            char const* name;
+            execute_function execute;
+            std::vector<std::uint32_t> reads;
+            std::uint32_t write;
+            bool keep;
+            bool culled;
+        };
+
+        struct target
+        {
+            render_target_desc desc;
+            int framebuffer;
+        };
+
+        struct pooled_framebuffer
+        {
+            vec2i size;
+            gl::pixel_format format;
+            bool depth;
+            std::unique_ptr<gl::framebuffer> framebuffer;
+        };
+
+        auto begin_pass(char const* name, execute_function execute) -> pass_builder;
+        auto depends_on(std::size_t pass, std::size_t other) const -> bool;
+        void cull();
+        void sort();
+        void assign_framebuffers();
+
+        std::vector<pass> m_passes;
+        std::vector<target> m_targets;
+
+        /// Indices into @ref m_passes of the passes that run, in order.
+        std::vector<std::size_t> m_order;
+
+        /// The description of each of this frame's framebuffers.
+        std::vector<render_target_desc> m_framebuffer_descs;
+
+        /// Framebuffers made in earlier frames, which are reused when a
+        /// frame needs one of the same size and format.
+        std::vector<pooled_framebuffer> m_pool;
+
+        /// Which of @ref m_pool each of this frame's framebuffers is.
+        std::vector<std::size_t> m_framebuffers;
+
+        frame_graph_stats m_stats;
+    };
+} // namespace mope
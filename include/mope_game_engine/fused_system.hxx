@@ -0,0 +1,166 @@
+#pragma once
+
+#include "mope_game_engine/components/component.hxx"
+#include "mope_game_engine/game_scene.hxx"
+#include "mope_game_engine/game_system.hxx"
+#include "mope_game_engine/query.hxx"
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace mope
+{
+    template <typename... Components>
+    struct fused_query
+    {
+    };
+
+    template <typename Event, typename SharedQuery, typename... Bodies>
+    class fused_system;
+
+    /// A game system that runs several per-entity bodies over the same query
+    /// in as few passes as possible.
+    ///
+    /// Registering, say, two movement systems that both walk every
+    /// `transform_component` costs two passes over the transforms. Fusing
+    /// them calls both bodies for each entity in a single pass, so each
+    /// entity's components are loaded once.
+    ///
+    /// Each body has one of the signatures
+    /// ```
+    ///     void (Event const&, Shared&..., Extra&...)
+    ///     void (game_scene&, Event const&, Shared&..., Extra&...)
+    /// ```
+    /// where `Shared...` are the components of the common query (each of
+    /// which may be taken as const), and `Extra...` are any other components
+    /// the body needs from the same entity. A body is skipped for entities
+    /// that lack any of its `Extra...` components, so `Extra...` can be used
+    /// as tags.
+    ///
+    /// Bodies that don't take the scene can only touch their own entity, so
+    /// calling them one entity at a time is the same as calling them one
+    /// system at a time, and consecutive ones are always fused. Bodies that
+    /// take the scene may look at other entities, which could see a different
+    /// state when fused; so that nothing changes, each of them gets a pass of
+    /// its own. Bodies are called in the order they were given.
+    template <typename Event, derived_from_entity_component... Shared, typename... Bodies>
+    class fused_system<Event, fused_query<Shared...>, Bodies...> final : public game_system<Event>
+    {
+    public:
+        explicit fused_system(Bodies... bodies)
+            : m_bodies{ std::move(bodies)... }
+        {
+        }
+
+        void operator()(game_scene& scene, Event const& event) override
+        {
+            run_passes(scene, event, std::make_index_sequence<PassCount>{});
+        }
+
+    private:
+        template <typename Body>
+        using parameters = detail::parameters_of<std::decay_t<Body>>;
+
+        template <typename Body>
+        static constexpr auto takes_scene = std::same_as<
+            std::remove_cvref_t<typename parameters<Body>::template type<0>>,
+            game_scene
+        >;
+
+        /// Where the components start in the parameters of `Body`.
+        template <typename Body>
+        static constexpr auto component_offset = takes_scene<Body> ? 2uz : 1uz;
+
+        template <typename Body>
+        static constexpr auto extra_count =
+            parameters<Body>::count - component_offset<Body> - sizeof...(Shared);
+
+        template <typename Body, std::size_t I>
+        using extra_component = std::remove_cvref_t<
+            typename parameters<Body>::template type<component_offset<Body> + sizeof...(Shared) + I>
+        >;
+
+        /// Which pass each body runs in.
+        static constexpr auto Passes = []()
+            {
+                auto confined = std::array<bool, sizeof...(Bodies)>{ !takes_scene<Bodies>... };
+                auto passes = std::array<std::size_t, sizeof...(Bodies)>{};
+                for (auto i = 1uz; i < passes.size(); ++i) {
+                    passes[i] = passes[i - 1] + (confined[i] && confined[i - 1] ? 0 : 1);
+                }
+                return passes;
+            }();
+
+        static constexpr auto PassCount = 0 == sizeof...(Bodies) ? 0uz : Passes.back() + 1;
+
+        template <std::size_t... Pass>
+        void run_passes(game_scene& scene, Event const& event, std::index_sequence<Pass...>)
+        {
+            (run_pass<Pass>(scene, event), ...);
+        }
+
+        template <std::size_t Pass>
+        void run_pass(game_scene& scene, Event const& event)
+        {
+            for (auto&& components : scene.query<Shared...>().exec()) {
+                auto shared = detail::tuplify<std::remove_cvref_t<decltype(components)>>{}(components);
+                run_bodies<Pass>(scene, event, shared, std::index_sequence_for<Bodies...>{});
+            }
+        }
+
+        template <std::size_t Pass, typename SharedTuple, std::size_t... I>
+        void run_bodies(game_scene& scene, Event const& event, SharedTuple& shared, std::index_sequence<I...>)
+        {
+            ([&]()
+                {
+                    if constexpr (Pass == Passes[I]) {
+                        using Body = std::tuple_element_t<I, std::tuple<Bodies...>>;
+                        run_body(std::get<I>(m_bodies), scene, event, shared, std::make_index_sequence<extra_count<Body>>{});
+                    }
+                }(), ...);
+        }
+
+        template <typename Body, typename SharedTuple, std::size_t... I>
+        void run_body(Body& body, game_scene& scene, Event const& event, SharedTuple& shared, std::index_sequence<I...>)
+        {
+            static_assert(
+                parameters<Body>::count >= component_offset<Body> + sizeof...(Shared),
+                "A fused body must take every component of the shared query."
+            );
+
+            [[maybe_unused]] auto entity = std::get<0>(shared).entity;
+            [[maybe_unused]] auto extras = std::make_tuple(scene.get_component<extra_component<Body, I>>(entity)...);
+            if (((nullptr == std::get<I>(extras)) || ...)) {
+                return;
+            }
+
+            std::apply([&](auto&... components)
+                {
+                    if constexpr (takes_scene<Body>) {
+                        std::invoke(body, scene, event, components..., *std::get<I>(extras)...);
+                    }
+                    else {
+                        std::invoke(body, event, components..., *std::get<I>(extras)...);
+                    }
+                }, shared);
+        }
+
+        std::tuple<Bodies...> m_bodies;
+    };
+
+    /// Make a @ref fused_system that runs `bodies` over the entities that
+    /// have all of `Shared...`, for use with @ref game_scene::add_game_system.
+    template <typename Event, derived_from_entity_component... Shared, typename... Bodies>
+    auto make_fused_system(Bodies&&... bodies)
+    {
+        return std::make_unique<fused_system<Event, fused_query<Shared...>, std::decay_t<Bodies>...>>(
+            std::forward<Bodies>(bodies)...
+        );
+    }
+} // namespace mope
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "mope_game_engine/image.hxx"
 #include "mope_game_engine/texture.hxx"
 
+#include <cstddef>
 #include <memory>
 #include <vector>
 
@@ -37,7 +39,84 @@ namespace mope
         // The game engine does NOT take ownership of the logger pointer. You
         // are resposible for freeing it after run() has returned.
         virtual void run(I_game_window& window, I_logger* = nullptr) = 0;
+
+        /// Load a font face from a TTF (or other FreeType-supported) file.
+        ///
+        /// Fonts made while the scenes load, e.g. in @ref game_scene::on_load,
+        /// are read and made on the job system alongside the rest of startup,
+        /// and are waited for when their first glyph is made, or before the
+        /// first frame at the latest. A font that fails to load throws
+        /// @ref game_engine_error then, rather than from here.
         virtual auto make_font(char const* ttf_path, int face_index, int instance_index = 0) -> font = 0;
+
+        /// Load a PNG or QOI image as a texture.
+        ///
+        /// This returns immediately; the image is decoded in the background
+        /// and uploaded during a later frame. Loading the same path again
+        /// returns the same image, with the options it was first loaded
+        /// with. q.v. @ref image
+        virtual auto load_image(char const* path, image_options const& options = image_options{})
+            -> std::shared_ptr<image const> = 0;
+
+        /// Mount a packed asset archive, as written by `mope_asset_packer`.
+        ///
+        /// Once mounted, @ref make_font and @ref load_image look up their
+        /// paths in the archive before falling back to the filesystem. Archives
+        /// are mapped into memory rather than read, and fonts and uncompressed
+        /// textures are used straight out of the mapping.
+        virtual void mount_archive(char const* path) = 0;
+
+        /// Draw sprites with a shader built from the given GLSL files, instead
+        /// of the built-in one. Like @ref load_image, this needs the graphics
+        /// context, so call it from @ref game_scene::on_load or later.
+        ///
+        /// The shader must declare the same inputs and uniforms as the
+        /// built-in one: the uniforms `u_view`, `u_projection`, `u_origin`,
+        /// `u_texture_2d`, `u_texture_array` and `u_layered` (whether to
+        /// sample the array); the quad's corner `i_pos` (location 0) and
+        /// texture coordinates `i_tex_coord` (1); and, per sprite, its
+        /// position relative to `u_origin` in sixteenths `i_offset` (2), its
+        /// size `i_size` (3), its part of the texture `i_uv_rect` (4) and its
+        /// page `i_page` (5, a `uint`). Throws @ref game_engine_error if it
+        /// doesn't compile.
+        virtual void load_sprite_shader(char const* vert_path, char const* frag_path) = 0;
+
+        /// Watch the files behind loaded assets, and reload them in place when
+        /// they change on disk.
+        ///
+        /// Only what changed is rebuilt: an edited shader is relinked, an
+        /// edited font has its cached glyphs re-rasterized, and an edited image
+        /// has only the region that differs re-uploaded. Handles that scenes
+        /// already hold see the changes without being reloaded. Assets from
+        /// archives are never reloaded.
+        ///
+        /// While this is on, decoded image pixels are kept in memory so that
+        /// they can be compared. Meant for development builds.
+        virtual void set_hot_reload(bool enabled) = 0;
+
+        /// Count CPU cycles, instructions, cache misses and branch misses
+        /// (or, where the CPU's counters aren't available, just time and
+        /// page faults) around every system that handles an event, and
+        /// around rendering. Turning this on starts the counts afresh.
+        ///
+        /// The totals are kept in the @ref engine_stats singleton component
+        /// of every scene, and logged when @ref run() returns. Only the thread
+        /// that turns this on is counted, so call it from the thread that
+        /// calls @ref run(). Counting costs a couple of system calls per
+        /// system, so this is meant for profiling builds. Linux only;
+        /// elsewhere, nothing is counted.
+        virtual void set_perf_counters(bool enabled) = 0;
+
+        /// Keep a record of the last `ticks` ticks of every scene: the
+        /// inputs, how many events of each type were handled and how long
+        /// their systems took, and how many entities and components there
+        /// were. If the game crashes on a signal, or @ref run() ends with an
+        /// exception, the record is written to `path`, to be read with the
+        /// `mope_flight_decoder` tool. Pass a null path to stop recording.
+        ///
+        /// Recording takes a fixed amount of memory and a couple of clock
+        /// reads per event, so it can be left on in release builds.
+        virtual void set_flight_recorder(char const* path, std::size_t ticks = 600) = 0;
         virtual auto get_default_texture() const -> gl::texture const& = 0;
     };
 } // namespace mope
@@ -2,14 +2,25 @@
 
 #include "mope_game_engine/components/component.hxx"
 #include "mope_game_engine/component_manager.hxx"
+#include "mope_game_engine/events/event_traits.hxx"
+#include "mope_game_engine/events/scene_reset.hxx"
+#include "mope_game_engine/events/tick.hxx"
 #include "mope_game_engine/game_system.hxx"
 #include "mope_game_engine/query.hxx"
 #include "mope_vec/mope_vec.hxx"
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <memory_resource>
+#include <string>
 #include <typeindex>
+#include <typeinfo>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
@@ -18,8 +29,12 @@
 namespace mope
 {
     class I_game_engine;
+    class flight_recorder;
+    class frame_graph;
+    class perf_counters;
     class sprite_renderer;
-    struct input_state;
+    struct engine_stats;
+    struct render_target_handle;
     struct I_logger;
 }
 
@@ -60,8 +75,24 @@ namespace mope
         /// save before closing.
         virtual bool on_close() { return true; }
 
+        /// Called every frame to add the passes that draw this scene to the
+        /// frame's @ref frame_graph, to end up in `target`.
+        ///
+        /// By default, one pass draws the scene's sprites straight to
+        /// `target`. Override this to draw them somewhere else first, e.g. to
+        /// light or post-process them, by calling @ref render from a pass of
+        /// your own.
+        virtual void on_render_passes(frame_graph& graph, render_target_handle target, double alpha);
+
     public:
         game_scene();
+
+        /// @param component_memory Where to allocate the scene's components
+        ///     and events, e.g. a @ref huge_page_resource, which helps scenes
+        ///     that query many thousands of components each tick. It must
+        ///     outlive the scene.
+        explicit game_scene(std::pmr::memory_resource* component_memory);
+
         virtual ~game_scene() = 0;
 
         game_scene(game_scene const&) = delete;
@@ -75,6 +106,36 @@ namespace mope
         auto create_entity() -> entity_id;
         void destroy_entity(entity_id entity);
 
+        /// Move all of an entity's components out of the scene, so that
+        /// queries no longer visit it, until @ref wake() is called.
+        ///
+        /// Components that are a @ref serializable_component are kept
+        /// LZ4-compressed; others are kept as they are, out of the way of
+        /// queries. Use this for entities that are far from anything that
+        /// could affect them. Destroying a dormant entity discards its
+        /// components as usual.
+        void make_dormant(entity_id entity);
+
+        /// Give a dormant entity its components back. Does nothing if the
+        /// entity isn't dormant.
+        void wake(entity_id entity);
+
+        auto is_dormant(entity_id entity) const -> bool;
+
+        /// Empty the scene, to be filled again, e.g. to restart a level.
+        ///
+        /// Every entity and entity component is removed, events that are
+        /// waiting are dropped, and entity ids start again from the first.
+        /// Then the systems get a @ref scene_reset_event, so that they can
+        /// forget what they knew about the old entities. Systems and
+        /// singleton components stay as they are.
+        ///
+        /// Unlike making a new scene, this keeps the memory of the component
+        /// stores, their indices and the event queues, so refilling the scene
+        /// costs little more than writing the new components. If called from
+        /// a system, the other systems still get the event being handled.
+        void reset();
+
         /// Same as `get_component<I_logger>()`.
         auto logger() -> I_logger*;
 
@@ -84,9 +145,13 @@ namespace mope
         /// Used by the @ref game_engine to tell the scene when it is time to render.
         void render(double alpha);
 
-        /// Used by the @ref game_engine. Calls on_load() and initializes
-        /// members that need a graphics context.
-        void load(I_game_engine& engine);
+        /// Used by the @ref game_engine. Calls on_render_passes().
+        void add_render_passes(frame_graph& graph, render_target_handle target, double alpha);
+
+        /// Used by the @ref game_engine. Calls on_load() after taking the
+        /// renderer, which the engine makes so that every scene draws with the
+        /// same (reloadable) shader.
+        void load(I_game_engine& engine, std::unique_ptr<sprite_renderer> renderer);
 
         /// Used by the @ref game_engine. Calls on_unload().
         void unload(I_game_engine& engine);
@@ -94,6 +159,19 @@ namespace mope
         /// Used by the @ref game_engine. Calls on_close().
         bool close();
 
+        /// Used by the @ref game_engine. Take counts around every system
+        /// that handles an event, and add them to `stats`; or stop, if
+        /// `counters` is null.
+        void set_perf_counters(perf_counters* counters, engine_stats* stats);
+
+        /// Used by the @ref game_engine. Record every tick in `recorder`, as
+        /// the scene numbered `scene`; or stop, if `recorder` is null.
+        void set_flight_recorder(flight_recorder* recorder, std::uint32_t scene);
+
+        /// Used by the @ref game_engine. The number the scene was last given
+        /// by @ref set_flight_recorder.
+        auto flight_recorder_scene() const -> std::uint32_t;
+
         /// Add a game system that is invoked when certain events occur.
         ///
         /// `f` shall be a callable function or object with the signature:
@@ -102,14 +180,31 @@ namespace mope
         /// ```
         /// where `R` and `Event` are any type. `f` will be invoked for every
         /// event of type `Event` that occurs.
+        ///
+        /// The system is named in @ref engine_stats after the type of `f`.
+        /// Every free function of the same signature has the same type, so
+        /// free functions are also named after their address; add them with
+        /// a name, below, for something more readable.
         template <proxyable_game_system F>
         void add_game_system(F&& f)
         {
-            // Determine the type of event to which this system responds.
-            using Event = std::remove_cvref_t<
-                typename detail::parameters_of<std::decay_t<F>>::template type<1>
-            >;
-            add_game_system_imp(new game_system_proxy<Event, std::decay_t<F>>{ std::forward<F>(f) });
+            if constexpr (std::is_pointer_v<std::decay_t<F>>) {
+                auto function = std::decay_t<F>{ f };
+                auto name = name_function(typeid(function), std::bit_cast<std::uintptr_t>(function));
+                add_game_system_handler(function, name);
+            }
+            else {
+                add_game_system_handler(std::forward<F>(f), nullptr);
+            }
+        }
+
+        /// Like the above, but naming the system `name` in
+        /// @ref engine_stats, which must outlive the scene, e.g. a string
+        /// literal.
+        template <proxyable_game_system F>
+        void add_game_system(char const* name, F&& f)
+        {
+            add_game_system_handler(std::forward<F>(f), name);
         }
 
         /// Add an instance of a game system derived from @ref game_system<T...>.
@@ -130,7 +225,8 @@ namespace mope
             // isn't possible here, as we as we don't know the event types yet.
             // And it is vitally important that `System` does in fact derive
             // from @ref virtual_event_handler for each event.
-            add_game_system_imp(system.release());
+            auto shared = std::shared_ptr<System>{ std::move(system) };
+            add_game_system_imp(shared, shared.get());
         }
 
         /// Like the `std::unique_ptr` overload of `add_game_system()`, but we
@@ -138,10 +234,12 @@ namespace mope
         template <typename System, typename... Args>
         void emplace_game_system(Args&&... args)
         {
-            add_game_system_imp(new System(std::forward<Args>(args)...));
+            auto system = std::make_shared<System>(std::forward<Args>(args)...);
+            add_game_system_imp(system, system.get());
         }
 
-        /// Place an event in the event queue for this frame.
+        /// Place an event in the event queue for this frame. Same as
+        /// @ref emplace_event.
         template <typename Event>
         void push_event(Event&& event)
         {
@@ -149,12 +247,33 @@ namespace mope
         }
 
         /// Construct an event (in place) in the event queue for this frame.
+        ///
+        /// The event goes to the queue of its phase, and may be coalesced
+        /// with an event already waiting there, q.v. @ref event_traits.
         template <typename Event, typename... Args>
         void emplace_event(Args&&... args)
         {
-            auto ptr = m_event_pool.allocate(sizeof(Event), alignof(Event));
-            auto event = new (ptr) Event(std::forward<Args>(args)...);
-            m_events.emplace_back(static_cast<void*>(event), process_event<Event>);
+            constexpr auto coalescing = detail::coalescing_of<Event>();
+            if constexpr (event_coalescing::none == coalescing) {
+                enqueue_event<Event>(std::forward<Args>(args)...);
+            }
+            else {
+                auto event = Event(std::forward<Args>(args)...);
+                auto waiting = find_waiting_event(event);
+                if (nullptr == waiting) {
+                    auto queued = enqueue_event<Event>(std::move(event));
+                    m_coalescing_events.emplace(typeid(Event), queued);
+                }
+                else if constexpr (event_coalescing::keep_last == coalescing) {
+                    // Events needn't be assignable (tick_event isn't).
+                    std::destroy_at(waiting);
+                    std::construct_at(waiting, std::move(event));
+                }
+                else if constexpr (event_coalescing::merge == coalescing) {
+                    event_traits<Event>::merge(*waiting, event);
+                }
+                // Otherwise, dedupe: the waiting event stands for this one.
+            }
         }
 
         /// Return a view over groups of components in this scene.
@@ -178,46 +297,162 @@ namespace mope
             return ::mope::query_entity<Queryables...>{ *this, entity };
         }
 
+    protected:
+        /// Deliver the tick to the systems. By default it goes through the
+        /// event queue like any other event; @ref static_scene overrides this
+        /// to call its systems directly.
+        virtual void dispatch_tick(tick_event const& event);
+
+        /// Deliver the @ref scene_reset_event to the systems, from
+        /// @ref reset(). @ref static_scene overrides this to empty its own
+        /// queues and tell its own systems.
+        virtual void dispatch_reset(scene_reset_event const& event);
+
     private:
-        template <typename... Events>
-        void add_game_system_imp(game_system<Events...>* system)
+        /// A name for a system added as the function at @p address, of type
+        /// @p type, which lives as long as the scene.
+        auto name_function(std::type_info const& type, std::uintptr_t address) -> char const*;
+
+        template <typename F>
+        void add_game_system_handler(F&& f, char const* name)
         {
-            auto shared = std::shared_ptr<game_system<Events...>>{ system };
+            // Determine the type of event to which this system responds.
+            using Event = std::remove_cvref_t<
+                typename detail::parameters_of<std::decay_t<F>>::template type<1>
+            >;
+            m_game_systems[typeid(Event)].push_back(
+                detail::event_handler::make<Event>(std::forward<F>(f), name)
+            );
+        }
 
-            (m_game_systems[typeid(Events)].emplace_back(
-                // This is the ***aliasing constructor*** of std::shared_ptr<T>.
-                // The `shared_ptr`s will dereference to the bases, which are
-                // `virtual_event_handler<Event>`s, but will share ownership and
-                // lifetime of the derived class, `game_system<Events...>`.
-                shared, static_cast<virtual_event_handler<Events>*>(system)
+        template <typename System, typename... Events>
+        void add_game_system_imp(std::shared_ptr<System> const& system, game_system<Events...>*)
+        {
+            // Every event's handler holds a share of the system, which fits in
+            // the handler's inline storage.
+            (m_game_systems[typeid(Events)].push_back(
+                detail::event_handler::make<Events>(
+                    [system](game_scene& scene, Events const& event)
+                    {
+                        std::invoke(static_cast<virtual_event_handler<Events>&>(*system), scene, event);
+                    },
+                    typeid(System).name())
             ), ...);
         }
 
+        template <typename Event, typename... Args>
+        auto enqueue_event(Args&&... args) -> Event*
+        {
+            auto ptr = m_event_pool.allocate(sizeof(Event), alignof(Event));
+            auto event = new (ptr) Event(std::forward<Args>(args)...);
+            m_events[static_cast<std::size_t>(detail::phase_of<Event>())]
+                .push_back({ static_cast<void*>(event), process_event<Event>, release_event<Event> });
+            return event;
+        }
+
+        template <typename Event>
+        auto find_waiting_event(Event const& event) -> Event*
+        {
+            auto [first, last] = m_coalescing_events.equal_range(typeid(Event));
+            for (auto iter = first; iter != last; ++iter) {
+                auto waiting = static_cast<Event*>(iter->second);
+                if (detail::same_key(*waiting, event)) {
+                    return waiting;
+                }
+            }
+            return nullptr;
+        }
+
         template <typename Event>
         static void process_event(game_scene& scene, void* ptr)
         {
             auto event = static_cast<Event*>(ptr);
 
-            for (auto&& system_base_ptr : scene.m_game_systems[typeid(Event)]) {
-                auto system = static_cast<virtual_event_handler<Event>*>(system_base_ptr.get());
-                std::invoke(*system, scene, *event);
+            // Once handling starts, the event is no longer waiting, and new
+            // events of its type queue up behind it.
+            if constexpr (event_coalescing::none != detail::coalescing_of<Event>()) {
+                auto [first, last] = scene.m_coalescing_events.equal_range(typeid(Event));
+                scene.m_coalescing_events.erase(std::find_if(first, last, [ptr](auto&& entry)
+                    {
+                        return ptr == entry.second;
+                    }));
+            }
+
+            auto& handlers = scene.m_game_systems[typeid(Event)];
+            if (nullptr != scene.m_perf_counters || nullptr != scene.m_flight_recorder) {
+                scene.process_event_instrumented(typeid(Event), handlers, event);
+            }
+            else {
+                for (auto&& handler : handlers) {
+                    handler(scene, event);
+                }
             }
 
+            release_event<Event>(scene, ptr);
+        }
+
+        template <typename Event>
+        static void release_event(game_scene& scene, void* ptr)
+        {
             if constexpr (!std::is_trivially_destructible_v<Event>) {
-                event->~Event();
+                static_cast<Event*>(ptr)->~Event();
             }
 
             scene.m_event_pool.deallocate(ptr, sizeof(Event), alignof(Event));
         }
 
+        void process_event_instrumented(
+            std::type_info const& event_type,
+            std::vector<detail::event_handler>& handlers,
+            void const* event);
+        void count_handlers(
+            std::type_info const& event_type,
+            std::vector<detail::event_handler>& handlers,
+            void const* event);
+
+        struct queued_event
+        {
+            /// Null once the event has been taken from the queue.
+            void* event;
+            void (*process)(game_scene&, void*);
+
+            /// Destroys the event without handling it.
+            void (*release)(game_scene&, void*);
+        };
+
+        struct dormant_entity
+        {
+            /// The stores that had a component, and how many bytes of the
+            /// uncompressed blob each one wrote.
+            std::vector<std::pair<detail::entity_component_storage_base*, std::size_t>> components;
+            std::size_t size;
+            bool compressed;
+            std::vector<std::byte> bytes;
+        };
+
         entity_id m_last_entity;
-        std::unordered_map<std::type_index, std::vector<std::shared_ptr<void>>>
+        std::unordered_map<std::type_index, std::vector<detail::event_handler>>
             m_game_systems;
         std::pmr::unsynchronized_pool_resource
             m_event_pool;
-        std::vector<std::pair<void*, void(*)(game_scene&, void*)>>
+        std::array<std::vector<queued_event>, EventPhaseCount>
             m_events;
+        /// Events waiting in the queues that may be coalesced with new ones.
+        std::unordered_multimap<std::type_index, void*>
+            m_coalescing_events;
         std::unique_ptr<sprite_renderer> m_sprite_renderer;
+        std::unordered_map<entity_id, dormant_entity> m_dormant_entities;
+        perf_counters* m_perf_counters;
+        engine_stats* m_engine_stats;
+        /// For each event type, where each of its handlers' totals are in
+        /// @ref engine_stats::systems.
+        std::unordered_map<std::type_index, std::vector<std::size_t>>
+            m_system_stats;
+        flight_recorder* m_flight_recorder;
+        std::uint32_t m_recorder_scene;
+        /// The names made by @ref name_function; a deque, so that they stay
+        /// put.
+        std::deque<std::string> m_function_names;
         bool m_done;
     };
 }
@@ -1,9 +1,13 @@
 #pragma once
 
 #include <concepts>
+#include <cstddef>
+#include <cstring>
 #include <functional>
+#include <new>
 #include <tuple>
 #include <type_traits>
+#include <typeinfo>
 #include <utility>
 
 namespace mope::detail
@@ -22,6 +26,8 @@ namespace mope::detail
     template <typename... Ts>
     struct indexable_types
     {
+        static constexpr auto count = sizeof...(Ts);
+
         template <size_t N>
         using type = std::tuple_element_t<N, std::tuple<Ts...>>;
     };
@@ -108,3 +114,140 @@ namespace mope
         requires detail::is_const_value_reference_v<typename detail::parameters_of<std::decay_t<F>>::template type<1>>;
     };
 }
+
+namespace mope::detail
+{
+    /// A handler for one type of event, as stored by the @ref game_scene.
+    ///
+    /// This is a function pointer plus the state of the callable it invokes.
+    /// Callables that are small enough (free functions, most lambdas, and the
+    /// `shared_ptr` of a @ref game_system) are stored inline, so handlers can
+    /// sit in a contiguous array, and calling one is a single indirect call
+    /// into a function that knows the callable's type. Larger callables are
+    /// moved to the heap.
+    class event_handler
+    {
+    public:
+        static constexpr auto InlineSize = 3 * sizeof(void*);
+
+        /// @param name The name of the system, for @ref engine_stats. By
+        ///     default, the name of the callable's type.
+        template <typename Event, typename F>
+        static auto make(F&& f, char const* name = nullptr) -> event_handler
+        {
+            using Callable = std::decay_t<F>;
+
+            auto handler = event_handler{};
+            handler.m_name = nullptr != name ? name : typeid(Callable).name();
+            if constexpr (fits_inline<Callable>) {
+                new (handler.m_storage) Callable(std::forward<F>(f));
+                handler.m_invoke = [](void* storage, game_scene& scene, void const* event)
+                    {
+                        std::invoke(*std::launder(static_cast<Callable*>(storage)), scene, *static_cast<Event const*>(event));
+                    };
+                if constexpr (!std::is_trivially_copyable_v<Callable>) {
+                    handler.m_relocate = [](void* from, void* to)
+                        {
+                            auto source = std::launder(static_cast<Callable*>(from));
+                            if (nullptr != to) {
+                                new (to) Callable(std::move(*source));
+                            }
+                            source->~Callable();
+                        };
+                }
+            }
+            else {
+                new (handler.m_storage) Callable*(new Callable(std::forward<F>(f)));
+                handler.m_invoke = [](void* storage, game_scene& scene, void const* event)
+                    {
+                        std::invoke(**static_cast<Callable**>(storage), scene, *static_cast<Event const*>(event));
+                    };
+                handler.m_relocate = [](void* from, void* to)
+                    {
+                        auto source = static_cast<Callable**>(from);
+                        if (nullptr != to) {
+                            new (to) Callable*(*source);
+                        }
+                        else {
+                            delete *source;
+                        }
+                    };
+            }
+            return handler;
+        }
+
+        event_handler(event_handler&& that) noexcept
+            : m_invoke{ std::exchange(that.m_invoke, nullptr) }
+            , m_relocate{ std::exchange(that.m_relocate, nullptr) }
+            , m_name{ that.m_name }
+        {
+            move_storage(that);
+        }
+
+        auto operator=(event_handler&& that) noexcept -> event_handler&
+        {
+            if (this != &that) {
+                destroy();
+                m_invoke = std::exchange(that.m_invoke, nullptr);
+                m_relocate = std::exchange(that.m_relocate, nullptr);
+                m_name = that.m_name;
+                move_storage(that);
+            }
+            return *this;
+        }
+
+        ~event_handler()
+        {
+            destroy();
+        }
+
+        void operator()(game_scene& scene, void const* event)
+        {
+            m_invoke(m_storage, scene, event);
+        }
+
+        auto name() const -> char const*
+        {
+            return m_name;
+        }
+
+    private:
+        template <typename Callable>
+        static constexpr auto fits_inline =
+            sizeof(Callable) <= InlineSize
+            && alignof(Callable) <= alignof(std::max_align_t)
+            && std::is_nothrow_move_constructible_v<Callable>;
+
+        event_handler() = default;
+
+        void move_storage(event_handler& that)
+        {
+            if (nullptr != m_relocate) {
+                m_relocate(that.m_storage, m_storage);
+            }
+            else {
+                std::memcpy(m_storage, that.m_storage, InlineSize);
+            }
+        }
+
+        void destroy()
+        {
+            if (nullptr != m_relocate) {
+                m_relocate(m_storage, nullptr);
+            }
+            m_invoke = nullptr;
+            m_relocate = nullptr;
+        }
+
+        void (*m_invoke)(void*, game_scene&, void const*) = nullptr;
+
+        /// Moves the callable from the first storage to the second and
+        /// destroys the original, or just destroys it if the second is null.
+        /// Null for callables that can be copied with `memcpy`.
+        void (*m_relocate)(void*, void*) = nullptr;
+
+        char const* m_name = nullptr;
+
+        alignas(std::max_align_t) std::byte m_storage[InlineSize];
+    };
+}
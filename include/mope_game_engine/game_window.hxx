@@ -25,6 +25,21 @@ namespace mope::gl
     {
         virtual ~context() = default;
     };
+
+    /// A second OpenGL context that shares objects (textures, buffers, etc.)
+    /// with the window's context, so that resources can be created on another
+    /// thread.
+    ///
+    /// The shared context is created and destroyed on the thread that runs the
+    /// game engine, but is made current on a different one.
+    struct shared_context
+    {
+        virtual ~shared_context() = default;
+
+        /// Make this context current on the calling thread, for as long as the
+        /// returned object exists.
+        virtual auto make_current() -> std::unique_ptr<context> = 0;
+    };
 }
 
 namespace mope
@@ -39,6 +54,18 @@ namespace mope
         /// @sa mope::gl::context
         virtual auto get_context() -> std::unique_ptr<gl::context> = 0;
 
+        /// Return a context that shares objects with the one returned by
+        /// @ref get_context(), or nullptr if the window can't make one.
+        ///
+        /// If one is returned, the @ref I_game_engine uploads textures on a
+        /// separate thread using it, rather than on the render thread.
+        ///
+        /// @sa mope::gl::shared_context
+        virtual auto make_shared_context() -> std::unique_ptr<gl::shared_context>
+        {
+            return nullptr;
+        }
+
         /// Return a function that will be used to load GL procedures.
         ///
         /// e.g. `glfwGetProcAddress`
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <unordered_map>
+
+namespace mope
+{
+    struct huge_page_stats
+    {
+        /// Live allocations that have pages of their own, and how many bytes
+        /// are mapped for them (rounded up to whole huge pages).
+        std::size_t mapped_allocations;
+        std::size_t mapped_bytes;
+
+        /// How many of the mapped bytes the kernel has actually backed with
+        /// huge pages. It may fall back to small pages if memory is too
+        /// fragmented, or if transparent huge pages are turned off. Only
+        /// filled in by @ref huge_page_resource::stats(true), on Linux.
+        std::size_t huge_page_bytes;
+
+        /// Live allocations, and their bytes, that were too small to be worth
+        /// huge pages and went to the upstream resource instead.
+        std::size_t small_allocations;
+        std::size_t small_bytes;
+    };
+
+    /// A memory resource that backs large allocations with 2 MiB transparent
+    /// huge pages, for component stores with many components.
+    ///
+    /// A query walks the components of each type in a contiguous array. With
+    /// 4 KiB pages, a large array spans so many pages that the TLB can't map
+    /// them all, and a walk over it keeps missing the TLB. With huge pages,
+    /// one TLB entry covers 512 times as much.
+    ///
+    /// Each allocation of at least `threshold` bytes is mapped on its own,
+    /// aligned to and rounded up to whole huge pages, and the kernel is asked
+    /// to back it with huge pages (`madvise(MADV_HUGEPAGE)`), which works
+    /// when transparent huge pages are set to `always` or `madvise`. Smaller
+    /// allocations, which would waste most of a huge page, go to `upstream`.
+    /// Off Linux, everything goes to `upstream`.
+    ///
+    /// Pass one to a @ref game_scene constructor. Like any memory resource,
+    /// it must outlive everything allocated from it. It is thread-safe.
+    class huge_page_resource final : public std::pmr::memory_resource
+    {
+    public:
+        static constexpr auto HugePageSize = std::size_t{ 2 } << 20;
+
+        explicit huge_page_resource(
+            std::size_t threshold = HugePageSize / 2,
+            std::pmr::memory_resource* upstream = std::pmr::get_default_resource()
+        );
+        ~huge_page_resource();
+
+        huge_page_resource(huge_page_resource const&) = delete;
+        auto operator=(huge_page_resource const&) -> huge_page_resource& = delete;
+
+        /// @param count_huge_pages Also ask the kernel how much of the mapped
+        ///     memory it backed with huge pages. This reads
+        ///     `/proc/self/smaps`, so it is slow.
+        auto stats(bool count_huge_pages = false) const -> huge_page_stats;
+
+    private:
+        auto do_allocate(std::size_t bytes, std::size_t alignment) -> void* override;
+        void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+        auto do_is_equal(std::pmr::memory_resource const& that) const noexcept -> bool override;
+
+        std::size_t m_threshold;
+        std::pmr::memory_resource* m_upstream;
+
+        mutable std::mutex m_mutex;
+
+        /// The size of each mapping, by address.
+        std::unordered_map<void*, std::size_t> m_mappings;
+        std::size_t m_mapped_bytes;
+        std::size_t m_small_allocations;
+        std::size_t m_small_bytes;
+    };
+} // namespace mope
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "mope_game_engine/texture.hxx"
+#include "mope_vec/mope_vec.hxx"
+
+namespace mope
+{
+    /// How the texture of an image is sampled.
+    struct image_options
+    {
+        /// The image's smaller mip levels are only built if this filter
+        /// samples them, which the default doesn't; pick a mipmapped filter
+        /// for images that are drawn much smaller than they are.
+        gl::texture_min_filter min_filter = gl::texture_min_filter::linear;
+        gl::texture_mag_filter mag_filter = gl::texture_mag_filter::linear;
+    };
+
+    /// An image loaded by the @ref I_game_engine.
+    ///
+    /// Images are decoded in the background. Until that finishes, `texture` is
+    /// a transparent one-pixel placeholder, `size` is zero and `ready` is
+    /// false. The decoded pixels are uploaded into the very same texture, so
+    /// copies of `texture` that were taken in the meantime (e.g. by a
+    /// @ref sprite_component) pick up the image without any further action.
+    struct image final
+    {
+        gl::texture texture;
+        vec2i size;
+        bool ready;
+
+        /// What the image was first loaded with.
+        image_options options;
+    };
+} // namespace mope
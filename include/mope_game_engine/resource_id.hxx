@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <utility>
 
 namespace mope::gl
@@ -7,7 +8,9 @@ namespace mope::gl
     ////////////////////////////////////////////////////////////////////////////
     /// @class resource_id
     /// @brief A handle to an OpenGL resource that must be cleaned up.
-    /// @details @todo
+    /// @details Copies share the resource, which is released when the last
+    /// copy is destroyed. Copies may be made and destroyed on different
+    /// threads, e.g. when resources are created on a shared context.
     ////////////////////////////////////////////////////////////////////////////
     class resource_id final
     {
@@ -35,6 +38,6 @@ namespace mope::gl
     private:
         unsigned int m_id;
         void (*m_release)(unsigned int);
-        long* m_use_count;
+        std::atomic<long>* m_use_count;
     };
 } // namespace mope::gl
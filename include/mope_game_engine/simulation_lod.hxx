@@ -0,0 +1,136 @@
+#pragma once
+
+#include "mope_game_engine/components/component.hxx"
+#include "mope_game_engine/events/tick.hxx"
+#include "mope_game_engine/game_system.hxx"
+
+#include <cstdint>
+
+namespace mope
+{
+    class game_scene;
+
+    enum class simulation_lod
+    {
+        full,       ///< Simulated every tick.
+        reduced,    ///< Simulated every @ref simulation_lod_component::ReducedInterval ticks.
+        frozen,     ///< Not simulated.
+    };
+
+    /// The counter that decides which reduced-rate entities are due this
+    /// tick. Advanced by the @ref simulation_lod_system.
+    struct simulation_clock : public singleton_component
+    {
+        std::uint64_t tick;
+    };
+
+    /// How often an entity should be simulated, kept up to date by the
+    /// @ref simulation_lod_system from the entity's distance to the
+    /// @ref world_focus.
+    ///
+    /// Systems that can afford to skip distant entities query for this
+    /// component along with their own, and pass over entities that aren't
+    /// @ref is_due(). Entities without it are always simulated.
+    struct simulation_lod_component : public entity_component
+    {
+        static constexpr auto ReducedInterval = 4u;
+
+        simulation_lod lod = simulation_lod::full;
+
+        /// Which of the @ref ReducedInterval ticks a reduced entity is
+        /// simulated on. Spread out by the @ref simulation_lod_system so that
+        /// each tick simulates about the same number of them.
+        std::uint32_t phase = 0;
+
+        auto is_due(simulation_clock const& clock) const -> bool
+        {
+            switch (lod) {
+            case simulation_lod::full: return true;
+            case simulation_lod::reduced: return clock.tick % ReducedInterval == phase;
+            default: return false;
+            }
+        }
+
+        /// The tick from which the entity has had its current LOD and
+        /// phase, and the last tick it was simulated before then. Kept up to
+        /// date by the @ref simulation_lod_system.
+        std::uint64_t since_tick = 0;
+        std::uint64_t last_tick_before = 0;
+
+        /// The time that has passed since this entity was last simulated,
+        /// given the time step of a single tick. This covers the ticks it
+        /// spent at another LOD or phase, or frozen, so call it on the ticks
+        /// that the entity is due.
+        auto time_step(simulation_clock const& clock, double tick_time_step) const -> double
+        {
+            auto last = last_simulated_before(clock.tick);
+            if (last >= clock.tick) {
+                // Never simulated before; e.g., it's the first tick.
+                return tick_time_step;
+            }
+            return tick_time_step * static_cast<double>(clock.tick - last);
+        }
+
+        /// The last tick before @p tick on which this entity was due, going
+        /// by its earlier LODs and phases too; or @p tick, or a later one, if
+        /// there was none.
+        auto last_simulated_before(std::uint64_t tick) const -> std::uint64_t
+        {
+            auto last = tick;
+            if (0 != tick) {
+                switch (lod) {
+                case simulation_lod::full:
+                    last = tick - 1;
+                    break;
+                case simulation_lod::reduced:
+                    if (auto back = (tick - 1 + ReducedInterval - phase % ReducedInterval) % ReducedInterval;
+                        back < tick)
+                    {
+                        last = tick - 1 - back;
+                    }
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            // Before its current LOD and phase, the entity went by others.
+            return last < since_tick || last >= tick ? last_tick_before : last;
+        }
+    };
+
+    struct simulation_lod_options
+    {
+        /// Entities closer than this to the focus are simulated every tick.
+        float full_distance = 1024.0f;
+
+        /// Entities closer than this (but not within `full_distance`) are
+        /// simulated at a reduced rate. Those beyond are frozen.
+        float reduced_distance = 4096.0f;
+
+        /// How many ticks pass between updates of each entity's LOD.
+        std::uint32_t update_interval = 8;
+    };
+
+    /// A game system that advances the @ref simulation_clock every tick, and
+    /// every few ticks assigns each entity with a @ref simulation_lod_component
+    /// and a @ref transform_component its LOD by distance from the
+    /// @ref world_focus. Entities are left at their last LOD while there is
+    /// no focus.
+    ///
+    /// Add this before any system that reads the LOD, so that they see this
+    /// tick's clock.
+    class simulation_lod_system final : public game_system<tick_event>
+    {
+    public:
+        explicit simulation_lod_system(simulation_lod_options options = { });
+
+        void operator()(game_scene& scene, tick_event const&) override;
+
+    private:
+        void update_lods(game_scene& scene);
+
+        simulation_lod_options m_options;
+        std::uint64_t m_tick;
+    };
+} // namespace mope
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "mope_game_engine/events/scene_reset.hxx"
+#include "mope_game_engine/events/tick.hxx"
+#include "mope_game_engine/game_scene.hxx"
+
+#include <concepts>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mope
+{
+    /// The event types that a @ref static_scene queues.
+    template <typename... Events>
+    struct event_list
+    {
+    };
+
+    template <typename EventList, typename... Systems>
+    class static_scene;
+
+    /// A @ref game_scene whose systems are fixed at compile time.
+    ///
+    /// `game_scene` keeps its systems behind type-erased pointers, and looks
+    /// up the handlers of each event in a map. A static_scene instead owns a
+    /// `Systems...` object of each type, and keeps a queue of each event type
+    /// in `Events...`. Each event is handed directly to every system that can
+    /// be called with it, in the order the systems are listed, so the calls
+    /// can be inlined.
+    ///
+    /// A system is any object callable as
+    /// ```
+    ///     system(scene, event)
+    /// ```
+    /// for some of the events, where `scene` is this static_scene. Systems
+    /// derived from @ref game_system work too; mark them `final` so that the
+    /// calls needn't be virtual. Systems should push events through the
+    /// static_scene (e.g. take the scene as `auto&`), since events pushed
+    /// through a `game_scene&` go to the type-erased queue instead.
+    ///
+    /// The tick is handed to the systems first. Then the queues are drained
+    /// in the order of `Events...`, over and over until all are empty, so
+    /// events of one type are handled in the order they were pushed, but not
+    /// interleaved with other types as in `game_scene`.
+    ///
+    /// Systems may still be added at run time with @ref add_game_system. They
+    /// receive the tick and events pushed through the `game_scene`, as usual.
+    template <typename... Events, typename... Systems>
+    class static_scene<event_list<Events...>, Systems...> : public game_scene
+    {
+    public:
+        static_scene() = default;
+
+        explicit static_scene(Systems... systems)
+            : m_systems{ std::move(systems)... }
+            , m_queues{ }
+        {
+        }
+
+        template <typename System>
+        auto system() -> System&
+        {
+            return std::get<System>(m_systems);
+        }
+
+        /// Place an event in this scene's queue for its type.
+        template <typename Event>
+        void push_event(Event&& event)
+        {
+            queue<std::remove_cvref_t<Event>>().push_back(std::forward<Event>(event));
+        }
+
+        /// Construct an event (in place) in this scene's queue for its type.
+        template <typename Event, typename... Args>
+        void emplace_event(Args&&... args)
+        {
+            queue<Event>().emplace_back(std::forward<Args>(args)...);
+        }
+
+    private:
+        void dispatch_tick(tick_event const& event) override
+        {
+            dispatch(event);
+
+            auto pending = true;
+            while (pending) {
+                pending = false;
+                (drain<Events>(pending), ...);
+            }
+
+            // Systems added at run time get the tick the usual way.
+            game_scene::dispatch_tick(event);
+        }
+
+        void dispatch_reset(scene_reset_event const& event) override
+        {
+            // Clearing keeps the queues' memory. If this is called while a
+            // queue is drained, the drain sees the queue empty and stops.
+            std::apply([](auto&... queues) { (queues.clear(), ...); }, m_queues);
+
+            dispatch(event);
+            game_scene::dispatch_reset(event);
+        }
+
+        template <typename Event>
+        auto queue() -> std::vector<Event>&
+        {
+            static_assert(
+                (std::same_as<Event, Events> || ...),
+                "The event type must be in the static_scene's event_list."
+            );
+            return std::get<std::vector<Event>>(m_queues);
+        }
+
+        template <typename Event>
+        void dispatch(Event const& event)
+        {
+            std::apply([this, &event](auto&... systems)
+                {
+                    (invoke_if_handled(systems, event), ...);
+                }, m_systems);
+        }
+
+        template <typename System, typename Event>
+        void invoke_if_handled(System& system, Event const& event)
+        {
+            if constexpr (std::invocable<System&, static_scene&, Event const&>) {
+                std::invoke(system, *this, event);
+            }
+        }
+
+        template <typename Event>
+        void drain(bool& pending)
+        {
+            auto& events = std::get<std::vector<Event>>(m_queues);
+            for (auto i = 0uz; i < events.size(); ++i) {
+                // Handling an event may push another of the same type, which
+                // may reallocate the queue. So, as in game_scene::tick(), we
+                // take a copy rather than a reference.
+                auto event = Event{ std::move(events[i]) };
+                dispatch(event);
+                pending = true;
+            }
+            events.clear();
+        }
+
+        std::tuple<Systems...> m_systems;
+        std::tuple<std::vector<Events>...> m_queues;
+    };
+} // namespace mope
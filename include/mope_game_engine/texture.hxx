@@ -4,6 +4,7 @@
 #include "mope_vec/mope_vec.hxx"
 
 #include <array>
+#include <cstddef>
 
 namespace mope::gl
 {
@@ -15,8 +16,24 @@ namespace mope::gl
         bgr,
         rgba,
         bgra,
+
+        // Compressed formats, in blocks of 4x4 pixels, as written by
+        // `mope_asset_packer --encode`. They can't be updated in part, or
+        // have mipmaps generated; give them their levels instead.
+
+        bc1,    ///< RGB with 1-bit alpha, 8 bytes a block.
+        bc3,    ///< RGBA, 16 bytes a block.
+        bc4,    ///< Red only (RGTC1), 8 bytes a block, e.g. for glyphs.
+        bc5,    ///< Red and green (RGTC2), 16 bytes a block.
+        bc7,    ///< RGBA at higher quality than BC3, 16 bytes a block.
     };
 
+    auto is_compressed(pixel_format format) -> bool;
+
+    /// The number of bytes in an image of the given format and size, with
+    /// each row padded to @p row_alignment (which compressed formats ignore).
+    auto image_size(pixel_format format, vec2i size, int row_alignment = 1) -> std::size_t;
+
     enum class color_component
     {
         red,
@@ -37,6 +54,9 @@ namespace mope::gl
         linear_mipmap_linear,
     };
 
+    /// Whether sampling with @p min_filter reads mip levels below the first.
+    auto is_mipmapped(texture_min_filter min_filter) -> bool;
+
     enum class texture_mag_filter
     {
         nearest,
@@ -46,10 +66,20 @@ namespace mope::gl
     struct texture_extra_options
     {
         int row_alignment = 4;
-        texture_min_filter min_filter = texture_min_filter::nearest_mipmap_linear;
+
+        /// Mip levels are only generated for a filter that samples them, so
+        /// the default doesn't.
+        texture_min_filter min_filter = texture_min_filter::linear;
         texture_mag_filter mag_filter = texture_mag_filter::linear;
+
+        /// How many mip levels the pixels hold, each half the size of the
+        /// last (rounding down, but at least 1) and following it directly.
+        /// With more than one, mipmaps are used as given rather than
+        /// generated.
+        int levels = 1;
     };
 
+    class framebuffer;
     class texture;
 
     class texture
@@ -57,24 +87,121 @@ namespace mope::gl
     public:
         void bind();
 
+        /// Make this texture from @p bytes, or with undefined pixels if
+        /// @p bytes is null, e.g. to be drawn to.
+        auto make(
+            std::byte const* bytes,
+            vec2i size,
+            pixel_format input_format,
+            texture_extra_options const& extra_options = texture_extra_options{}
+        ) & -> texture&;
+
         auto make(
             std::byte const* bytes,
             vec2i size,
             pixel_format input_format,
             texture_extra_options const& extra_options = texture_extra_options{}
+        ) && -> texture&&;
+
+        /// Make this texture a copy of @p source, which must already have been
+        /// made with the same @p size and @p input_format.
+        ///
+        /// The pixels are copied on the GPU, without a round trip through
+        /// client memory, along with as many of the source's mip levels as
+        /// `extra_options.levels` says.
+        auto make(
+            texture const& source,
+            vec2i size,
+            pixel_format input_format,
+            texture_extra_options const& extra_options = texture_extra_options{}
         ) & -> texture&;
 
         auto make(
+            texture const& source,
+            vec2i size,
+            pixel_format input_format,
+            texture_extra_options const& extra_options = texture_extra_options{}
+        ) && -> texture&&;
+
+        /// Replace the pixels of a region of mip level @p level of this
+        /// texture, which must already have been made with that level. The
+        /// other levels are left as they are, so give a mipmapped texture an
+        /// update for each level the region covers.
+        ///
+        /// Rows of @p bytes are tightly packed, but may be longer than the
+        /// region: @p row_length is the number of pixels in each row, if it
+        /// isn't just `size.x()`. This lets a region be uploaded straight out
+        /// of a larger image. Not for compressed formats.
+        auto update(
             std::byte const* bytes,
+            vec2i offset,
             vec2i size,
             pixel_format input_format,
+            int row_length = 0,
+            int level = 0
+        ) & -> texture&;
+
+        /// Make this texture an array of @p layers empty images of the same
+        /// size (a `GL_TEXTURE_2D_ARRAY`), to be filled with
+        /// @ref update_layer. Sprites pick a layer with their `page`.
+        ///
+        /// If the min filter is mipmapped, every level of a full mip chain is
+        /// made, and `extra_options.levels` is ignored.
+        ///
+        /// Throws @ref game_engine_error for compressed formats, since
+        /// layers are filled with uncompressed pixels.
+        ///
+        /// A texture that was already made as a single image is replaced by
+        /// a new texture, which its other copies don't share, and the same
+        /// goes the other way for @ref make.
+        auto make_array(
+            vec2i size,
+            int layers,
+            pixel_format format,
+            texture_extra_options const& extra_options = texture_extra_options{}
+        ) & -> texture&;
+
+        auto make_array(
+            vec2i size,
+            int layers,
+            pixel_format format,
             texture_extra_options const& extra_options = texture_extra_options{}
         ) && -> texture&&;
 
+        /// Replace the pixels of one whole layer of a texture made with
+        /// @ref make_array. @p bytes holds the first @p levels mip levels,
+        /// one after another, as for @ref texture_extra_options::levels;
+        /// those of a mipmapped array are left as they were unless given.
+        auto update_layer(
+            int layer,
+            std::byte const* bytes,
+            pixel_format input_format,
+            int levels = 1
+        ) & -> texture&;
+
         auto swizzle(std::array<color_component, 4> const& sources) & -> texture&;
         auto swizzle(std::array<color_component, 4> const& sources) && -> texture&&;
 
+        /// Whether this and @p that are copies of the same texture, which
+        /// has been made.
+        auto same_as(texture const& that) const -> bool
+        {
+            return m_id && static_cast<unsigned int>(m_id) == static_cast<unsigned int>(that.m_id);
+        }
+
+        /// Whether this texture was made with @ref make_array.
+        auto layered() const -> bool
+        {
+            return m_layered;
+        }
+
     private:
+        friend class framebuffer;
+
+        void set_layered(bool layered);
+        void apply_filters(texture_extra_options const& extra_options, pixel_format format);
+
         resource_id m_id;
+        bool m_layered = false;
     };
 } // namespace mope::gl
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "mope_game_engine/texture.hxx"
+#include "mope_vec/mope_vec.hxx"
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mope::gl
+{
+    /// A texture with layers of one size, handed out one at a time, for
+    /// sprites that share their dimensions.
+    ///
+    /// Sprites on any layers of the same array are drawn with one call, like
+    /// sprites from an atlas, but each layer is a whole texture, so there is
+    /// no padding between images and no bleeding across their edges.
+    class texture_array
+    {
+    public:
+        /// Sprites name their layer with an 8-bit page.
+        static constexpr auto MaxLayers = 256;
+
+        /// @param layers At most @ref MaxLayers.
+        texture_array(
+            vec2i size,
+            int layers,
+            pixel_format format,
+            texture_extra_options const& extra_options = texture_extra_options{}
+        );
+
+        /// Fill a free layer with an image of this array's size.
+        ///
+        /// Throws @ref game_engine_error if every layer is in use.
+        ///
+        /// @return The layer, to give to a @ref sprite_component.
+        auto allocate(std::byte const* bytes, pixel_format input_format) -> std::uint8_t;
+
+        /// Let the layer be reused. Sprites still showing it will show
+        /// whatever is put there next.
+        ///
+        /// Throws @ref game_engine_error if the layer isn't in the array, or
+        /// isn't in use.
+        void release(std::uint8_t layer);
+
+        auto texture() const -> gl::texture const&;
+        auto size() const -> vec2i;
+        auto free_layers() const -> std::size_t;
+
+    private:
+        gl::texture m_texture;
+        vec2i m_size;
+
+        int m_layers;
+
+        /// Levels of each layer: a full mip chain if the min filter is
+        /// mipmapped, else one.
+        int m_levels;
+
+        /// Highest last, so that layers are handed out in order.
+        std::vector<std::uint8_t> m_free;
+
+        /// Which layers have been handed out and not released.
+        std::bitset<MaxLayers> m_in_use;
+    };
+} // namespace mope::gl
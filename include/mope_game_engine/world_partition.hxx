@@ -0,0 +1,123 @@
+#pragma once
+
+#include "mope_game_engine/components/component.hxx"
+#include "mope_game_engine/components/world_focus.hxx"
+#include "mope_game_engine/component_serializer.hxx"
+#include "mope_game_engine/events/scene_reset.hxx"
+#include "mope_game_engine/events/tick.hxx"
+#include "mope_game_engine/game_scene.hxx"
+#include "mope_game_engine/game_system.hxx"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace mope
+{
+    /// Marks an entity as belonging to the world, rather than to the game, so
+    /// that a @ref world_partition may write it to disk and destroy it when it
+    /// is far from the focus. Entities read back from disk are given this
+    /// automatically.
+    struct streamed_component : public entity_component
+    {
+    };
+
+    struct world_partition_options
+    {
+        /// The directory holding one file per cell. Created if it is missing.
+        std::string directory;
+
+        /// The width and height of a cell, in world units.
+        float cell_size = 1024.0f;
+
+        /// Cells within this many cells of the focus cell (in either axis)
+        /// are loaded.
+        int load_radius = 1;
+
+        /// Cells further than this many cells from the focus cell are written
+        /// out. Keep this larger than `load_radius`, so that walking back and
+        /// forth over a cell border doesn't stream the same cells repeatedly.
+        int unload_radius = 2;
+
+        /// The most entities instantiated from loaded cells per tick. Cells
+        /// that arrive faster than this are instantiated over several ticks.
+        std::size_t max_instantiations_per_tick = 64;
+
+        /// Called for each entity read back from disk, after its streamed
+        /// components have been set. Use this to restore what can't be saved,
+        /// such as the textures of sprites.
+        std::function<void(game_scene&, entity_id)> on_instantiate;
+    };
+
+    /// A game system that streams entities to and from disk as the
+    /// @ref world_focus moves around the world. Nothing is streamed while
+    /// there is no focus.
+    ///
+    /// The world is divided into square cells by the x and y positions of each
+    /// entity's @ref transform_component. Cells near the focus are read from
+    /// disk and instantiated; cells that fall behind are written to disk, and
+    /// their entities destroyed. Only entities with a @ref streamed_component
+    /// and a @ref transform_component are streamed, and of their components,
+    /// only the transform and the types registered with @ref stream are saved.
+    /// Everything else is destroyed with the entity.
+    ///
+    /// Disk access happens on a thread owned by the partition, so streaming
+    /// never waits on the disk. To lay out a new world, create its entities
+    /// with a @ref streamed_component before the first tick; those that are
+    /// out of range will be written to their cells.
+    ///
+    /// Components are identified in the files by the order in which they were
+    /// registered, so register them in the same order every run.
+    class world_partition final : public game_system<tick_event, scene_reset_event>
+    {
+    public:
+        explicit world_partition(world_partition_options options);
+        ~world_partition();
+
+        world_partition(world_partition const&) = delete;
+        auto operator=(world_partition const&) -> world_partition& = delete;
+
+        /// Save `Component` along with streamed entities.
+        template <serializable_component Component>
+        void stream()
+        {
+            add_stream(
+                [](game_scene& scene, entity_id entity, std::vector<std::byte>& out)
+                {
+                    auto component = scene.get_component<Component>(entity);
+                    if (nullptr != component) {
+                        component_serializer<Component>::save(*component, out);
+                    }
+                    return nullptr != component;
+                },
+                [](game_scene& scene, entity_id entity, std::span<std::byte const> bytes)
+                {
+                    scene.set_component(component_serializer<Component>::load(entity, bytes));
+                }
+            );
+        }
+
+        void operator()(game_scene& scene, tick_event const&) override;
+
+        /// The streamed entities went with the scene, so the world starts
+        /// over from what is on disk. Cells that were loaded aren't saved.
+        void operator()(game_scene& scene, scene_reset_event const&) override;
+
+        /// Write out every streamed entity in the scene, destroy them, and
+        /// wait until they are on disk. Call this from
+        /// @ref game_scene::on_unload to save the world.
+        void flush(game_scene& scene);
+
+    private:
+        using save_function = bool (*)(game_scene&, entity_id, std::vector<std::byte>&);
+        using load_function = void (*)(game_scene&, entity_id, std::span<std::byte const>);
+
+        void add_stream(save_function save, load_function load);
+
+        class imp;
+        std::unique_ptr<imp> m_imp;
+    };
+} // namespace mope
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "mope_game_engine/components/component.hxx"
+#include "mope_game_engine/component_serializer.hxx"
+#include "mope_game_engine/events/scene_reset.hxx"
+#include "mope_game_engine/events/tick.hxx"
+#include "mope_game_engine/game_scene.hxx"
+#include "mope_game_engine/game_system.hxx"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace mope
+{
+    /// Marks an entity in a shard's scene as belonging to the sharded world,
+    /// so that it moves to the neighboring shard when it crosses into its
+    /// region, and is shown in the coordinating scene. Entities that arrive
+    /// from another shard are given this automatically.
+    struct sharded_component : public entity_component
+    {
+    };
+
+    /// Stands in for an entity of a shard in the coordinating scene, with a
+    /// copy of its streamed components as of the last tick.
+    struct shard_proxy_component : public entity_component
+    {
+        int shard;
+        entity_id remote; ///< The entity in the shard's scene.
+    };
+
+    struct world_shard_options
+    {
+        /// How many worker processes to split the world between.
+        int shard_count = 2;
+
+        /// The width of each shard's strip of the world, along x. Shard `i`
+        /// covers x from `origin + i * shard_width` up to the next shard,
+        /// except that the first and last shards reach out forever.
+        float shard_width = 1024.0f;
+        float origin = 0.0f;
+
+        /// The capacity of each shared memory ring: one for each direction
+        /// of each border, and one from each shard to the coordinator. A
+        /// shard's whole snapshot has to fit in its ring.
+        std::size_t ring_bytes = 4uz << 20;
+
+        /// Makes the scene of shard @p shard, in its worker process, with
+        /// the systems that simulate the world and the entities that start
+        /// in its strip. Worker scenes are never loaded by an engine, so they
+        /// have no graphics, no @ref I_game_engine, and no inputs.
+        std::function<std::unique_ptr<game_scene>(int shard)> make_scene;
+
+        /// Called in a worker for each entity that arrives from another
+        /// shard, after its streamed components have been set.
+        std::function<void(game_scene&, entity_id)> on_arrive;
+
+        /// Called in the coordinating scene for each new proxy, after its
+        /// streamed components have been set. Use this to restore what can't
+        /// be streamed, such as the textures of sprites.
+        std::function<void(game_scene&, entity_id)> on_proxy;
+    };
+
+    /// A game system that runs a world too big for one process's tick across
+    /// several local worker processes, each simulating a strip of it.
+    ///
+    /// Every tick of the scene it is added to, each worker ticks its own
+    /// scene once, in parallel, and this tick waits for all of them. Then
+    /// entities with a @ref sharded_component whose @ref transform_component
+    /// has left their worker's strip are handed to the neighbor in that
+    /// direction, and every worker sends a snapshot of its sharded entities,
+    /// which are merged into the scene as entities with a
+    /// @ref shard_proxy_component, to be drawn. Only the transform and the
+    /// types registered with @ref stream cross between processes.
+    ///
+    /// Workers are forked from this process, and everything between them
+    /// goes through shared memory rings, so this only runs on Linux, and
+    /// needs no network. A worker that fails or dies makes the next tick
+    /// throw @ref game_engine_error, and the snapshots of that tick are
+    /// dropped.
+    ///
+    /// Workers are forked by @ref start, which has to be called while this
+    /// is the only thread in the process, i.e. before the engine is made;
+    /// the system can be added to a scene afterwards. Register streams before
+    /// that, since the workers are forked with the same registrations.
+    class world_shards final : public game_system<tick_event, scene_reset_event>
+    {
+    public:
+        explicit world_shards(world_shard_options options);
+
+        /// Stops the workers and waits for them to exit.
+        ~world_shards();
+
+        world_shards(world_shards const&) = delete;
+        auto operator=(world_shards const&) -> world_shards& = delete;
+
+        /// Send `Component` along with sharded entities.
+        template <serializable_component Component>
+        void stream()
+        {
+            add_stream(
+                [](game_scene& scene, entity_id entity, std::vector<std::byte>& out)
+                {
+                    auto component = scene.get_component<Component>(entity);
+                    if (nullptr != component) {
+                        component_serializer<Component>::save(*component, out);
+                    }
+                    return nullptr != component;
+                },
+                [](game_scene& scene, entity_id entity, std::span<std::byte const> bytes)
+                {
+                    scene.set_component(component_serializer<Component>::load(entity, bytes));
+                }
+            );
+        }
+
+        /// Fork the workers, if they haven't been already. Ticking before
+        /// this throws @ref game_engine_error.
+        ///
+        /// Throws @ref game_engine_error if it can't, if the process already
+        /// has another thread, since a fork only takes the calling thread
+        /// along, or off Linux.
+        void start();
+
+        /// Which shard's strip @p x falls in.
+        auto shard_of(float x) const -> int;
+
+        void operator()(game_scene& scene, tick_event const& event) override;
+
+        /// The proxies went with the scene, so they are made again from the
+        /// next snapshots. The workers go on as they were.
+        void operator()(game_scene& scene, scene_reset_event const&) override;
+
+    private:
+        using save_function = bool (*)(game_scene&, entity_id, std::vector<std::byte>&);
+        using load_function = void (*)(game_scene&, entity_id, std::span<std::byte const>);
+
+        void add_stream(save_function save, load_function load);
+
+        class imp;
+        std::unique_ptr<imp> m_imp;
+    };
+} // namespace mope
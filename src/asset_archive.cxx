@@ -0,0 +1,268 @@
+#include "asset_archive.hxx"
+
+#include "lz4.hxx"
+#include "mip_chain.hxx"
+#include "mope_game_engine/game_engine_error.hxx"
+#include "mope_game_engine/texture.hxx"
+#include "mope_vec/mope_vec.hxx"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// All integers in an archive are little-endian, and are read in place.
+static_assert(std::endian::native == std::endian::little);
+
+namespace
+{
+    constexpr auto Magic = std::uint32_t{ 0x4b41504d }; // "MPAK"
+    constexpr auto Version = std::uint32_t{ 1 };
+
+    struct archive_header
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t entry_count;
+        std::uint32_t reserved;
+        std::uint64_t index_offset;
+        std::uint64_t names_offset;
+    };
+    static_assert(sizeof(archive_header) == 32);
+
+    struct archive_record
+    {
+        std::uint64_t data_offset;
+        std::uint64_t stored_size;
+        std::uint64_t size;
+        std::uint32_t name_offset;
+        std::uint32_t name_length;
+        std::uint32_t kind;
+        std::uint32_t compression;
+        std::int32_t width;
+        std::int32_t height;
+        std::uint32_t pixel_format;
+        std::uint32_t row_alignment;
+        std::uint32_t levels;
+        std::uint32_t reserved;
+    };
+    static_assert(sizeof(archive_record) == 64);
+
+    [[noreturn]] void throw_invalid(char const* path)
+    {
+        throw mope::game_engine_error{ std::string{ "\"" } + path + "\" is not a valid asset archive." };
+    }
+
+    template <typename T>
+    auto read_struct(std::span<std::byte const> bytes, std::size_t offset) -> T
+    {
+        auto value = T{};
+        std::memcpy(&value, bytes.data() + offset, sizeof(T));
+        return value;
+    }
+
+    auto fits(std::span<std::byte const> bytes, std::uint64_t offset, std::uint64_t size) -> bool
+    {
+        return offset <= bytes.size() && size <= bytes.size() - offset;
+    }
+
+    /// Whether a texture record's pixels are all there, so that uploading
+    /// them can't read past the end of the archive.
+    auto valid_texture(archive_record const& record) -> bool
+    {
+        if (record.width <= 0
+            || record.height <= 0
+            || (1 != record.row_alignment && 2 != record.row_alignment
+                && 4 != record.row_alignment && 8 != record.row_alignment))
+        {
+            return false;
+        }
+
+        auto size = mope::vec2i{ record.width, record.height };
+        if (record.levels > static_cast<std::uint32_t>(mope::mip_level_count(size))) {
+            return false;
+        }
+
+        // Every level follows the last, with compressed formats taking whole
+        // blocks even where a level is smaller than one.
+        auto format = static_cast<mope::gl::pixel_format>(record.pixel_format);
+        auto needed = std::uint64_t{ 0 };
+        for (auto level = 0u; level < record.levels; ++level) {
+            needed += mope::gl::image_size(
+                format, mope::mip_level_size(size, static_cast<int>(level)), static_cast<int>(record.row_alignment));
+        }
+        auto available = static_cast<std::uint32_t>(mope::asset_compression::none) == record.compression
+            ? record.stored_size
+            : record.size;
+        return needed <= available;
+    }
+
+    auto align_up(std::size_t value, std::size_t alignment) -> std::size_t
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    template <typename T>
+    void append_struct(std::vector<std::byte>& out, T const& value)
+    {
+        auto bytes = std::as_bytes(std::span{ &value, 1 });
+        out.insert(out.end(), bytes.begin(), bytes.end());
+    }
+}
+
+auto mope::read_asset(asset_archive_entry const& entry, std::vector<std::byte>& buffer)
+    -> std::span<std::byte const>
+{
+    switch (entry.compression) {
+    case asset_compression::none:
+        return entry.stored;
+
+    case asset_compression::lz4:
+        buffer.resize(entry.size);
+        lz4::decompress(entry.stored, buffer);
+        return buffer;
+    }
+
+    std::unreachable();
+}
+
+mope::asset_archive::asset_archive(char const* path)
+    : m_file{ path }
+    , m_entries{ }
+{
+    auto bytes = m_file.contents();
+    if (!fits(bytes, 0, sizeof(archive_header))) {
+        throw_invalid(path);
+    }
+
+    auto header = read_struct<archive_header>(bytes, 0);
+    if (Magic != header.magic
+        || Version != header.version
+        || !fits(bytes, header.index_offset, std::uint64_t{ header.entry_count } * sizeof(archive_record))
+        || !fits(bytes, header.names_offset, 0))
+    {
+        throw_invalid(path);
+    }
+
+    // Names are checked against what follows `names_offset`, rather than
+    // by adding their offsets to it, which could wrap around.
+    auto names = bytes.subspan(static_cast<std::size_t>(header.names_offset));
+
+    m_entries.reserve(header.entry_count);
+    for (auto i = 0uz; i < header.entry_count; ++i) {
+        auto record = read_struct<archive_record>(bytes, header.index_offset + i * sizeof(archive_record));
+        if (!fits(names, record.name_offset, record.name_length)
+            || !fits(bytes, record.data_offset, record.stored_size)
+            || record.kind > static_cast<std::uint32_t>(asset_kind::texture)
+            || record.compression > static_cast<std::uint32_t>(asset_compression::lz4)
+            || record.pixel_format > static_cast<std::uint32_t>(gl::pixel_format::bc7)
+            || record.levels < 1
+            || (static_cast<std::uint32_t>(asset_kind::texture) == record.kind && !valid_texture(record)))
+        {
+            throw_invalid(path);
+        }
+
+        auto name = std::string_view{
+            reinterpret_cast<char const*>(names.data() + record.name_offset),
+            record.name_length
+        };
+        m_entries.emplace(name, asset_archive_entry{
+            .name = name,
+            .kind = static_cast<asset_kind>(record.kind),
+            .compression = static_cast<asset_compression>(record.compression),
+            .stored = bytes.subspan(record.data_offset, record.stored_size),
+            .size = static_cast<std::size_t>(record.size),
+            .texture = {
+                .size = { record.width, record.height },
+                .format = static_cast<gl::pixel_format>(record.pixel_format),
+                .row_alignment = static_cast<int>(record.row_alignment),
+                .levels = static_cast<int>(record.levels),
+            },
+        });
+    }
+}
+
+auto mope::asset_archive::find(std::string_view name) const -> asset_archive_entry const*
+{
+    auto iter = m_entries.find(name);
+    return iter == m_entries.end() ? nullptr : &iter->second;
+}
+
+void mope::write_asset_archive(char const* path, std::span<asset_archive_input const> inputs)
+{
+    auto names = std::string{};
+    auto records = std::vector<archive_record>{};
+    auto blobs = std::vector<std::vector<std::byte>>{};
+    records.reserve(inputs.size());
+    blobs.reserve(inputs.size());
+
+    for (auto&& input : inputs) {
+        auto compression = asset_compression::none;
+        auto stored = input.contents;
+        if (input.compress) {
+            auto compressed = lz4::compress(input.contents);
+            if (compressed.size() < stored.size()) {
+                compression = asset_compression::lz4;
+                stored = std::move(compressed);
+            }
+        }
+
+        records.push_back(archive_record{
+            .data_offset = 0,
+            .stored_size = stored.size(),
+            .size = input.contents.size(),
+            .name_offset = static_cast<std::uint32_t>(names.size()),
+            .name_length = static_cast<std::uint32_t>(input.name.size()),
+            .kind = static_cast<std::uint32_t>(input.kind),
+            .compression = static_cast<std::uint32_t>(compression),
+            .width = input.texture.size.x(),
+            .height = input.texture.size.y(),
+            .pixel_format = static_cast<std::uint32_t>(input.texture.format),
+            .row_alignment = static_cast<std::uint32_t>(input.texture.row_alignment),
+            .levels = static_cast<std::uint32_t>(input.texture.levels),
+            .reserved = 0,
+        });
+        names += input.name;
+        blobs.push_back(std::move(stored));
+    }
+
+    auto header = archive_header{
+        .magic = Magic,
+        .version = Version,
+        .entry_count = static_cast<std::uint32_t>(records.size()),
+        .reserved = 0,
+        .index_offset = sizeof(archive_header),
+        .names_offset = sizeof(archive_header) + records.size() * sizeof(archive_record),
+    };
+
+    auto offset = align_up(header.names_offset + names.size(), asset_archive::Alignment);
+    for (auto i = 0uz; i < records.size(); ++i) {
+        records[i].data_offset = offset;
+        offset = align_up(offset + blobs[i].size(), asset_archive::Alignment);
+    }
+
+    auto out = std::vector<std::byte>{};
+    out.reserve(offset);
+    append_struct(out, header);
+    for (auto&& record : records) {
+        append_struct(out, record);
+    }
+    auto name_bytes = std::as_bytes(std::span{ names });
+    out.insert(out.end(), name_bytes.begin(), name_bytes.end());
+    for (auto i = 0uz; i < records.size(); ++i) {
+        out.resize(records[i].data_offset);
+        out.insert(out.end(), blobs[i].begin(), blobs[i].end());
+    }
+
+    auto file = std::ofstream{ path, std::ios::binary | std::ios::trunc };
+    file.write(reinterpret_cast<char const*>(out.data()), static_cast<std::streamsize>(out.size()));
+    if (!file) {
+        throw game_engine_error{ std::string{ "Failed writing \"" } + path + "\"." };
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "mapped_file.hxx"
+#include "mope_game_engine/texture.hxx"
+#include "mope_vec/mope_vec.hxx"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace mope
+{
+    enum class asset_kind : std::uint32_t
+    {
+        blob,       ///< Arbitrary file contents, e.g. a font or an encoded image.
+        texture,    ///< Pixels in the layout expected by `glTexImage2D` (or `glCompressedTexImage2D`).
+    };
+
+    enum class asset_compression : std::uint32_t
+    {
+        none,
+        lz4,        ///< A single LZ4 block; q.v. @ref lz4::compress.
+    };
+
+    /// How the pixels of a pre-baked texture are laid out.
+    struct baked_texture_layout
+    {
+        vec2i size;
+        gl::pixel_format format;
+        int row_alignment;
+
+        /// How many mip levels follow one another, q.v.
+        /// @ref gl::texture_extra_options::levels.
+        int levels = 1;
+    };
+
+    struct asset_archive_entry
+    {
+        std::string_view name;
+        asset_kind kind;
+        asset_compression compression;
+        std::span<std::byte const> stored;  ///< The bytes as they are stored in the archive.
+        std::size_t size;                   ///< The size of the entry once decompressed.
+        baked_texture_layout texture;       ///< Only meaningful if `kind` is `texture`.
+    };
+
+    /// Return the contents of @p entry.
+    ///
+    /// Uncompressed entries are returned straight out of the archive without
+    /// any copying. Compressed entries are decompressed into @p buffer.
+    auto read_asset(asset_archive_entry const& entry, std::vector<std::byte>& buffer)
+        -> std::span<std::byte const>;
+
+    /// A packed archive of assets, mapped into memory.
+    ///
+    /// The file starts with a fixed header followed by an index table, a
+    /// block of entry names, and finally the entries themselves, each aligned
+    /// to @ref asset_archive::Alignment bytes so that they can be handed
+    /// directly to consumers like FreeType and OpenGL.
+    ///
+    /// Archives are written by the `mope_asset_packer` tool.
+    class asset_archive final
+    {
+    public:
+        static constexpr auto Alignment = std::size_t{ 64 };
+
+        /// Throws @ref game_engine_error if @p path isn't a valid archive.
+        explicit asset_archive(char const* path);
+
+        /// Return the entry with the given name, or nullptr.
+        auto find(std::string_view name) const -> asset_archive_entry const*;
+
+    private:
+        mapped_file m_file;
+        std::unordered_map<std::string_view, asset_archive_entry> m_entries;
+    };
+
+    /// An asset to be written into an archive by @ref write_asset_archive.
+    struct asset_archive_input
+    {
+        std::string name;
+        asset_kind kind;
+        std::vector<std::byte> contents;
+        baked_texture_layout texture;
+
+        /// Compress this entry with LZ4, if that actually makes it smaller.
+        bool compress;
+    };
+
+    /// Throws @ref game_engine_error if the archive can't be written.
+    void write_asset_archive(char const* path, std::span<asset_archive_input const> inputs);
+} // namespace mope
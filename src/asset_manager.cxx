@@ -0,0 +1,542 @@
+#include "asset_manager.hxx"
+
+#include "asset_archive.hxx"
+#include "file_watcher.hxx"
+#include "image_decoder.hxx"
+#include "job_system.hxx"
+#include "mip_chain.hxx"
+#include "mope_game_engine/components/logger.hxx"
+#include "mope_game_engine/game_engine_error.hxx"
+#include "mope_game_engine/image.hxx"
+#include "mope_game_engine/texture.hxx"
+#include "mope_vec/mope_vec.hxx"
+#include "upload_worker.hxx"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace
+{
+    auto read_file(std::string const& path) -> std::vector<std::byte>
+    {
+        auto file = std::ifstream{ path, std::ios::binary | std::ios::ate };
+        if (!file) {
+            throw mope::game_engine_error{ "Failed to open file." };
+        }
+
+        auto size = static_cast<std::streamsize>(file.tellg());
+        auto contents = std::vector<std::byte>(static_cast<std::size_t>(size));
+        file.seekg(0);
+        if (!file.read(reinterpret_cast<char*>(contents.data()), size)) {
+            throw mope::game_engine_error{ "Failed to read file." };
+        }
+
+        return contents;
+    }
+
+    auto bytes_per_pixel(mope::gl::pixel_format format) -> std::size_t
+    {
+        switch (format) {
+        case mope::gl::pixel_format::r: return 1;
+        case mope::gl::pixel_format::rg: return 2;
+        case mope::gl::pixel_format::rgb: return 3;
+        case mope::gl::pixel_format::bgr: return 3;
+        case mope::gl::pixel_format::rgba: return 4;
+        case mope::gl::pixel_format::bgra: return 4;
+        default: std::unreachable();
+        }
+    }
+
+    struct dirty_rect
+    {
+        mope::vec2i offset;
+        mope::vec2i size;
+    };
+
+    /// Return the smallest rectangle containing every pixel that differs
+    /// between two images of the same size and format. Its size is zero if
+    /// the images are identical.
+    auto find_dirty_rect(mope::decoded_image const& before, mope::decoded_image const& after)
+        -> dirty_rect
+    {
+        auto const width = static_cast<std::size_t>(after.size.x());
+        auto const height = static_cast<std::size_t>(after.size.y());
+        auto const pixel_bytes = bytes_per_pixel(after.format);
+        auto const row_bytes = width * pixel_bytes;
+
+        auto row_differs = [&](std::size_t row)
+            {
+                return 0 != std::memcmp(
+                    before.pixels.data() + row * row_bytes,
+                    after.pixels.data() + row * row_bytes,
+                    row_bytes);
+            };
+
+        auto top = 0uz;
+        while (top < height && !row_differs(top)) {
+            ++top;
+        }
+        if (top == height) {
+            return { { 0, 0 }, { 0, 0 } };
+        }
+        auto bottom = height - 1;
+        while (!row_differs(bottom)) {
+            --bottom;
+        }
+
+        auto left = width;
+        auto right = 0uz;
+        for (auto row = top; row <= bottom; ++row) {
+            for (auto column = 0uz; column < width; ++column) {
+                auto offset = row * row_bytes + column * pixel_bytes;
+                if (0 != std::memcmp(before.pixels.data() + offset, after.pixels.data() + offset, pixel_bytes)) {
+                    left = std::min(left, column);
+                    right = std::max(right, column);
+                }
+            }
+        }
+
+        return {
+            { static_cast<int>(left), static_cast<int>(top) },
+            { static_cast<int>(right - left + 1), static_cast<int>(bottom - top + 1) },
+        };
+    }
+
+    /// Upload the part of each of @p decoded's mip levels that @p dirty, in
+    /// the first level, changes. Each pixel of a level is made from a 2x2
+    /// square of the one above, so the region shrinks with the levels.
+    void update_levels(mope::gl::texture& texture, mope::decoded_image const& decoded, dirty_rect dirty)
+    {
+        auto const pixel_bytes = bytes_per_pixel(decoded.format);
+        auto level_start = 0uz;
+        for (auto level = 0; level < decoded.levels; ++level) {
+            auto size = mope::mip_level_size(decoded.size, level);
+            auto left = dirty.offset.x() >> level;
+            auto top = dirty.offset.y() >> level;
+            auto right = std::min((dirty.offset.x() + dirty.size.x() - 1) >> level, size.x() - 1);
+            auto bottom = std::min((dirty.offset.y() + dirty.size.y() - 1) >> level, size.y() - 1);
+
+            auto first = level_start
+                + (static_cast<std::size_t>(top) * static_cast<std::size_t>(size.x()) + static_cast<std::size_t>(left))
+                    * pixel_bytes;
+            texture.update(
+                decoded.pixels.data() + first,
+                mope::vec2i{ left, top },
+                mope::vec2i{ right - left + 1, bottom - top + 1 },
+                decoded.format,
+                size.x(),
+                level);
+
+            level_start += static_cast<std::size_t>(size.x()) * static_cast<std::size_t>(size.y()) * pixel_bytes;
+        }
+    }
+
+    /// How many mip levels a decoded image was uploaded with, q.v.
+    /// asset_manager::load_job.
+    auto decoded_levels(mope::image const& image) -> int
+    {
+        return mope::gl::is_mipmapped(image.options.min_filter) ? mope::mip_level_count(image.size) : 1;
+    }
+}
+
+mope::asset_manager::asset_manager(job_system& jobs)
+    : m_jobs{ jobs }
+    , m_archives{ }
+    , m_shared{ std::make_shared<shared_state>() }
+    , m_images{ }
+    , m_results{ }
+    , m_watcher{ nullptr }
+    , m_uploads{ nullptr }
+    , m_uploading{ }
+    , m_retained{ }
+{
+}
+
+void mope::asset_manager::mount_archive(char const* path)
+{
+    m_archives.push_back(std::make_shared<asset_archive const>(path));
+}
+
+auto mope::asset_manager::find_packed(std::string_view name) const -> packed_asset
+{
+    for (auto&& archive : m_archives | std::views::reverse) {
+        if (auto entry = archive->find(name); nullptr != entry) {
+            return { archive, entry };
+        }
+    }
+    return { nullptr, nullptr };
+}
+
+auto mope::asset_manager::load_image(std::string_view path, image_options const& options)
+    -> std::shared_ptr<image const>
+{
+    if (auto iter = m_images.find(path); m_images.end() != iter) {
+        return iter->second;
+    }
+
+    constexpr auto transparent = std::array<std::byte, 4>{};
+    auto loaded = std::make_shared<image>(image{
+        .texture = gl::texture{}.make(
+            transparent.data(),
+            vec2i{ 1, 1 },
+            gl::pixel_format::rgba,
+            {
+                .min_filter = gl::texture_min_filter::nearest,
+                .mag_filter = gl::texture_mag_filter::nearest,
+            }),
+        .size = vec2i{ 0, 0 },
+        .ready = false,
+        .options = options,
+    });
+
+    auto iter = m_images.emplace(path, std::move(loaded)).first;
+
+    // Textures baked into an archive need no decoding, so there's nothing to
+    // gain from a trip through the job system: hand the mapped pixels
+    // straight to GL (or to the upload worker).
+    if (auto packed = find_packed(path);
+        nullptr != packed.entry
+        && asset_kind::texture == packed.entry->kind
+        && asset_compression::none == packed.entry->compression)
+    {
+        auto pixels = packed.entry->stored.data();
+        auto layout = packed.entry->texture;
+        upload_image(iter->first, pixels, layout, std::move(packed.archive));
+        return iter->second;
+    }
+
+    submit_load(iter->first);
+    if (nullptr != m_watcher && nullptr == find_packed(path).entry) {
+        m_watcher->watch(iter->first);
+    }
+    return iter->second;
+}
+
+void mope::asset_manager::process_uploads(I_logger* logger)
+{
+    {
+        // Swap rather than move, so that both vectors keep their capacity.
+        auto lock = std::scoped_lock{ m_shared->mutex };
+        std::swap(m_results, m_shared->results);
+    }
+
+    for (auto&& result : m_results) {
+        auto iter = m_images.find(result.path);
+        if (m_images.end() == iter) {
+            // We were cleared while this was loading.
+            continue;
+        }
+        auto& loaded = *iter->second;
+
+        if (auto decoded = std::get_if<decoded_image>(&result.outcome)) {
+            auto retained = m_retained.find(result.path);
+            if (m_retained.end() != retained
+                && loaded.ready
+                && !m_uploading.contains(result.path)
+                && retained->second.size == decoded->size
+                && retained->second.format == decoded->format
+                && retained->second.levels == decoded->levels)
+            {
+                // A reload of the same shape: only upload what changed, in
+                // each of the levels the load job built.
+                auto dirty = find_dirty_rect(retained->second, *decoded);
+                if (0 != dirty.size.x()) {
+                    update_levels(loaded.texture, *decoded, dirty);
+                }
+            }
+            else {
+                if (nullptr != m_watcher) {
+                    m_retained.insert_or_assign(result.path, *decoded);
+                }
+
+                // Decoded rows are always tightly packed.
+                auto layout = baked_texture_layout{ decoded->size, decoded->format, 1, decoded->levels };
+                auto pixels = std::make_shared<decoded_image const>(std::move(*decoded));
+                upload_image(result.path, pixels->pixels.data(), layout, pixels);
+            }
+        }
+        else if (auto duplicate = std::get_if<duplicate_of>(&result.outcome)) {
+            // Results are queued in the order they were decoded, so the image
+            // we duplicate has always been uploaded by now... unless we were
+            // cleared in between, in which case we fall back to decoding.
+            auto source = m_images.find(duplicate->path);
+            if (m_images.end() != source && m_uploading.contains(duplicate->path)) {
+                // The original is still on its way to the GPU; try again next
+                // time.
+                auto lock = std::scoped_lock{ m_shared->mutex };
+                m_shared->results.push_back(std::move(result));
+            }
+            else if (m_images.end() != source
+                && source->second->ready
+                && gl::is_mipmapped(source->second->options.min_filter)
+                    == gl::is_mipmapped(loaded.options.min_filter))
+            {
+                auto const& original = *source->second;
+                // Everything we decode is RGBA, with every mip level if its
+                // filter samples them; q.v. load_job().
+                loaded.texture.make(original.texture, original.size, gl::pixel_format::rgba, {
+                    .min_filter = loaded.options.min_filter,
+                    .mag_filter = loaded.options.mag_filter,
+                    .levels = decoded_levels(original),
+                });
+                loaded.size = original.size;
+                loaded.ready = true;
+
+                // Keep what we retain in step with what we just uploaded.
+                if (auto pixels = m_retained.find(duplicate->path); m_retained.end() != pixels) {
+                    m_retained.insert_or_assign(result.path, pixels->second);
+                }
+                else if (auto stale = m_retained.find(result.path); m_retained.end() != stale) {
+                    m_retained.erase(stale);
+                }
+            }
+            else {
+                {
+                    auto lock = std::scoped_lock{ m_shared->mutex };
+                    m_shared->decoded_content.erase(duplicate->content);
+                }
+                submit_load(result.path);
+            }
+        }
+        else if (auto error = std::get_if<load_error>(&result.outcome)) {
+            if (nullptr != logger) {
+                logger->log(
+                    ("Failed to load image \"" + result.path + "\": " + error->message).c_str(),
+                    I_logger::log_level::warning
+                );
+            }
+        }
+    }
+
+    m_results.clear();
+}
+
+void mope::asset_manager::set_watcher(file_watcher* watcher)
+{
+    m_watcher = watcher;
+    if (nullptr == m_watcher) {
+        m_retained.clear();
+        return;
+    }
+
+    for (auto&& path : m_images | std::views::keys) {
+        if (nullptr == find_packed(path).entry) {
+            m_watcher->watch(path);
+        }
+    }
+}
+
+void mope::asset_manager::set_upload_worker(upload_worker* uploads)
+{
+    m_uploads = uploads;
+    m_uploading.clear();
+}
+
+void mope::asset_manager::reload_image(std::string_view path)
+{
+    auto iter = m_images.find(path);
+    if (m_images.end() == iter || nullptr != find_packed(path).entry) {
+        return;
+    }
+
+    {
+        // The old contents no longer live at this path, so nothing should be
+        // treated as a duplicate of it anymore.
+        auto lock = std::scoped_lock{ m_shared->mutex };
+        std::erase_if(m_shared->decoded_content, [&](auto&& entry)
+            {
+                return entry.second == path;
+            });
+    }
+    submit_load(iter->first);
+}
+
+void mope::asset_manager::clear()
+{
+    m_images.clear();
+    m_results.clear();
+    m_retained.clear();
+    m_uploading.clear();
+
+    auto lock = std::scoped_lock{ m_shared->mutex };
+    m_shared->results.clear();
+    m_shared->decoded_content.clear();
+}
+
+void mope::asset_manager::submit_load(std::string path)
+{
+    // The job holds on to the archive, so it stays mapped even if we don't.
+    auto packed = find_packed(path);
+    auto mipmapped = gl::is_mipmapped(m_images.find(path)->second->options.min_filter);
+    m_jobs.submit([shared = m_shared, path = std::move(path), packed = std::move(packed), mipmapped]()
+        {
+            load_job(*shared, path, packed, mipmapped);
+        });
+}
+
+void mope::asset_manager::upload_image(
+    std::string const& path,
+    std::byte const* pixels,
+    baked_texture_layout const& layout,
+    std::shared_ptr<void const> keep_alive)
+{
+    if (nullptr == m_uploads) {
+        auto& loaded = *m_images.find(path)->second;
+        loaded.texture.make(pixels, layout.size, layout.format, {
+            .row_alignment = layout.row_alignment,
+            .min_filter = loaded.options.min_filter,
+            .mag_filter = loaded.options.mag_filter,
+            .levels = layout.levels,
+        });
+        loaded.size = layout.size;
+        loaded.ready = true;
+        return;
+    }
+
+    ++m_uploading[path];
+    auto staging = std::make_shared<gl::texture>();
+    m_uploads->submit(
+        [staging, pixels, layout, keep_alive = std::move(keep_alive)]()
+        {
+            staging->make(pixels, layout.size, layout.format, {
+                .row_alignment = layout.row_alignment,
+                .min_filter = gl::texture_min_filter::nearest,
+                .mag_filter = gl::texture_mag_filter::nearest,
+                .levels = layout.levels,
+            });
+        },
+        [this, path, staging, layout](bool uploaded)
+        {
+            if (auto uploading = m_uploading.find(path); m_uploading.end() != uploading) {
+                if (0 == --uploading->second) {
+                    m_uploading.erase(uploading);
+                }
+            }
+
+            if (!uploaded) {
+                // The worker logged it; the image keeps what it had.
+                return;
+            }
+
+            auto iter = m_images.find(path);
+            if (m_images.end() == iter) {
+                // We were cleared while this was uploading.
+                return;
+            }
+
+            // A copy on the GPU is cheap, and keeps every handle to the image
+            // pointing at the same texture.
+            auto& loaded = *iter->second;
+            loaded.texture.make(*staging, layout.size, layout.format, {
+                .min_filter = loaded.options.min_filter,
+                .mag_filter = loaded.options.mag_filter,
+                .levels = layout.levels,
+            });
+            loaded.size = layout.size;
+            loaded.ready = true;
+        });
+}
+
+auto mope::asset_manager::content_key_of(std::span<std::byte const> data) -> content_key
+{
+    // 64-bit FNV-1a, a byte at a time.
+    auto fnv = std::uint64_t{ 0xcbf29ce484222325 };
+    for (auto b : data) {
+        fnv ^= std::to_integer<std::uint64_t>(b);
+        fnv *= std::uint64_t{ 0x100000001b3 };
+    }
+
+    // And a multiply-rotate hash of 8 bytes at a time, finished with
+    // MurmurHash3's mix, which shares nothing with FNV but the input.
+    auto mix = std::uint64_t{ data.size() };
+    auto i = 0uz;
+    for (; i + 8 <= data.size(); i += 8) {
+        auto word = std::uint64_t{};
+        std::memcpy(&word, data.data() + i, sizeof(word));
+        mix = std::rotl(mix ^ (word * 0x87c37b91114253d5), 31) * 0x4cf5ad432745937f;
+    }
+    for (; i < data.size(); ++i) {
+        mix = std::rotl(mix ^ std::to_integer<std::uint64_t>(data[i]), 8) * 0x87c37b91114253d5;
+    }
+    mix ^= mix >> 33;
+    mix *= 0xff51afd7ed558ccd;
+    mix ^= mix >> 33;
+    mix *= 0xc4ceb9fe1a85ec53;
+    mix ^= mix >> 33;
+
+    return content_key{ data.size(), fnv, mix };
+}
+
+void mope::asset_manager::load_job(
+    shared_state& state,
+    std::string const& path,
+    packed_asset const& packed,
+    bool mipmapped)
+{
+    try {
+        auto buffer = std::vector<std::byte>{};
+        auto contents = std::span<std::byte const>{};
+        if (nullptr != packed.entry) {
+            contents = read_asset(*packed.entry, buffer);
+        }
+        else {
+            buffer = read_file(path);
+            contents = buffer;
+        }
+
+        if (nullptr != packed.entry && asset_kind::texture == packed.entry->kind) {
+            // Baked textures are already pixels; they only needed decompressing.
+            auto const& layout = packed.entry->texture;
+            auto pixels = std::vector<std::byte>(contents.begin(), contents.end());
+            auto lock = std::scoped_lock{ state.mutex };
+            state.results.push_back({ path, decoded_image{ std::move(pixels), layout.size, layout.format, layout.levels } });
+            return;
+        }
+
+        auto key = content_key_of(contents);
+
+        {
+            auto lock = std::scoped_lock{ state.mutex };
+            if (auto iter = state.decoded_content.find(key); state.decoded_content.end() != iter) {
+                state.results.push_back({ path, duplicate_of{ iter->second, key } });
+                return;
+            }
+        }
+
+        // Build the mip chain here, on the worker, rather than leaving the
+        // render thread to generate it on the GPU while it uploads. Images
+        // whose filter never samples it go without.
+        auto decoded = decode_image(contents);
+        if (mipmapped) {
+            decoded.levels = append_mip_chain(
+                decoded.pixels, decoded.size, static_cast<int>(bytes_per_pixel(decoded.format)));
+        }
+
+        // Claiming the content and queueing the pixels under the same lock is what
+        // guarantees that duplicates are always queued after their original.
+        // If another job decoded the same content while we were busy, it got
+        // there first and we just upload our own copy.
+        auto lock = std::scoped_lock{ state.mutex };
+        state.decoded_content.try_emplace(key, path);
+        state.results.push_back({ path, std::move(decoded) });
+    }
+    catch (std::exception const& ex) {
+        auto lock = std::scoped_lock{ state.mutex };
+        state.results.push_back({ path, load_error{ ex.what() } });
+    }
+}
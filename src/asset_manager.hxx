@@ -0,0 +1,202 @@
+#pragma once
+
+#include "asset_archive.hxx"
+#include "image_decoder.hxx"
+#include "mope_game_engine/image.hxx"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace mope
+{
+    class file_watcher;
+    class job_system;
+    class upload_worker;
+    struct I_logger;
+
+    /// Loads images on the @ref job_system and caches them.
+    ///
+    /// Images are cached by path, so asking for the same path twice costs a
+    /// hash lookup. They are also deduplicated by content: if a file has the
+    /// same size and hashes as an image that has already been decoded, it isn't
+    /// decoded again, and its texture is filled by copying the existing one on
+    /// the GPU.
+    ///
+    /// Paths are first looked up in the mounted archives, q.v.
+    /// @ref asset_archive. Textures that were baked into an archive
+    /// uncompressed are uploaded straight out of the mapped file as soon as
+    /// they are asked for; everything else is read or decompressed, and
+    /// decoded, on the job system.
+    ///
+    /// Only the file reading and decoding happens on other threads. Every
+    /// method here must be called on the thread that owns the GL context.
+    class asset_manager
+    {
+    public:
+        explicit asset_manager(job_system& jobs);
+
+        asset_manager(asset_manager const&) = delete;
+        auto operator=(asset_manager const&) -> asset_manager& = delete;
+
+        /// An entry in a mounted archive, along with the archive that keeps it
+        /// alive.
+        struct packed_asset
+        {
+            std::shared_ptr<asset_archive const> archive;
+            asset_archive_entry const* entry;
+        };
+
+        /// Mount the archive at @p path. Archives mounted later take
+        /// precedence over those mounted earlier, and all of them take
+        /// precedence over loose files.
+        ///
+        /// Throws @ref game_engine_error if the archive can't be mapped.
+        void mount_archive(char const* path);
+
+        /// Find @p name in the mounted archives. The returned entry is null if
+        /// it isn't in any of them.
+        auto find_packed(std::string_view name) const -> packed_asset;
+
+        /// Return the image at @p path, starting to load it with @p options
+        /// if this is the first time it has been asked for.
+        ///
+        /// @sa mope::image
+        auto load_image(std::string_view path, image_options const& options = image_options{})
+            -> std::shared_ptr<image const>;
+
+        /// Upload every image that has finished decoding since the last call.
+        ///
+        /// Images that failed to load are reported to @p logger, and keep
+        /// their placeholder texture.
+        void process_uploads(I_logger* logger);
+
+        /// Watch every image loaded from a loose file, so that
+        /// @ref reload_image can be called when it changes. Pass nullptr to
+        /// stop.
+        ///
+        /// While watching, the decoded pixels of each image are kept, so that
+        /// a reload only uploads the region that actually changed.
+        void set_watcher(file_watcher* watcher);
+
+        /// Upload pixels on @p uploads from now on, rather than on the calling
+        /// thread. Pass nullptr to go back to uploading synchronously.
+        ///
+        /// Each image is uploaded into a staging texture on the worker, then
+        /// copied into the image's own texture on the GPU once the upload's
+        /// fence has signaled, so that handles to the image stay valid.
+        void set_upload_worker(upload_worker* uploads);
+
+        /// Decode the image at @p path again, if it's one we've loaded from a
+        /// loose file, and update its texture in place.
+        void reload_image(std::string_view path);
+
+        /// Forget every cached image. Handles that are still held elsewhere
+        /// keep their textures alive.
+        void clear();
+
+    private:
+        /// Lets us look up `std::string` keys with a `std::string_view`.
+        struct string_hash
+        {
+            using is_transparent = void;
+
+            auto operator()(std::string_view s) const -> std::size_t
+            {
+                return std::hash<std::string_view>{}(s);
+            }
+        };
+
+        /// Tells files apart by their contents: their size, and two unrelated
+        /// 64-bit hashes of their bytes, so that showing one image in place
+        /// of another takes more than a collision of either hash.
+        struct content_key
+        {
+            std::uint64_t size;
+            std::uint64_t fnv;
+            std::uint64_t mix;
+
+            auto operator==(content_key const&) const -> bool = default;
+        };
+
+        struct content_key_hash
+        {
+            auto operator()(content_key const& key) const -> std::size_t
+            {
+                return static_cast<std::size_t>(key.fnv);
+            }
+        };
+
+        struct duplicate_of
+        {
+            std::string path;
+            content_key content;
+        };
+
+        struct load_error
+        {
+            std::string message;
+        };
+
+        struct load_result
+        {
+            std::string path;
+            std::variant<decoded_image, duplicate_of, load_error> outcome;
+        };
+
+        /// State shared with the decoding jobs, which may outlive us.
+        struct shared_state
+        {
+            std::mutex mutex;
+            std::vector<load_result> results;
+
+            /// The path of the first image decoded with each content.
+            std::unordered_map<content_key, std::string, content_key_hash> decoded_content;
+        };
+
+        /// Read and decode one image, building its mip chain if
+        /// @p mipmapped.
+        static auto content_key_of(std::span<std::byte const> data) -> content_key;
+
+        static void load_job(
+            shared_state& state,
+            std::string const& path,
+            packed_asset const& packed,
+            bool mipmapped);
+        void submit_load(std::string path);
+
+        /// Fill the texture of the image at @p path, which must be in
+        /// `m_images`. @p keep_alive owns the memory that @p pixels points
+        /// into, for as long as an asynchronous upload needs it.
+        void upload_image(
+            std::string const& path,
+            std::byte const* pixels,
+            baked_texture_layout const& layout,
+            std::shared_ptr<void const> keep_alive);
+
+        job_system& m_jobs;
+        std::vector<std::shared_ptr<asset_archive const>> m_archives;
+        std::shared_ptr<shared_state> m_shared;
+        std::unordered_map<std::string, std::shared_ptr<image>, string_hash, std::equal_to<>>
+            m_images;
+        std::vector<load_result> m_results;
+        file_watcher* m_watcher;
+        upload_worker* m_uploads;
+
+        /// The number of uploads in flight on `m_uploads` for each image.
+        std::unordered_map<std::string, int, string_hash, std::equal_to<>>
+            m_uploading;
+
+        /// The pixels last uploaded for each image, while watching.
+        std::unordered_map<std::string, decoded_image, string_hash, std::equal_to<>>
+            m_retained;
+    };
+} // namespace mope
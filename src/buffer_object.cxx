@@ -14,6 +14,12 @@ void mope::gl::buffer_object::fill(const void* data, std::size_t size)
     ::glBufferData(m_target, size, data, GL_STATIC_DRAW);
 }
 
+void mope::gl::buffer_object::stream(const void* data, std::size_t size)
+{
+    bind();
+    ::glBufferData(m_target, size, data, GL_STREAM_DRAW);
+}
+
 void mope::gl::buffer_object::bind()
 {
     if (!m_id) {
@@ -24,6 +24,10 @@ namespace mope::gl
             fill(data.data(), data.size() * sizeof(T));
         }
 
+        /// Replace the whole buffer with data that will be drawn once or a
+        /// few times, e.g. per-frame instance data.
+        void stream(const void* data, std::size_t size);
+
         void bind();
 
     protected:
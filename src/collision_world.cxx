@@ -0,0 +1,239 @@
+#include "mope_game_engine/collision_world.hxx"
+
+#include "mope_game_engine/components/transform.hxx"
+#include "mope_game_engine/game_scene.hxx"
+#include "mope_vec/mope_vec.hxx"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+    using namespace mope;
+
+    auto make_key(int x, int y) -> std::uint64_t
+    {
+        return std::uint64_t{ static_cast<std::uint32_t>(x) } << 32
+            | static_cast<std::uint32_t>(y);
+    }
+
+    auto cell_of(vec2f const& position, float cell_size) -> vec2i
+    {
+        return vec2i{
+            static_cast<int>(std::floor(position.x() / cell_size)),
+            static_cast<int>(std::floor(position.y() / cell_size))
+        };
+    }
+
+    auto overlaps(vec2f const& a_min, vec2f const& a_max, vec2f const& b_min, vec2f const& b_max) -> bool
+    {
+        // Boxes that only touch don't overlap, so that resting against a
+        // wall isn't a contact every tick.
+        return a_min.x() < b_max.x() && b_min.x() < a_max.x()
+            && a_min.y() < b_max.y() && b_min.y() < a_max.y();
+    }
+}
+
+mope::collision_world::collision_world(collision_world_options options)
+    : m_options{ options }
+    , m_tick{ 0 }
+    , m_bodies{ }
+    , m_index_map{ }
+    , m_grid{ }
+    , m_woken{ }
+{
+}
+
+void mope::collision_world::operator()(game_scene& scene, tick_event const&)
+{
+    ++m_tick;
+    update_bodies(scene);
+    find_contacts(scene);
+}
+
+void mope::collision_world::operator()(game_scene&, scene_reset_event const&)
+{
+    m_bodies.clear();
+    m_index_map.clear();
+    m_woken.clear();
+
+    // Keep the cells, which will mostly be filled again.
+    for (auto&& [key, cell] : m_grid) {
+        cell.clear();
+    }
+}
+
+auto mope::collision_world::is_asleep(entity_id entity) const -> bool
+{
+    auto iter = m_index_map.find(entity);
+    return m_index_map.end() != iter && m_bodies[iter->second].asleep;
+}
+
+void mope::collision_world::wake(entity_id entity)
+{
+    if (auto iter = m_index_map.find(entity); m_index_map.end() != iter) {
+        auto& body = m_bodies[iter->second];
+        body.asleep = false;
+        body.resting_ticks = 0;
+    }
+}
+
+void mope::collision_world::update_bodies(game_scene& scene)
+{
+    for (auto&& [collider, transform] : scene.query<collider_component, transform_component>().exec()) {
+        // Sizes may be negative, so sort the corners.
+        auto const& position = transform.position();
+        auto far_corner = position + transform.size();
+        auto box = bounds{
+            .min = vec2f{ std::min(position.x(), far_corner.x()), std::min(position.y(), far_corner.y()) },
+            .max = vec2f{ std::max(position.x(), far_corner.x()), std::max(position.y(), far_corner.y()) },
+        };
+
+        auto [iter, inserted] = m_index_map.try_emplace(collider.entity, m_bodies.size());
+        if (inserted) {
+            m_bodies.push_back(body{
+                .entity = collider.entity,
+                .box = box,
+                .min_cell = { },
+                .max_cell = { },
+                .resting_ticks = 0,
+                .last_seen = m_tick,
+                .asleep = false,
+            });
+            insert_into_grid(iter->second);
+            continue;
+        }
+
+        auto& body = m_bodies[iter->second];
+        body.last_seen = m_tick;
+        if (box.min != body.box.min || box.max != body.box.max) {
+            body.box = box;
+            body.resting_ticks = 0;
+            body.asleep = false;
+
+            // Only touch the grid if the body crossed into other cells.
+            if (cell_of(box.min, m_options.cell_size) != body.min_cell
+                || cell_of(box.max, m_options.cell_size) != body.max_cell)
+            {
+                remove_from_grid(iter->second);
+                insert_into_grid(iter->second);
+            }
+        }
+        else if (!body.asleep && ++body.resting_ticks >= m_options.sleep_after_ticks) {
+            body.asleep = true;
+        }
+    }
+
+    // Forget colliders whose entity (or component) is gone.
+    for (auto i = m_bodies.size(); i-- > 0; ) {
+        if (m_bodies[i].last_seen != m_tick) {
+            remove_body(i);
+        }
+    }
+}
+
+void mope::collision_world::find_contacts(game_scene& scene)
+{
+    for (auto i = 0uz; i < m_bodies.size(); ++i) {
+        auto const& body = m_bodies[i];
+        if (body.asleep) {
+            continue;
+        }
+
+        for (auto y = body.min_cell.y(); y <= body.max_cell.y(); ++y) {
+            for (auto x = body.min_cell.x(); x <= body.max_cell.x(); ++x) {
+                for (auto j : m_grid[make_key(x, y)]) {
+                    auto const& other = m_bodies[j];
+
+                    // A pair of awake bodies is tested once, from the body
+                    // with the lower entity. A sleeping body is tested from
+                    // the awake side only.
+                    if (j == i || (!other.asleep && other.entity < body.entity)) {
+                        continue;
+                    }
+
+                    // Bodies that share several cells are tested only in the
+                    // first cell they share.
+                    if (x != std::max(body.min_cell.x(), other.min_cell.x())
+                        || y != std::max(body.min_cell.y(), other.min_cell.y()))
+                    {
+                        continue;
+                    }
+
+                    if (!overlaps(body.box.min, body.box.max, other.box.min, other.box.max)) {
+                        continue;
+                    }
+
+                    scene.emplace_event<contact_event>(
+                        std::min(body.entity, other.entity),
+                        std::max(body.entity, other.entity)
+                    );
+                    if (other.asleep) {
+                        m_woken.push_back(j);
+                    }
+                }
+            }
+        }
+    }
+
+    // Waking bodies during the loop above would find some pairs twice.
+    for (auto j : m_woken) {
+        m_bodies[j].asleep = false;
+        m_bodies[j].resting_ticks = 0;
+    }
+    m_woken.clear();
+}
+
+void mope::collision_world::insert_into_grid(std::size_t index)
+{
+    auto& body = m_bodies[index];
+    body.min_cell = cell_of(body.box.min, m_options.cell_size);
+    body.max_cell = cell_of(body.box.max, m_options.cell_size);
+    for (auto y = body.min_cell.y(); y <= body.max_cell.y(); ++y) {
+        for (auto x = body.min_cell.x(); x <= body.max_cell.x(); ++x) {
+            m_grid[make_key(x, y)].push_back(index);
+        }
+    }
+}
+
+void mope::collision_world::remove_from_grid(std::size_t index)
+{
+    auto const& body = m_bodies[index];
+    for (auto y = body.min_cell.y(); y <= body.max_cell.y(); ++y) {
+        for (auto x = body.min_cell.x(); x <= body.max_cell.x(); ++x) {
+            auto iter = m_grid.find(make_key(x, y));
+            std::erase(iter->second, index);
+            if (iter->second.empty()) {
+                m_grid.erase(iter);
+            }
+        }
+    }
+}
+
+void mope::collision_world::remove_body(std::size_t index)
+{
+    remove_from_grid(index);
+    m_index_map.erase(m_bodies[index].entity);
+
+    // Move the last body into the hole, and repoint the grid cells and index
+    // map entry that referred to it.
+    auto last = m_bodies.size() - 1;
+    if (index != last) {
+        auto const& moved = m_bodies[last];
+        for (auto y = moved.min_cell.y(); y <= moved.max_cell.y(); ++y) {
+            for (auto x = moved.min_cell.x(); x <= moved.max_cell.x(); ++x) {
+                for (auto&& entry : m_grid[make_key(x, y)]) {
+                    if (last == entry) {
+                        entry = index;
+                    }
+                }
+            }
+        }
+        m_index_map[moved.entity] = index;
+        m_bodies[index] = moved;
+    }
+    m_bodies.pop_back();
+}
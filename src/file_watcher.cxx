@@ -0,0 +1,148 @@
+#include "file_watcher.hxx"
+
+#include "mope_game_engine/game_engine_error.hxx"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#if defined(__linux__)
+
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstring>
+
+mope::file_watcher::file_watcher()
+    : m_fd{ ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC) }
+    , m_directories{ }
+{
+    if (-1 == m_fd) {
+        throw game_engine_error{ "Failed to initialize inotify." };
+    }
+}
+
+mope::file_watcher::~file_watcher()
+{
+    ::close(m_fd);
+}
+
+auto mope::file_watcher::watch(std::string const& path) -> bool
+{
+    auto file = std::filesystem::path{ path };
+    auto directory = file.parent_path();
+    if (directory.empty()) {
+        directory = ".";
+    }
+
+    // Adding a directory that is already watched returns the same descriptor.
+    auto wd = ::inotify_add_watch(m_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (-1 == wd) {
+        return false;
+    }
+
+    auto& paths = m_directories[wd].files[file.filename().string()];
+    if (std::ranges::find(paths, path) == paths.end()) {
+        paths.push_back(path);
+    }
+    return true;
+}
+
+auto mope::file_watcher::poll() -> std::vector<std::string>
+{
+    auto changed = std::vector<std::string>{};
+
+    alignas(inotify_event) char buffer[4096];
+    for (;;) {
+        auto length = ::read(m_fd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            // EAGAIN: there's nothing left to read.
+            break;
+        }
+
+        for (auto offset = 0z; offset < length; ) {
+            auto event = inotify_event{};
+            std::memcpy(&event, buffer + offset, sizeof(event));
+            auto name_start = buffer + offset + sizeof(event);
+            offset += static_cast<std::ptrdiff_t>(sizeof(event) + event.len);
+
+            // Events about the watch itself, such as IN_IGNORED and
+            // IN_Q_OVERFLOW, have no name at all, and a name is only padded
+            // with nulls up to `len`, not necessarily terminated.
+            if (0 == event.len) {
+                continue;
+            }
+            auto name = std::string{ name_start, ::strnlen(name_start, event.len) };
+
+            auto directory = m_directories.find(event.wd);
+            if (m_directories.end() == directory) {
+                continue;
+            }
+            auto file = directory->second.files.find(name);
+            if (directory->second.files.end() == file) {
+                continue;
+            }
+            for (auto&& path : file->second) {
+                if (std::ranges::find(changed, path) == changed.end()) {
+                    changed.push_back(path);
+                }
+            }
+        }
+    }
+
+    return changed;
+}
+
+#else // !defined(__linux__)
+
+namespace
+{
+    constexpr auto PollInterval = std::chrono::milliseconds{ 250 };
+}
+
+mope::file_watcher::file_watcher()
+    : m_files{ }
+    , m_last_poll{ std::chrono::steady_clock::now() }
+{
+}
+
+mope::file_watcher::~file_watcher() = default;
+
+auto mope::file_watcher::watch(std::string const& path) -> bool
+{
+    auto error = std::error_code{};
+    auto time = std::filesystem::last_write_time(path, error);
+    if (error) {
+        return false;
+    }
+    m_files.try_emplace(path, time);
+    return true;
+}
+
+auto mope::file_watcher::poll() -> std::vector<std::string>
+{
+    auto changed = std::vector<std::string>{};
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - m_last_poll < PollInterval) {
+        return changed;
+    }
+    m_last_poll = now;
+
+    for (auto&& [path, last_time] : m_files) {
+        auto error = std::error_code{};
+        auto time = std::filesystem::last_write_time(path, error);
+        if (!error && time != last_time) {
+            last_time = time;
+            changed.push_back(path);
+        }
+    }
+
+    return changed;
+}
+
+#endif // defined(__linux__)
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mope
+{
+    /// Reports when watched files are modified.
+    ///
+    /// On Linux this uses inotify, so polling is a single non-blocking read.
+    /// Directories rather than files are watched, which catches editors that
+    /// save by writing a new file and renaming it over the old one.
+    ///
+    /// Elsewhere, it falls back to comparing modification times, at most a
+    /// few times a second.
+    class file_watcher
+    {
+    public:
+        /// Throws @ref game_engine_error if the OS refuses to watch anything.
+        file_watcher();
+        ~file_watcher();
+
+        file_watcher(file_watcher const&) = delete;
+        auto operator=(file_watcher const&) -> file_watcher& = delete;
+
+        /// Start watching @p path. Returns false if it can't be watched, for
+        /// instance because its directory doesn't exist.
+        auto watch(std::string const& path) -> bool;
+
+        /// Return the watched paths, exactly as they were given to
+        /// @ref watch(), that changed since the last call. Each path is
+        /// reported once, however many times it was written.
+        auto poll() -> std::vector<std::string>;
+
+    private:
+#if defined(__linux__)
+        struct watched_directory
+        {
+            /// File names in the directory, mapped to the paths they were
+            /// watched by.
+            std::unordered_map<std::string, std::vector<std::string>> files;
+        };
+
+        int m_fd;
+        std::unordered_map<int, watched_directory> m_directories;
+#else // !defined(__linux__)
+        std::unordered_map<std::string, std::filesystem::file_time_type> m_files;
+        std::chrono::steady_clock::time_point m_last_poll;
+#endif // defined(__linux__)
+    };
+} // namespace mope
@@ -0,0 +1,400 @@
+#include "flight_recorder.hxx"
+
+#include "mope_game_engine/events/tick.hxx"
+#include "mope_game_engine/game_engine_error.hxx"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#if defined(_WIN32)
+
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+
+#else // !defined(_WIN32)
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#endif // defined(_WIN32)
+
+namespace
+{
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+
+    constexpr auto Signals = std::array{
+        SIGSEGV, SIGABRT, SIGFPE, SIGILL,
+#if !defined(_WIN32)
+        SIGBUS, SIGQUIT,
+#endif // !defined(_WIN32)
+    };
+
+    /// The recorder that installed the signal handlers, if any.
+    auto g_owner = std::atomic<mope::flight_recorder*>{ nullptr };
+
+    /// The recorder that dumps on the next signal: the owner, until it has
+    /// dumped once.
+    auto g_recorder = std::atomic<mope::flight_recorder*>{ nullptr };
+
+#if defined(_WIN32)
+
+    using signal_action = void (*)(int);
+
+#else // !defined(_WIN32)
+
+    using signal_action = struct sigaction;
+
+#endif // defined(_WIN32)
+
+    /// The handlers that were installed before the recorder's, in the same
+    /// order as `Signals`.
+    auto g_previous = std::array<signal_action, Signals.size()>{};
+
+    auto previous_of(int signal) -> signal_action&
+    {
+        auto iter = std::ranges::find(Signals, signal);
+        return g_previous[static_cast<std::size_t>(iter - Signals.begin())];
+    }
+
+#if defined(_WIN32)
+
+    extern "C" void on_fatal_signal(int signal)
+    {
+        if (auto recorder = g_recorder.exchange(nullptr)) {
+            recorder->dump(signal);
+        }
+
+        // Carry on the way we would have without the recorder.
+        auto previous = previous_of(signal);
+        if (SIG_DFL != previous && SIG_IGN != previous) {
+            previous(signal);
+            return;
+        }
+        std::signal(signal, previous);
+        std::raise(signal);
+    }
+
+    void install_handlers()
+    {
+        for (auto i = 0uz; i < Signals.size(); ++i) {
+            g_previous[i] = std::signal(Signals[i], on_fatal_signal);
+        }
+    }
+
+    void restore_handlers()
+    {
+        for (auto i = 0uz; i < Signals.size(); ++i) {
+            std::signal(Signals[i], g_previous[i]);
+        }
+    }
+
+#else // !defined(_WIN32)
+
+    extern "C" void on_fatal_signal(int signal, siginfo_t* info, void* context)
+    {
+        if (auto recorder = g_recorder.exchange(nullptr)) {
+            recorder->dump(signal);
+        }
+
+        // Carry on the way we would have without the recorder.
+        auto& previous = previous_of(signal);
+        if (0 != (previous.sa_flags & SA_SIGINFO)) {
+            previous.sa_sigaction(signal, info, context);
+            return;
+        }
+        if (SIG_DFL != previous.sa_handler && SIG_IGN != previous.sa_handler) {
+            previous.sa_handler(signal);
+            return;
+        }
+        ::sigaction(signal, &previous, nullptr);
+        std::raise(signal);
+    }
+
+    void install_handlers()
+    {
+        auto action = signal_action{};
+        action.sa_sigaction = on_fatal_signal;
+        action.sa_flags = SA_SIGINFO;
+        ::sigemptyset(&action.sa_mask);
+        for (auto i = 0uz; i < Signals.size(); ++i) {
+            ::sigaction(Signals[i], &action, &g_previous[i]);
+        }
+    }
+
+    void restore_handlers()
+    {
+        for (auto i = 0uz; i < Signals.size(); ++i) {
+            ::sigaction(Signals[i], &g_previous[i], nullptr);
+        }
+    }
+
+#endif // defined(_WIN32)
+
+    void copy_keys(std::bitset<256> const& keys, std::uint64_t (&words)[4])
+    {
+        constexpr auto Mask = std::bitset<256>{ ~0ull };
+        for (auto i = 0uz; i < 4; ++i) {
+            words[i] = ((keys >> (64 * i)) & Mask).to_ullong();
+        }
+    }
+
+    auto open_for_dump(char const* path) -> int
+    {
+#if defined(_WIN32)
+        return ::_open(path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else // !defined(_WIN32)
+        return ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif // defined(_WIN32)
+    }
+
+    auto write_all(int fd, void const* data, std::size_t size) -> bool
+    {
+        auto bytes = static_cast<char const*>(data);
+        while (size > 0) {
+#if defined(_WIN32)
+            auto written = ::_write(fd, bytes, static_cast<unsigned int>(size));
+#else // !defined(_WIN32)
+            auto written = ::write(fd, bytes, size);
+#endif // defined(_WIN32)
+            if (written <= 0) {
+                return false;
+            }
+            bytes += written;
+            size -= static_cast<std::size_t>(written);
+        }
+        return true;
+    }
+
+    void close_dump(int fd)
+    {
+#if defined(_WIN32)
+        ::_close(fd);
+#else // !defined(_WIN32)
+        ::close(fd);
+#endif // defined(_WIN32)
+    }
+}
+
+mope::flight_recorder::flight_recorder(std::size_t capacity, std::string const& path)
+    : m_records{ std::make_unique<flight_record[]>(std::max(capacity, 1uz) + 1) }
+    , m_capacity{ std::max(capacity, 1uz) + 1 }
+    , m_written{ 0 }
+    , m_recording{ false }
+    , m_tick_start{ }
+    , m_tick_types{ }
+    , m_names{ std::make_unique<std::array<char, NameSize>[]>(MaxNames) }
+    , m_name_count{ 0 }
+    , m_name_types{ }
+    , m_path{ }
+{
+    if (path.size() >= m_path.size()) {
+        throw game_engine_error{ "Flight recorder path is too long." };
+    }
+    std::ranges::copy(path, m_path.begin());
+    m_name_types.reserve(MaxNames);
+
+    auto expected = static_cast<flight_recorder*>(nullptr);
+    if (g_owner.compare_exchange_strong(expected, this)) {
+        install_handlers();
+        g_recorder.store(this);
+    }
+}
+
+mope::flight_recorder::~flight_recorder()
+{
+    auto expected = this;
+    if (g_owner.compare_exchange_strong(expected, nullptr)) {
+        g_recorder.store(nullptr);
+        restore_handlers();
+    }
+}
+
+void mope::flight_recorder::begin_tick(std::uint32_t scene, double time_step, input_state const& inputs)
+{
+    auto written = m_written.load(std::memory_order_relaxed);
+    auto& record = m_records[written % m_capacity];
+
+    record.sequence = written;
+    record.scene = scene;
+    record.event_type_count = 0;
+    record.time_step = time_step;
+    record.tick_ns = 0;
+    record.entities_created = 0;
+    record.entities_dormant = 0;
+    record.components = 0;
+    copy_keys(inputs.pressed_keys, record.pressed_keys);
+    copy_keys(inputs.released_keys, record.released_keys);
+    copy_keys(inputs.held_keys, record.held_keys);
+    record.cursor_position[0] = inputs.cursor_position.x();
+    record.cursor_position[1] = inputs.cursor_position.y();
+    record.cursor_deltas[0] = inputs.cursor_deltas.x();
+    record.cursor_deltas[1] = inputs.cursor_deltas.y();
+    record.client_size[0] = inputs.client_size.x();
+    record.client_size[1] = inputs.client_size.y();
+
+    m_recording.store(true, std::memory_order_relaxed);
+    m_tick_start = clock::now();
+}
+
+void mope::flight_recorder::record_event(std::type_info const& type, std::uint64_t handler_ns)
+{
+    // Events can be pushed outside of a tick, e.g. from on_load(), but only
+    // ticks are recorded.
+    if (!m_recording.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    auto& record = m_records[m_written.load(std::memory_order_relaxed) % m_capacity];
+    auto count = static_cast<std::size_t>(record.event_type_count);
+
+    auto i = 0uz;
+    while (i < count && *m_tick_types[i] != type) {
+        ++i;
+    }
+
+    if (i == count) {
+        // The last slot is shared by whatever doesn't fit.
+        if (count == flight_record::MaxEventTypes) {
+            i = count - 1;
+            record.events[i].type = flight_record_event::OtherEvents;
+        }
+        else {
+            m_tick_types[i] = &type;
+            record.events[i] = { name_index(type), 0, 0 };
+            ++record.event_type_count;
+        }
+    }
+
+    ++record.events[i].count;
+    record.events[i].handler_ns += handler_ns;
+}
+
+void mope::flight_recorder::end_tick(std::uint64_t entities_created, std::uint64_t entities_dormant, std::uint64_t components)
+{
+    auto written = m_written.load(std::memory_order_relaxed);
+    auto& record = m_records[written % m_capacity];
+
+    record.tick_ns = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - m_tick_start).count()
+    );
+    record.entities_created = entities_created;
+    record.entities_dormant = entities_dormant;
+    record.components = components;
+
+    m_recording.store(false, std::memory_order_relaxed);
+    m_written.store(written + 1, std::memory_order_release);
+}
+
+auto mope::flight_recorder::dump(int reason) noexcept -> bool
+{
+    auto fd = open_for_dump(m_path.data());
+    if (fd < 0) {
+        return false;
+    }
+
+    // The slot being written (if any) is the oldest one once the ring has
+    // wrapped, so it's left out of the complete records; that's the slot
+    // the ring has beyond the capacity asked for.
+    auto written = m_written.load(std::memory_order_acquire);
+    auto in_progress = m_recording.load(std::memory_order_relaxed);
+    auto complete = std::min<std::uint64_t>(written, m_capacity - 1);
+    auto name_count = m_name_count.load(std::memory_order_acquire);
+
+    auto header = flight_recording_header{
+        .magic = flight_recording_header::Magic,
+        .record_size = sizeof(flight_record),
+        .name_size = NameSize,
+        .name_count = name_count,
+        .record_count = static_cast<std::uint32_t>(complete),
+        .in_progress = in_progress ? 1u : 0u,
+        .reason = reason,
+    };
+
+    auto ok = write_all(fd, &header, sizeof(header))
+        && write_all(fd, m_names.get(), name_count * NameSize);
+
+    // Oldest first, in at most two runs of the ring.
+    auto first = (written - complete) % m_capacity;
+    auto head = std::min<std::uint64_t>(complete, m_capacity - first);
+    ok = ok
+        && write_all(fd, &m_records[first], head * sizeof(flight_record))
+        && write_all(fd, &m_records[0], (complete - head) * sizeof(flight_record));
+
+    if (in_progress) {
+        ok = ok && write_all(fd, &m_records[written % m_capacity], sizeof(flight_record));
+    }
+
+    close_dump(fd);
+    return ok;
+}
+
+auto mope::flight_recorder::name_index(std::type_info const& type) -> std::uint32_t
+{
+    for (auto i = 0uz; i < m_name_types.size(); ++i) {
+        if (*m_name_types[i] == type) {
+            return static_cast<std::uint32_t>(i);
+        }
+    }
+
+    if (m_name_types.size() == MaxNames) {
+        return flight_record_event::OtherEvents;
+    }
+
+    // Fill in the name before publishing it.
+    auto& name = m_names[m_name_types.size()];
+    name.fill('\0');
+    std::strncpy(name.data(), type.name(), NameSize - 1);
+    m_name_types.push_back(&type);
+    m_name_count.store(static_cast<std::uint32_t>(m_name_types.size()), std::memory_order_release);
+    return static_cast<std::uint32_t>(m_name_types.size() - 1);
+}
+
+auto mope::read_flight_recording(char const* path) -> flight_recording
+{
+    auto file = std::ifstream{ path, std::ios::binary };
+    if (!file) {
+        throw game_engine_error{ "Failed to open \"" + std::string{ path } + "\"." };
+    }
+
+    auto read = [&file, path](void* data, std::size_t size)
+        {
+            if (!file.read(static_cast<char*>(data), static_cast<std::streamsize>(size))) {
+                throw game_engine_error{ "\"" + std::string{ path } + "\" is truncated." };
+            }
+        };
+
+    auto recording = flight_recording{};
+    read(&recording.header, sizeof(recording.header));
+    auto const& header = recording.header;
+    if (flight_recording_header::Magic != header.magic
+        || sizeof(flight_record) != header.record_size
+        || flight_recorder::NameSize != header.name_size)
+    {
+        throw game_engine_error{ "\"" + std::string{ path } + "\" isn't a flight recording from this version." };
+    }
+
+    auto name = std::array<char, flight_recorder::NameSize>{};
+    for (auto i = 0u; i < header.name_count; ++i) {
+        read(name.data(), name.size());
+        name.back() = '\0';
+        recording.names.emplace_back(name.data());
+    }
+
+    recording.records.resize(header.record_count + (header.in_progress ? 1 : 0));
+    read(recording.records.data(), recording.records.size() * sizeof(flight_record));
+    return recording;
+}
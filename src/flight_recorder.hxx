@@ -0,0 +1,160 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace mope
+{
+    struct input_state;
+
+    /// How many times an event type was handled during a tick, and how long
+    /// its handlers took altogether.
+    struct flight_record_event
+    {
+        /// Index into the recording's names, or @ref OtherEvents for the
+        /// events of every type that didn't fit in the record.
+        std::uint32_t type;
+        std::uint32_t count;
+        std::uint64_t handler_ns;
+
+        static constexpr auto OtherEvents = std::uint32_t{ 0xffffffff };
+    };
+
+    /// One tick of one scene, as kept by the @ref flight_recorder and written
+    /// to its dumps as is.
+    struct flight_record
+    {
+        static constexpr auto MaxEventTypes = 16uz;
+
+        std::uint64_t sequence;         ///< Counts ticks of every scene.
+        std::uint32_t scene;            ///< The order in which the scene was loaded.
+        std::uint32_t event_type_count; ///< How many of `events` are used.
+        double time_step;
+        std::uint64_t tick_ns;          ///< Wall time for the whole tick.
+        std::uint64_t entities_created;
+        std::uint64_t entities_dormant;
+        std::uint64_t components;
+        std::uint64_t pressed_keys[4];
+        std::uint64_t released_keys[4];
+        std::uint64_t held_keys[4];
+        float cursor_position[2];
+        float cursor_deltas[2];
+        std::int32_t client_size[2];
+        flight_record_event events[MaxEventTypes];
+    };
+
+    /// The start of a flight recorder dump. Everything is in the byte order
+    /// of the machine that wrote it.
+    ///
+    /// The header is followed by `name_count` event type names of
+    /// `name_size` bytes each (null-padded), then `record_count` complete
+    /// records, oldest first, and then, if `in_progress` is set, the record
+    /// of the tick that was running, which may be torn.
+    struct flight_recording_header
+    {
+        static constexpr auto Magic = std::array<char, 8>{ 'M', 'O', 'P', 'E', 'F', 'L', 'T', '1' };
+
+        std::array<char, 8> magic;
+        std::uint32_t record_size;
+        std::uint32_t name_size;
+        std::uint32_t name_count;
+        std::uint32_t record_count;
+        std::uint32_t in_progress;
+
+        /// The signal that caused the dump, or 0 for an exception.
+        std::int32_t reason;
+    };
+
+    /// A dump, as read back by @ref read_flight_recording.
+    struct flight_recording
+    {
+        flight_recording_header header;
+        std::vector<std::string> names;
+        std::vector<flight_record> records;
+    };
+
+    /// Throws @ref game_engine_error if @p path isn't a flight recorder dump
+    /// written by this version of the engine.
+    auto read_flight_recording(char const* path) -> flight_recording;
+
+    /// Keeps what happened during the last few ticks, to be written to a file
+    /// if the game crashes.
+    ///
+    /// Each tick of each scene fills one fixed-size @ref flight_record in a
+    /// ring, so recording never allocates. The ring has a single writer, the
+    /// thread that ticks the scenes, and publishes each record with an atomic
+    /// counter once it's complete. So @ref dump() can be called from a signal
+    /// handler that interrupts the writer: it only uses async-signal-safe
+    /// calls, and sees every record but the one being written as it was
+    /// finished.
+    ///
+    /// While it exists, the recorder dumps on SIGSEGV, SIGABRT, SIGFPE and
+    /// SIGILL, and on POSIX also SIGBUS and SIGQUIT, so that a hung game can
+    /// be dumped with `kill -QUIT`. It then passes the signal on to the
+    /// handler that was installed before it, or re-raises it with that
+    /// disposition, and puts those handlers back when it is destroyed. Only
+    /// one recorder handles signals at a time.
+    class flight_recorder
+    {
+    public:
+        static constexpr auto NameSize = 128uz;
+        static constexpr auto MaxNames = 256uz;
+
+        /// @param capacity How many ticks to keep.
+        /// @param path Where to write dumps.
+        flight_recorder(std::size_t capacity, std::string const& path);
+        ~flight_recorder();
+
+        flight_recorder(flight_recorder const&) = delete;
+        auto operator=(flight_recorder const&) -> flight_recorder& = delete;
+
+        void begin_tick(std::uint32_t scene, double time_step, input_state const& inputs);
+
+        /// Count an event of the given type, whose handlers took `handler_ns`.
+        void record_event(std::type_info const& type, std::uint64_t handler_ns);
+
+        void end_tick(std::uint64_t entities_created, std::uint64_t entities_dormant, std::uint64_t components);
+
+        /// Write the ring to the file. Async-signal-safe.
+        ///
+        /// @param reason The signal being handled, or 0.
+        /// @return Whether the whole dump was written.
+        auto dump(int reason) noexcept -> bool;
+
+    private:
+        using clock = std::chrono::steady_clock;
+
+        auto name_index(std::type_info const& type) -> std::uint32_t;
+
+        std::unique_ptr<flight_record[]> m_records;
+
+        /// How many records the ring holds: one more than the ticks to keep,
+        /// for the one being written.
+        std::size_t m_capacity;
+
+        /// How many records are complete. The one being written is at this
+        /// index, modulo the capacity.
+        std::atomic<std::uint64_t> m_written;
+        std::atomic<bool> m_recording;
+        clock::time_point m_tick_start;
+
+        /// The types of the events of the record being written, in the same
+        /// order, so that event types can be matched without hashing.
+        std::array<std::type_info const*, flight_record::MaxEventTypes> m_tick_types;
+
+        std::unique_ptr<std::array<char, NameSize>[]> m_names;
+        std::atomic<std::uint32_t> m_name_count;
+        std::vector<std::type_info const*> m_name_types;
+
+        /// Null-terminated; kept as an array so that dumping needn't touch
+        /// the heap.
+        std::array<char, 4096> m_path;
+    };
+} // namespace mope
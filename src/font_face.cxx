@@ -0,0 +1,159 @@
+#include "font_face.hxx"
+
+#include "freetype.hxx"
+#include "mope_game_engine/font.hxx"
+#include "mope_game_engine/texture.hxx"
+#include "mope_vec/mope_vec.hxx"
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <string>
+#include <utility>
+
+mope::detail::font_face::font_face(FT_Face face, std::string path, FT_Long face_id)
+    : face{ face }
+    , path{ std::move(path) }
+    , face_id{ face_id }
+    , m_pending{ }
+    , m_library_mutex{ nullptr }
+    , m_px_size{ 0 }
+    , m_glyphs{ }
+{
+}
+
+mope::detail::font_face::font_face(
+    std::future<FT_Face> pending,
+    std::mutex& library_mutex,
+    std::string path,
+    FT_Long face_id
+)
+    : face{ nullptr }
+    , path{ std::move(path) }
+    , face_id{ face_id }
+    , m_pending{ std::move(pending) }
+    , m_library_mutex{ &library_mutex }
+    , m_px_size{ 0 }
+    , m_glyphs{ }
+{
+}
+
+mope::detail::font_face::~font_face()
+{
+    try {
+        wait();
+    }
+    catch (...) {
+        // The face was never made, so there's nothing to destroy.
+    }
+
+    if (nullptr != face) {
+        auto lock = nullptr != m_library_mutex
+            ? std::unique_lock{ *m_library_mutex }
+            : std::unique_lock<std::mutex>{ };
+        FT_Done_Face(face);
+    }
+}
+
+void mope::detail::font_face::wait()
+{
+    if (!m_pending.valid()) {
+        return;
+    }
+
+    face = m_pending.get();
+    if (0 != m_px_size) {
+        set_px(m_px_size);
+    }
+}
+
+void mope::detail::font_face::set_px(unsigned int px_size)
+{
+    if (!m_pending.valid()) {
+        check_ft_error(
+            FT_Set_Pixel_Sizes(face, px_size, 0),
+            "setting glyph size"
+        );
+    }
+    m_px_size = px_size;
+}
+
+auto mope::detail::font_face::get_glyph(unsigned long character_code) -> glyph const&
+{
+    wait();
+    auto key = (glyph_key{ m_px_size } << 32) | static_cast<std::uint32_t>(character_code);
+    auto [iter, inserted] = m_glyphs.try_emplace(key);
+    if (inserted) {
+        try {
+            rasterize(key, iter->second);
+        }
+        catch (...) {
+            m_glyphs.erase(iter);
+            throw;
+        }
+    }
+    return iter->second;
+}
+
+void mope::detail::font_face::replace(FT_Face new_face)
+{
+    wait();
+    FT_Done_Face(face);
+    face = new_face;
+
+    for (auto&& [key, cached] : m_glyphs) {
+        rasterize(key, cached);
+    }
+
+    if (0 != m_px_size) {
+        set_px(m_px_size);
+    }
+}
+
+void mope::detail::font_face::rasterize(glyph_key key, glyph& into)
+{
+    auto px_size = static_cast<unsigned int>(key >> 32);
+    auto character_code = static_cast<unsigned long>(key & 0xffffffff);
+
+    if (0 != px_size) {
+        check_ft_error(
+            FT_Set_Pixel_Sizes(face, px_size, 0),
+            "setting glyph size"
+        );
+    }
+    check_ft_error(
+        FT_Load_Char(face, character_code, FT_LOAD_RENDER),
+        "loading character and rendering glyph"
+    );
+
+    auto buffer = reinterpret_cast<std::byte const*>(face->glyph->bitmap.buffer);
+    auto size = vec2i{ vec2ui{ face->glyph->bitmap.width , face->glyph->bitmap.rows } };
+
+    into.size = size;
+    into.advance = vec2i{
+        static_cast<int>(face->glyph->advance.x) >> 6,
+        static_cast<int>(face->glyph->advance.y) >> 6
+    };
+    into.bearing = vec2i{
+        face->glyph->bitmap_left, face->glyph->bitmap_top - size.y()
+    };
+
+    // Remaking the texture keeps its name, so copies of it see the new glyph.
+    into.texture
+        .make(
+            buffer,
+            size,
+            mope::gl::pixel_format::r,
+            gl::texture_extra_options{
+                // Glyphs are drawn at the size they were rasterized at, so
+                // mipmaps would only be generated to go unused.
+                .row_alignment = 1,
+                .min_filter = gl::texture_min_filter::linear,
+            })
+        .swizzle({
+            gl::color_component::one,
+            gl::color_component::one,
+            gl::color_component::one,
+            gl::color_component::red });
+}
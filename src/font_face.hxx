@@ -0,0 +1,67 @@
+#pragma once
+
+#include "freetype.hxx"
+#include "mope_game_engine/font.hxx"
+
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace mope::detail
+{
+    /// The state behind a @ref font, shared by all of its copies.
+    ///
+    /// Glyphs are rasterized once per pixel size and cached. Because every
+    /// copy of a @ref gl::texture refers to the same texture, the cache can be
+    /// re-rasterized in place when the font file changes, and sprites that
+    /// show those glyphs pick up the change without being touched.
+    struct font_face
+    {
+        /// Takes ownership of @p face. @p path is empty if the face didn't
+        /// come from a loose file, in which case it is never reloaded.
+        font_face(FT_Face face, std::string path, FT_Long face_id);
+
+        /// Takes ownership of the face that @p pending delivers, which is
+        /// being made on another thread while holding @p library_mutex. It is
+        /// waited for when it is first needed, q.v. @ref wait.
+        font_face(std::future<FT_Face> pending, std::mutex& library_mutex, std::string path, FT_Long face_id);
+        ~font_face();
+
+        font_face(font_face const&) = delete;
+        auto operator=(font_face const&) -> font_face& = delete;
+
+        /// Wait for a face that is being made on another thread, and throw
+        /// if making it failed. Returns at once if the face is ready.
+        void wait();
+
+        /// If the face isn't ready yet, the size is applied once it is.
+        void set_px(unsigned int px_size);
+        auto get_glyph(unsigned long character_code) -> glyph const&;
+
+        /// Swap in a new FreeType face for the same font, and re-rasterize
+        /// every cached glyph into its existing texture.
+        void replace(FT_Face new_face);
+
+        /// Null until @ref wait returns, if the face is made on another
+        /// thread.
+        FT_Face face;
+        std::string path;
+        FT_Long face_id;
+
+    private:
+        /// Pixel size in the high half, character code in the low half.
+        using glyph_key = std::uint64_t;
+
+        void rasterize(glyph_key key, glyph& into);
+
+        std::future<FT_Face> m_pending;
+
+        /// Held around destroying the face, if it was made on another
+        /// thread, since FreeType can't make and destroy faces at once.
+        std::mutex* m_library_mutex;
+        unsigned int m_px_size;
+        std::unordered_map<glyph_key, glyph> m_glyphs;
+    };
+} // namespace mope::detail
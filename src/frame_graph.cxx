@@ -0,0 +1,376 @@
+#include "mope_game_engine/frame_graph.hxx"
+
+#include "framebuffer.hxx"
+#include "mope_game_engine/game_engine_error.hxx"
+#include "mope_game_engine/texture.hxx"
+#include "mope_vec/mope_vec.hxx"
+#include "glad/glad.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    auto same_desc(mope::render_target_desc const& a, mope::render_target_desc const& b) -> bool
+    {
+        return a.size.x() == b.size.x()
+            && a.size.y() == b.size.y()
+            && a.format == b.format
+            && a.depth == b.depth;
+    }
+}
+
+mope::frame_graph::pass_builder::pass_builder(frame_graph& graph, std::size_t pass)
+    : m_graph{ graph }
+    , m_pass{ pass }
+{
+}
+
+auto mope::frame_graph::pass_builder::create(render_target_desc const& desc) -> render_target_handle
+{
+    m_graph.m_targets.push_back({ desc, -1 });
+    return { static_cast<std::uint32_t>(m_graph.m_targets.size() - 1) };
+}
+
+void mope::frame_graph::pass_builder::read(render_target_handle target)
+{
+    auto& pass = m_graph.m_passes[m_pass];
+    if (target.index >= m_graph.m_targets.size()) {
+        throw game_engine_error{ "Pass \"" + std::string{ pass.name } + "\" reads an unknown render target." };
+    }
+    if (0 == target.index) {
+        throw game_engine_error{ "Pass \"" + std::string{ pass.name } + "\" reads the window." };
+    }
+    if (target.index == pass.write) {
+        throw game_engine_error{ "Pass \"" + std::string{ pass.name } + "\" reads the target it writes." };
+    }
+    if (std::ranges::find(pass.reads, target.index) == pass.reads.end()) {
+        pass.reads.push_back(target.index);
+    }
+}
+
+void mope::frame_graph::pass_builder::write(render_target_handle target)
+{
+    auto& pass = m_graph.m_passes[m_pass];
+    if (target.index >= m_graph.m_targets.size()) {
+        throw game_engine_error{ "Pass \"" + std::string{ pass.name } + "\" writes an unknown render target." };
+    }
+    if (NoTarget != pass.write && target.index != pass.write) {
+        throw game_engine_error{ "Pass \"" + std::string{ pass.name } + "\" writes more than one target." };
+    }
+    if (std::ranges::find(pass.reads, target.index) != pass.reads.end()) {
+        throw game_engine_error{ "Pass \"" + std::string{ pass.name } + "\" reads the target it writes." };
+    }
+    pass.write = target.index;
+}
+
+void mope::frame_graph::pass_builder::keep()
+{
+    m_graph.m_passes[m_pass].keep = true;
+}
+
+mope::frame_graph::pass_context::pass_context(frame_graph const& graph, std::size_t pass, vec2i size)
+    : m_graph{ graph }
+    , m_pass{ pass }
+    , m_size{ size }
+{
+}
+
+auto mope::frame_graph::pass_context::texture(render_target_handle target) const -> gl::texture const&
+{
+    auto const& pass = m_graph.m_passes[m_pass];
+    if (std::ranges::find(pass.reads, target.index) == pass.reads.end()) {
+        throw game_engine_error{ "Pass \"" + std::string{ pass.name } + "\" didn't declare that it reads a target." };
+    }
+    auto framebuffer = m_graph.m_framebuffers[static_cast<std::size_t>(m_graph.m_targets[target.index].framebuffer)];
+    return m_graph.m_pool[framebuffer].framebuffer->color();
+}
+
+auto mope::frame_graph::pass_context::size() const -> vec2i
+{
+    return m_size;
+}
+
+mope::frame_graph::frame_graph()
+    : m_passes{ }
+    , m_targets{ }
+    , m_order{ }
+    , m_framebuffer_descs{ }
+    , m_pool{ }
+    , m_framebuffers{ }
+    , m_stats{ }
+{
+    reset();
+}
+
+mope::frame_graph::~frame_graph() = default;
+
+auto mope::frame_graph::backbuffer() const -> render_target_handle
+{
+    return { 0 };
+}
+
+auto mope::frame_graph::begin_pass(char const* name, execute_function execute) -> pass_builder
+{
+    m_passes.push_back({ name, std::move(execute), { }, NoTarget, false, false });
+    return pass_builder{ *this, m_passes.size() - 1 };
+}
+
+auto mope::frame_graph::depends_on(std::size_t pass, std::size_t other) const -> bool
+{
+    auto const& a = m_passes[pass];
+    auto const& b = m_passes[other];
+    if (pass == other || NoTarget == b.write) {
+        return false;
+    }
+
+    // Read after write, or two writes, which keep the order they were added.
+    return std::ranges::find(a.reads, b.write) != a.reads.end()
+        || (b.write == a.write && other < pass);
+}
+
+void mope::frame_graph::cull()
+{
+    // Start from the passes that reach the window (or are kept regardless),
+    // and walk back through the passes that write what they read. Graphs
+    // have a handful of passes, so the quadratic walk is fine.
+    auto pending = std::vector<std::size_t>{};
+    for (auto i = 0uz; i < m_passes.size(); ++i) {
+        auto& pass = m_passes[i];
+        pass.culled = !(pass.keep || 0 == pass.write);
+        if (!pass.culled) {
+            pending.push_back(i);
+        }
+    }
+
+    while (!pending.empty()) {
+        auto needed = pending.back();
+        pending.pop_back();
+        for (auto i = 0uz; i < m_passes.size(); ++i) {
+            if (m_passes[i].culled && depends_on(needed, i)) {
+                m_passes[i].culled = false;
+                pending.push_back(i);
+            }
+        }
+    }
+}
+
+void mope::frame_graph::sort()
+{
+    // Each step runs the earliest added pass whose dependencies have all
+    // run, so that passes with no say in the matter keep the order they
+    // were added in.
+    auto scheduled = std::vector<bool>(m_passes.size(), false);
+    auto remaining = static_cast<std::size_t>(std::ranges::count(m_passes, false, &pass::culled));
+    while (m_order.size() < remaining) {
+        auto next = m_passes.size();
+        for (auto i = 0uz; i < m_passes.size() && next == m_passes.size(); ++i) {
+            if (m_passes[i].culled || scheduled[i]) {
+                continue;
+            }
+
+            auto ready = true;
+            for (auto j = 0uz; j < m_passes.size() && ready; ++j) {
+                ready = m_passes[j].culled || scheduled[j] || !depends_on(i, j);
+            }
+            if (ready) {
+                next = i;
+            }
+        }
+
+        if (next == m_passes.size()) {
+            auto stuck = 0uz;
+            while (m_passes[stuck].culled || scheduled[stuck]) {
+                ++stuck;
+            }
+            throw game_engine_error{
+                "Render passes depend on each other in a cycle, through \""
+                    + std::string{ m_passes[stuck].name } + "\"."
+            };
+        }
+
+        scheduled[next] = true;
+        m_order.push_back(next);
+    }
+}
+
+void mope::frame_graph::assign_framebuffers()
+{
+    // Find the first and last step at which each target is used. Once the
+    // last pass to use a target has run, its framebuffer can be given to
+    // another.
+    auto last_use = std::vector<std::size_t>(m_targets.size(), 0);
+    auto first_use = std::vector<std::size_t>(m_targets.size(), m_order.size());
+    for (auto step = 0uz; step < m_order.size(); ++step) {
+        auto const& pass = m_passes[m_order[step]];
+        auto use = [&](std::uint32_t target)
+            {
+                first_use[target] = std::min(first_use[target], step);
+                last_use[target] = step;
+            };
+        std::ranges::for_each(pass.reads, use);
+        if (NoTarget != pass.write) {
+            use(pass.write);
+        }
+    }
+
+    auto free_after = std::vector<std::size_t>{};
+    for (auto step = 0uz; step < m_order.size(); ++step) {
+        for (auto target = 1uz; target < m_targets.size(); ++target) {
+            if (first_use[target] != step) {
+                continue;
+            }
+
+            auto& desc = m_targets[target].desc;
+            auto framebuffer = 0uz;
+            while (framebuffer < m_framebuffer_descs.size()
+                && !(free_after[framebuffer] < step && same_desc(m_framebuffer_descs[framebuffer], desc)))
+            {
+                ++framebuffer;
+            }
+            if (framebuffer == m_framebuffer_descs.size()) {
+                m_framebuffer_descs.push_back(desc);
+                free_after.push_back(0);
+            }
+
+            free_after[framebuffer] = last_use[target];
+            m_targets[target].framebuffer = static_cast<int>(framebuffer);
+            ++m_stats.transient_targets;
+        }
+    }
+    m_stats.framebuffers = m_framebuffer_descs.size();
+}
+
+void mope::frame_graph::compile()
+{
+    m_order.clear();
+    m_framebuffer_descs.clear();
+    for (auto& target : m_targets) {
+        target.framebuffer = -1;
+    }
+
+    cull();
+    sort();
+
+    m_stats = frame_graph_stats{
+        .passes = m_passes.size(),
+        .culled_passes = m_passes.size() - m_order.size(),
+        .transient_targets = 0,
+        .framebuffers = 0,
+    };
+    assign_framebuffers();
+}
+
+void mope::frame_graph::execute(vec2i window_size)
+{
+    // Match this frame's framebuffers to those kept from earlier frames, and
+    // make any that are missing. Any left over are no longer needed.
+    auto claimed = std::vector<bool>(m_pool.size(), false);
+    m_framebuffers.clear();
+    for (auto const& desc : m_framebuffer_descs) {
+        auto size = 0 == desc.size.x() && 0 == desc.size.y() ? window_size : desc.size;
+        auto match = std::ranges::find_if(m_pool, [&](pooled_framebuffer const& pooled)
+            {
+                return !claimed[static_cast<std::size_t>(&pooled - m_pool.data())]
+                    && pooled.size.x() == size.x()
+                    && pooled.size.y() == size.y()
+                    && pooled.format == desc.format
+                    && pooled.depth == desc.depth;
+            });
+        if (m_pool.end() == match) {
+            m_pool.push_back({
+                size,
+                desc.format,
+                desc.depth,
+                std::make_unique<gl::framebuffer>(size, desc.format, desc.depth),
+            });
+            claimed.push_back(false);
+            match = m_pool.end() - 1;
+        }
+
+        auto index = static_cast<std::size_t>(match - m_pool.begin());
+        claimed[index] = true;
+        m_framebuffers.push_back(index);
+    }
+
+    if (std::ranges::find(claimed, false) != claimed.end()) {
+        auto kept = std::vector<pooled_framebuffer>{};
+        kept.reserve(m_framebuffers.size());
+        for (auto& index : m_framebuffers) {
+            kept.push_back(std::move(m_pool[index]));
+            index = kept.size() - 1;
+        }
+        m_pool = std::move(kept);
+    }
+
+    // The window may have set a viewport of its own, e.g. to letterbox.
+    auto viewport = std::array<GLint, 4>{};
+    ::glGetIntegerv(GL_VIEWPORT, viewport.data());
+
+    for (auto index : m_order) {
+        auto const& pass = m_passes[index];
+        auto size = window_size;
+        if (NoTarget == pass.write || 0 == pass.write) {
+            gl::framebuffer::bind_default();
+            ::glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+        }
+        else {
+            auto& framebuffer = *m_pool[m_framebuffers[static_cast<std::size_t>(m_targets[pass.write].framebuffer)]]
+                .framebuffer;
+            framebuffer.bind();
+            size = framebuffer.size();
+            ::glViewport(0, 0, size.x(), size.y());
+        }
+
+        if (pass.execute) {
+            pass.execute(pass_context{ *this, index, size });
+        }
+    }
+
+    gl::framebuffer::bind_default();
+    ::glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+}
+
+void mope::frame_graph::reset()
+{
+    m_passes.clear();
+    m_targets.clear();
+    m_order.clear();
+    m_framebuffer_descs.clear();
+
+    // The window is target 0.
+    m_targets.push_back({ render_target_desc{ }, -1 });
+}
+
+void mope::frame_graph::release()
+{
+    reset();
+    m_pool.clear();
+    m_framebuffers.clear();
+}
+
+auto mope::frame_graph::order() const -> std::vector<char const*>
+{
+    auto names = std::vector<char const*>{};
+    names.reserve(m_order.size());
+    for (auto index : m_order) {
+        names.push_back(m_passes[index].name);
+    }
+    return names;
+}
+
+auto mope::frame_graph::framebuffer_of(render_target_handle target) const -> int
+{
+    return target.index < m_targets.size() ? m_targets[target.index].framebuffer : -1;
+}
+
+auto mope::frame_graph::stats() const -> frame_graph_stats
+{
+    return m_stats;
+}
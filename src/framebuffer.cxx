@@ -0,0 +1,78 @@
+#include "framebuffer.hxx"
+
+#include "mope_game_engine/game_engine_error.hxx"
+#include "mope_game_engine/resource_id.hxx"
+#include "mope_game_engine/texture.hxx"
+#include "mope_vec/mope_vec.hxx"
+#include "glad/glad.h"
+
+#include <string>
+
+mope::gl::framebuffer::framebuffer(vec2i size, pixel_format format, bool depth)
+    : m_id{ }
+    , m_depth{ }
+    , m_color{ }
+    , m_size{ size }
+{
+    if (is_compressed(format)) {
+        throw game_engine_error{ "Can't render to a compressed format." };
+    }
+
+    // Render targets are drawn at the size they're sampled at, so they have
+    // no use for mipmaps.
+    m_color.make(nullptr, size, format, {
+        .min_filter = texture_min_filter::linear,
+    });
+
+    auto id = GLuint{};
+    ::glGenFramebuffers(1, &id);
+    m_id = resource_id{
+        id,
+        [](GLuint id) {
+            ::glDeleteFramebuffers(1, &id);
+        }
+    };
+    bind();
+    ::glFramebufferTexture2D(
+        GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, static_cast<GLuint>(m_color.m_id), 0);
+
+    if (depth) {
+        auto depth_id = GLuint{};
+        ::glGenRenderbuffers(1, &depth_id);
+        m_depth = resource_id{
+            depth_id,
+            [](GLuint id) {
+                ::glDeleteRenderbuffers(1, &id);
+            }
+        };
+        ::glBindRenderbuffer(GL_RENDERBUFFER, m_depth);
+        ::glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, size.x(), size.y());
+        ::glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depth);
+    }
+
+    auto status = ::glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    bind_default();
+    if (GL_FRAMEBUFFER_COMPLETE != status) {
+        throw game_engine_error{ "Incomplete framebuffer: " + std::to_string(status) };
+    }
+}
+
+void mope::gl::framebuffer::bind()
+{
+    ::glBindFramebuffer(GL_FRAMEBUFFER, m_id);
+}
+
+void mope::gl::framebuffer::bind_default()
+{
+    ::glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+auto mope::gl::framebuffer::color() const -> texture const&
+{
+    return m_color;
+}
+
+auto mope::gl::framebuffer::size() const -> vec2i
+{
+    return m_size;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "mope_game_engine/resource_id.hxx"
+#include "mope_game_engine/texture.hxx"
+#include "mope_vec/mope_vec.hxx"
+
+namespace mope::gl
+{
+    /// A framebuffer object with one color texture and, optionally, a depth
+    /// buffer, for drawing somewhere other than the window.
+    class framebuffer
+    {
+    public:
+        /// Throws @ref game_engine_error if @p format is compressed, or the
+        /// driver can't draw to the result.
+        framebuffer(vec2i size, pixel_format format, bool depth);
+
+        /// Draw to this framebuffer from now on.
+        void bind();
+
+        /// Draw to the window from now on.
+        static void bind_default();
+
+        /// What was drawn, to be sampled. Its pixels start out undefined.
+        auto color() const -> texture const&;
+        auto size() const -> vec2i;
+
+    private:
+        resource_id m_id;
+        resource_id m_depth;
+        texture m_color;
+        vec2i m_size;
+    };
+} // namespace mope::gl
@@ -1,26 +1,47 @@
 #include "mope_game_engine/game_engine.hxx"
 
+#include "asset_archive.hxx"
+#include "asset_manager.hxx"
+#include "file_watcher.hxx"
+#include "flight_recorder.hxx"
+#include "font_face.hxx"
 #include "freetype.hxx"
 #include "glad/glad.h"
+#include "init_tracer.hxx"
+#include "job_system.hxx"
+#include "mope_game_engine/components/engine_stats.hxx"
 #include "mope_game_engine/components/logger.hxx"
 #include "mope_game_engine/events/tick.hxx"
 #include "mope_game_engine/font.hxx"
+#include "mope_game_engine/frame_graph.hxx"
 #include "mope_game_engine/game_engine_error.hxx"
 #include "mope_game_engine/game_scene.hxx"
 #include "mope_game_engine/game_window.hxx"
+#include "mope_game_engine/image.hxx"
 #include "mope_game_engine/resource_id.hxx"
 #include "mope_game_engine/texture.hxx"
 #include "mope_vec/mope_vec.hxx"
+#include "perf_counters.hxx"
+#include "shader.hxx"
+#include "sprite_renderer.hxx"
+#include "upload_worker.hxx"
 
 #include <algorithm>
 #include <bitset>
 #include <chrono>
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <future>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <ranges>
 #include <ratio>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -48,21 +69,64 @@ namespace mope
         void add_scene(std::unique_ptr<game_scene> scene) override;
         void run(I_game_window& window, I_logger* logger) override;
         auto make_font(char const* ttf_path, int face_index, int instance_index = 0) -> font override;
+        auto load_image(char const* path, image_options const& options = image_options{})
+            -> std::shared_ptr<image const> override;
+        void mount_archive(char const* path) override;
+        void load_sprite_shader(char const* vert_path, char const* frag_path) override;
+        void set_hot_reload(bool enabled) override;
+        void set_perf_counters(bool enabled) override;
+        void set_flight_recorder(char const* path, std::size_t ticks) override;
         auto get_default_texture() const -> gl::texture const& override;
 
-        void prepare_gl_resources(I_logger* logger);
+        void run_scenes(I_game_window& window, I_logger* logger);
+        void prepare_gl_resources(I_game_window& window, I_logger* logger);
         void release_gl_resources();
         void load_scenes(I_logger* logger);
         void unload_scenes();
         bool keep_alive(I_game_window& window);
         void draw(I_game_window& window, double alpha);
+        auto read_text_asset(std::string const& path) -> std::string;
+        void make_sprite_shader();
+        void start_freetype_init(std::shared_ptr<init_tracer> tracer);
+        void ensure_freetype();
+        auto create_face(asset_manager::packed_asset packed, char const* path, FT_Long face_id) -> FT_Face;
+        void wait_for_fonts();
+        void reload_changed_files(I_logger* logger);
 
         std::vector<std::unique_ptr<game_scene>> m_new_scenes;
         std::vector<std::unique_ptr<game_scene>> m_scenes;
         double m_tick_time;
         input_state m_input_state;
         gl::texture m_default_texture;
+        gl::shader m_sprite_shader;
+        std::string m_sprite_vert_path;
+        std::string m_sprite_frag_path;
         FT_Library m_ft_library;
+        std::shared_future<void> m_ft_init;
+
+        /// Held by jobs that make font faces, since FreeType can't make
+        /// more than one at once.
+        std::mutex m_ft_mutex;
+        std::vector<std::weak_ptr<detail::font_face>> m_fonts;
+
+        /// Set while starting up, until the first frame. Fonts made in the
+        /// meantime are made on the job system, and waited for before the
+        /// first frame.
+        std::shared_ptr<init_tracer> m_init_tracer;
+        std::vector<std::shared_ptr<detail::font_face>> m_pending_fonts;
+        job_system m_jobs;
+        asset_manager m_assets;
+        std::unique_ptr<upload_worker> m_uploads;
+        std::unique_ptr<file_watcher> m_watcher;
+        std::unique_ptr<perf_counters> m_perf_counters;
+        engine_stats m_stats;
+        frame_graph m_frame_graph;
+        std::unique_ptr<flight_recorder> m_flight_recorder;
+        std::string m_flight_recorder_path;
+
+        /// How many scenes have been loaded, which numbers each scene for
+        /// the flight recorder, whether or not one is recording yet.
+        std::uint32_t m_loaded_scenes;
     };
 }
 
@@ -109,6 +173,65 @@ namespace
         bool cleaned_up;
         F f;
     };
+
+    /// Keeps the memory behind a font face loaded from an archive alive for as
+    /// long as the face; q.v. FT_New_Memory_Face.
+    struct packed_font_data
+    {
+        mope::asset_manager::packed_asset packed;
+        std::vector<std::byte> buffer;
+    };
+
+    auto format_counts(mope::perf_counts const& counts, std::uint64_t times) -> std::string
+    {
+        char buffer[192];
+        std::snprintf(
+            buffer,
+            sizeof(buffer),
+            "%10llu x %10.3f ms %14llu cyc %14llu ins %10llu cache-miss %10llu branch-miss %10llu dtlb-miss %6llu faults  ",
+            static_cast<unsigned long long>(times),
+            counts.task_clock_ns / 1e6,
+            static_cast<unsigned long long>(counts.cycles),
+            static_cast<unsigned long long>(counts.instructions),
+            static_cast<unsigned long long>(counts.cache_misses),
+            static_cast<unsigned long long>(counts.branch_misses),
+            static_cast<unsigned long long>(counts.dtlb_misses),
+            static_cast<unsigned long long>(counts.page_faults)
+        );
+        return buffer;
+    }
+
+    void log_engine_stats(mope::I_logger* logger, mope::engine_stats const& stats)
+    {
+        logger->log(
+            mope::perf_counter_source::hardware == stats.source ? "[perf] hardware counters"
+            : mope::perf_counter_source::software == stats.source ? "[perf] software counters only"
+            : "[perf] no counters available",
+            mope::I_logger::log_level::debug
+        );
+        for (auto&& system : stats.systems) {
+            logger->log(
+                ("[perf] " + format_counts(system.counts, system.invocations) + system.system + " <- " + system.event).c_str(),
+                mope::I_logger::log_level::debug
+            );
+        }
+        logger->log(
+            ("[perf] " + format_counts(stats.render, stats.frames) + "render").c_str(),
+            mope::I_logger::log_level::debug
+        );
+
+        char buffer[192];
+        std::snprintf(
+            buffer,
+            sizeof(buffer),
+            "[perf] %llu sprites in %llu draws, %llu instance bytes (%llu as model matrices)",
+            static_cast<unsigned long long>(stats.sprites.sprites),
+            static_cast<unsigned long long>(stats.sprites.draws),
+            static_cast<unsigned long long>(stats.sprites.instance_bytes),
+            static_cast<unsigned long long>(stats.sprites.sprites * sizeof(mope::mat4f))
+        );
+        logger->log(buffer, mope::I_logger::log_level::debug);
+    }
 }
 
 mope::game_engine::game_engine()
@@ -116,12 +239,47 @@ mope::game_engine::game_engine()
     , m_scenes{ }
     , m_tick_time{ 0.0 }
     , m_default_texture{ }
+    , m_sprite_shader{ }
+    , m_sprite_vert_path{ }
+    , m_sprite_frag_path{ }
     , m_ft_library{ nullptr }
+    , m_ft_init{ }
+    , m_ft_mutex{ }
+    , m_fonts{ }
+    , m_init_tracer{ }
+    , m_pending_fonts{ }
+    , m_jobs{ }
+    , m_assets{ m_jobs }
+    , m_uploads{ }
+    , m_watcher{ }
+    , m_perf_counters{ }
+    , m_stats{ }
+    , m_frame_graph{ }
+    , m_flight_recorder{ }
+    , m_flight_recorder_path{ }
+    , m_loaded_scenes{ 0 }
 {
 }
 
 mope::game_engine::~game_engine()
 {
+    if (m_ft_init.valid()) {
+        m_ft_init.wait();
+    }
+
+    // Font jobs still queued on m_jobs make their faces from m_ft_library,
+    // and m_jobs outlives this body; so let them finish, and release what
+    // they made, before the library goes.
+    for (auto&& face : m_pending_fonts) {
+        try {
+            face->wait();
+        }
+        catch (...) {
+            // The face was never made, so there's nothing to release.
+        }
+    }
+    m_pending_fonts.clear();
+
     if (nullptr != m_ft_library) {
         FT_Done_FreeType(m_ft_library);
         m_ft_library = nullptr;
@@ -145,15 +303,52 @@ void mope::game_engine::add_scene(std::unique_ptr<game_scene> scene)
 
 void mope::game_engine::run(I_game_window& window, I_logger* logger)
 {
+    try {
+        run_scenes(window, logger);
+    }
+    catch (...) {
+        if (m_flight_recorder && nullptr != logger) {
+            logger->log(
+                (m_flight_recorder->dump(0)
+                    ? "Wrote the flight recording to \"" + m_flight_recorder_path + "\"."
+                    : "Failed to write the flight recording to \"" + m_flight_recorder_path + "\"."
+                ).c_str(),
+                I_logger::log_level::error
+            );
+        }
+        else if (m_flight_recorder) {
+            m_flight_recorder->dump(0);
+        }
+        throw;
+    }
+}
+
+void mope::game_engine::run_scenes(I_game_window& window, I_logger* logger)
+{
+    // Shared, because steps on the job system may outlive an early exit.
+    auto tracer = std::make_shared<init_tracer>();
+    m_init_tracer = tracer;
+
+    // FreeType doesn't need a graphics context, so it can get going while we
+    // set up GL.
+    start_freetype_init(tracer);
+
     // Get an OpenGL context on this thread.
-    auto context = window.get_context();
+    auto context = [&]()
+        {
+            auto step = tracer->trace("get GL context");
+            return window.get_context();
+        }();
     if (!context) {
         throw game_engine_error{ "Window returned null OpenGL context." };
     }
 
     // Now that the context is current on this thread, we can load GL procs.
-    if (!::gladLoadGLLoader(window.get_gl_loader())) {
-        throw game_engine_error{ "Failed to load GL proc addresses." };
+    {
+        auto step = tracer->trace("load GL procs");
+        if (!::gladLoadGLLoader(window.get_gl_loader())) {
+            throw game_engine_error{ "Failed to load GL proc addresses." };
+        }
     }
 
     // We will try to ensure that our OpenGL resources are disposed of even if
@@ -164,11 +359,28 @@ void mope::game_engine::run(I_game_window& window, I_logger* logger)
                 scene->unload(*this);
             }
             m_scenes.clear();
+            m_init_tracer.reset();
+            m_pending_fonts.clear();
             release_gl_resources();
         }
     };
 
-    prepare_gl_resources(logger);
+    {
+        auto step = tracer->trace("prepare GL resources");
+        prepare_gl_resources(window, logger);
+    }
+
+    {
+        auto step = tracer->trace("load scenes");
+        load_scenes(logger);
+    }
+
+    // Fonts the scenes asked for were made alongside the rest of loading;
+    // from here on, they are made when they are asked for.
+    {
+        auto step = tracer->trace("wait for fonts");
+        wait_for_fonts();
+    }
 
     auto inputs = input_state{};
 
@@ -274,12 +486,30 @@ void mope::game_engine::run(I_game_window& window, I_logger* logger)
         }
 #endif
 
+        // Pick up any assets that were edited since last frame.
+        if (m_watcher) {
+            reload_changed_files(logger);
+        }
+
+        // Hand over any uploads that the GPU finished since last frame.
+        if (m_uploads) {
+            m_uploads->poll(logger);
+        }
+
+        // Upload any images that finished decoding since last frame.
+        m_assets.process_uploads(logger);
+
         // If the steptime is non-zero, we can use it to compute alpha for interpolation.
         // If it is zero, then alpha will also be zero and there will be no interpolation.
         auto alpha = accumulator / dt;
 
         // Finally, tell all the scenes to render.
         draw(window, alpha);
+
+        if (tracer) {
+            tracer->report(logger, "first frame");
+            tracer.reset();
+        }
     }
 
     resources.cleanup();
@@ -297,31 +527,193 @@ void mope::game_engine::run(I_game_window& window, I_logger* logger)
                 I_logger::log_level::debug
             );
         }
+
+        if (m_perf_counters) {
+            log_engine_stats(logger, m_stats);
+        }
     }
 }
 
 auto mope::game_engine::make_font(char const* ttf_path, int face_index, int instance_index) -> font
+{
+    auto face_id = static_cast<FT_Long>(face_index) | (static_cast<FT_Long>(instance_index) << 16);
+    auto packed = m_assets.find_packed(ttf_path);
+
+    // Faces from archives are never reloaded, so they don't keep a path.
+    auto path = nullptr == packed.entry ? std::string{ ttf_path } : std::string{};
+
+    auto shared = std::shared_ptr<detail::font_face>{};
+    if (m_init_tracer) {
+        // Still starting up: read the file and make the face on the job
+        // system, while the scenes go on loading. The face is waited for when
+        // it is first used, or before the first frame.
+        auto promise = std::make_shared<std::promise<FT_Face>>();
+        shared = std::make_shared<detail::font_face>(promise->get_future(), m_ft_mutex, path, face_id);
+        m_pending_fonts.push_back(shared);
+
+        // std::function needs a copyable job, so the packed asset is shared.
+        m_jobs.submit([
+            this,
+            promise,
+            packed = std::make_shared<asset_manager::packed_asset>(std::move(packed)),
+            path = std::string{ ttf_path },
+            face_id,
+            ft_init = m_ft_init,
+            tracer = m_init_tracer]()
+            {
+                try {
+                    auto step = tracer->trace("make font face (job system)");
+                    if (ft_init.valid()) {
+                        ft_init.get();
+                    }
+                    auto lock = std::scoped_lock{ m_ft_mutex };
+                    promise->set_value(create_face(std::move(*packed), path.c_str(), face_id));
+                }
+                catch (...) {
+                    promise->set_exception(std::current_exception());
+                }
+            });
+    }
+    else {
+        ensure_freetype();
+        shared = std::make_shared<detail::font_face>(create_face(std::move(packed), ttf_path, face_id), path, face_id);
+    }
+
+    if (!path.empty()) {
+        std::erase_if(m_fonts, [](auto&& weak) { return weak.expired(); });
+        m_fonts.push_back(shared);
+        if (m_watcher) {
+            m_watcher->watch(ttf_path);
+        }
+    }
+    return font{ std::move(shared) };
+}
+
+auto mope::game_engine::create_face(asset_manager::packed_asset packed, char const* path, FT_Long face_id) -> FT_Face
 {
     if (nullptr == m_ft_library) {
-        check_ft_error(
-            FT_Init_FreeType(&m_ft_library),
-            "initializing FreeType library"
-        );
+        throw game_engine_error{ "FreeType isn't initialized." };
     }
 
     FT_Face face = nullptr;
+    if (nullptr != packed.entry) {
+        auto data = std::make_unique<packed_font_data>(std::move(packed));
+        auto contents = read_asset(*data->packed.entry, data->buffer);
+        check_ft_error(FT_New_Memory_Face(
+            m_ft_library,
+            reinterpret_cast<FT_Byte const*>(contents.data()),
+            static_cast<FT_Long>(contents.size()),
+            face_id,
+            &face),
+            "creating font face"
+        );
+
+        face->generic.data = data.release();
+        face->generic.finalizer = [](void* object)
+            {
+                auto face = static_cast<FT_Face>(object);
+                delete static_cast<packed_font_data*>(face->generic.data);
+            };
+        return face;
+    }
 
     /// TODO: We definitely shouldn't actually throw here, since we're taking a
     /// path from the user.
     check_ft_error(FT_New_Face(
         m_ft_library,
-        ttf_path,
-        static_cast<FT_Long>(face_index) | (static_cast<FT_Long>(instance_index) << 16),
+        path,
+        face_id,
         &face),
         "creating font face"
     );
+    return face;
+}
+
+void mope::game_engine::wait_for_fonts()
+{
+    for (auto&& face : m_pending_fonts) {
+        face->wait();
+    }
+    m_pending_fonts.clear();
+    m_init_tracer.reset();
+}
+
+auto mope::game_engine::load_image(char const* path, image_options const& options)
+    -> std::shared_ptr<image const>
+{
+    return m_assets.load_image(path, options);
+}
 
-    return font{face};
+void mope::game_engine::mount_archive(char const* path)
+{
+    m_assets.mount_archive(path);
+}
+
+void mope::game_engine::load_sprite_shader(char const* vert_path, char const* frag_path)
+{
+    m_sprite_vert_path = vert_path;
+    m_sprite_frag_path = frag_path;
+    if (m_watcher) {
+        m_watcher->watch(m_sprite_vert_path);
+        m_watcher->watch(m_sprite_frag_path);
+    }
+    make_sprite_shader();
+}
+
+void mope::game_engine::set_hot_reload(bool enabled)
+{
+    if (!enabled) {
+        m_assets.set_watcher(nullptr);
+        m_watcher.reset();
+    }
+    else if (!m_watcher) {
+        m_watcher = std::make_unique<file_watcher>();
+        m_assets.set_watcher(m_watcher.get());
+        if (!m_sprite_vert_path.empty()) {
+            m_watcher->watch(m_sprite_vert_path);
+            m_watcher->watch(m_sprite_frag_path);
+        }
+        for (auto&& weak : m_fonts) {
+            if (auto face = weak.lock()) {
+                m_watcher->watch(face->path);
+            }
+        }
+    }
+}
+
+void mope::game_engine::set_perf_counters(bool enabled)
+{
+    if (!enabled) {
+        m_perf_counters.reset();
+    }
+    else {
+        m_perf_counters = std::make_unique<perf_counters>();
+        m_stats = engine_stats{};
+        m_stats.source = m_perf_counters->source();
+    }
+
+    for (auto&& scene : m_scenes) {
+        scene->set_perf_counters(m_perf_counters.get(), &m_stats);
+    }
+}
+
+void mope::game_engine::set_flight_recorder(char const* path, std::size_t ticks)
+{
+    // Scenes must stop recording before the old recorder goes away. Each
+    // keeps the number it was given when it was loaded, so that numbers stay
+    // unique across recorders.
+    for (auto&& scene : m_scenes) {
+        scene->set_flight_recorder(nullptr, scene->flight_recorder_scene());
+    }
+    m_flight_recorder.reset();
+
+    if (nullptr != path) {
+        m_flight_recorder = std::make_unique<flight_recorder>(ticks, path);
+        m_flight_recorder_path = path;
+        for (auto&& scene : m_scenes) {
+            scene->set_flight_recorder(m_flight_recorder.get(), scene->flight_recorder_scene());
+        }
+    }
 }
 
 auto mope::game_engine::get_default_texture() const -> gl::texture const&
@@ -329,7 +721,7 @@ auto mope::game_engine::get_default_texture() const -> gl::texture const&
     return m_default_texture;
 }
 
-void mope::game_engine::prepare_gl_resources(I_logger* logger)
+void mope::game_engine::prepare_gl_resources(I_game_window& window, I_logger* logger)
 {
     constexpr auto pixel = std::byte{ 0xff };
     m_default_texture.make(
@@ -346,6 +738,15 @@ void mope::game_engine::prepare_gl_resources(I_logger* logger)
         gl::color_component::one,
         gl::color_component::one });
 
+    sprite_renderer::make_default_shader(m_sprite_shader);
+
+    // If the window can share its context, big uploads happen on another
+    // thread and never hold up a frame.
+    if (auto shared_context = window.make_shared_context()) {
+        m_uploads = std::make_unique<upload_worker>(std::move(shared_context));
+        m_assets.set_upload_worker(m_uploads.get());
+    }
+
     ::glEnable(GL_BLEND);
     ::glEnable(GL_DEPTH_TEST);
     ::glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -360,6 +761,11 @@ void mope::game_engine::prepare_gl_resources(I_logger* logger)
 void mope::game_engine::release_gl_resources()
 {
     m_default_texture = gl::texture{};
+    m_sprite_shader = gl::shader{};
+    m_frame_graph.release();
+    m_assets.set_upload_worker(nullptr);
+    m_uploads.reset();
+    m_assets.clear();
     ::glDebugMessageCallback(NULL, NULL);
 }
 
@@ -376,8 +782,11 @@ void mope::game_engine::load_scenes(I_logger* logger)
         for (auto&& scene : range) {
             // Give the scene access to the external components that we control.
             scene->set_external_component(logger);
+            scene->set_external_component(&m_stats);
+            scene->set_perf_counters(m_perf_counters.get(), &m_stats);
+            scene->set_flight_recorder(m_flight_recorder.get(), m_loaded_scenes++);
 
-            scene->load(*this);
+            scene->load(*this, std::make_unique<sprite_renderer>(m_sprite_shader));
             m_scenes.push_back(std::move(scene));
         }
 
@@ -434,14 +843,137 @@ bool mope::game_engine::keep_alive(I_game_window& window)
     return !wants_to_close || rejected;
 }
 
+auto mope::game_engine::read_text_asset(std::string const& path) -> std::string
+{
+    if (auto packed = m_assets.find_packed(path); nullptr != packed.entry) {
+        auto buffer = std::vector<std::byte>{};
+        auto contents = read_asset(*packed.entry, buffer);
+        return { reinterpret_cast<char const*>(contents.data()), contents.size() };
+    }
+
+    auto file = std::ifstream{ path };
+    if (!file) {
+        throw game_engine_error{ "Failed to open \"" + path + "\"." };
+    }
+    auto text = std::ostringstream{};
+    text << file.rdbuf();
+    return std::move(text).str();
+}
+
+void mope::game_engine::start_freetype_init(std::shared_ptr<init_tracer> tracer)
+{
+    if (nullptr != m_ft_library || m_ft_init.valid()) {
+        return;
+    }
+
+    // std::function needs a copyable job, so the promise is shared.
+    auto promise = std::make_shared<std::promise<void>>();
+    m_ft_init = promise->get_future().share();
+    m_jobs.submit([this, promise, tracer = std::move(tracer)]()
+        {
+            try {
+                auto step = tracer->trace("init FreeType (job system)");
+                check_ft_error(
+                    FT_Init_FreeType(&m_ft_library),
+                    "initializing FreeType library"
+                );
+                promise->set_value();
+            }
+            catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+        });
+}
+
+void mope::game_engine::ensure_freetype()
+{
+    // Waiting on the future is what makes m_ft_library safe to read here.
+    if (m_ft_init.valid()) {
+        m_ft_init.get();
+        m_ft_init = {};
+    }
+
+    if (nullptr == m_ft_library) {
+        check_ft_error(
+            FT_Init_FreeType(&m_ft_library),
+            "initializing FreeType library"
+        );
+    }
+}
+
+void mope::game_engine::make_sprite_shader()
+{
+    auto vert_source = read_text_asset(m_sprite_vert_path);
+    auto frag_source = read_text_asset(m_sprite_frag_path);
+    m_sprite_shader.make(vert_source.c_str(), frag_source.c_str());
+}
+
+void mope::game_engine::reload_changed_files(I_logger* logger)
+{
+    for (auto&& path : m_watcher->poll()) {
+        try {
+            if (path == m_sprite_vert_path || path == m_sprite_frag_path) {
+                make_sprite_shader();
+            }
+
+            for (auto&& weak : m_fonts) {
+                auto face = weak.lock();
+                if (!face || face->path != path) {
+                    continue;
+                }
+
+                // Wait outside the lock, since a face still being made holds
+                // it.
+                face->wait();
+                auto lock = std::scoped_lock{ m_ft_mutex };
+                FT_Face new_face = nullptr;
+                check_ft_error(
+                    FT_New_Face(m_ft_library, path.c_str(), face->face_id, &new_face),
+                    "creating font face"
+                );
+                face->replace(new_face);
+            }
+
+            m_assets.reload_image(path);
+
+            if (nullptr != logger) {
+                logger->log(("Reloaded \"" + path + "\".").c_str(), I_logger::log_level::debug);
+            }
+        }
+        catch (std::exception const& ex) {
+            // Whatever was loaded before stays in use; the next save of the
+            // file gets another chance.
+            if (nullptr != logger) {
+                logger->log(
+                    ("Failed to reload \"" + path + "\": " + ex.what()).c_str(),
+                    I_logger::log_level::warning
+                );
+            }
+        }
+    }
+}
+
 void mope::game_engine::draw(I_game_window& window, double alpha)
 {
-    // Clear everything previously on the screen.
-    ::glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    // Clear everything previously on the screen, then let each scene add the
+    // passes that draw it.
+    m_frame_graph.reset();
+    auto target = m_frame_graph.backbuffer();
+    m_frame_graph.add_pass(
+        "clear",
+        [&](frame_graph::pass_builder& pass) { pass.write(target); },
+        [](frame_graph::pass_context const&) { ::glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); });
+    for (auto&& scene : m_scenes) {
+        scene->add_render_passes(m_frame_graph, target, alpha);
+    }
+    m_frame_graph.compile();
 
     // Render all scenes.
-    for (auto&& scene : m_scenes) {
-        scene->render(alpha);
+    auto before = m_perf_counters ? m_perf_counters->read() : perf_counts{};
+    m_frame_graph.execute(window.client_size());
+    if (m_perf_counters) {
+        m_stats.render += m_perf_counters->read() - before;
+        ++m_stats.frames;
     }
 
     // Tell the window that the next frame is ready.
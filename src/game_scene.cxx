@@ -1,26 +1,64 @@
 #include "mope_game_engine/game_scene.hxx"
 
 #include "mope_game_engine/components/component.hxx"
+#include "mope_game_engine/components/engine_stats.hxx"
 #include "mope_game_engine/components/logger.hxx"
+#include "mope_game_engine/events/scene_reset.hxx"
 #include "mope_game_engine/events/tick.hxx"
+#include "mope_game_engine/frame_graph.hxx"
+#include "flight_recorder.hxx"
+#include "lz4.hxx"
 #include "mope_vec/mope_vec.hxx"
+#include "perf_counters.hxx"
 #include "sprite_renderer.hxx"
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
 #include <memory>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
 #include <utility>
+#include <vector>
 
 mope::game_scene::game_scene()
-    : m_last_entity{ NoEntity }
+    : game_scene{ std::pmr::get_default_resource() }
+{
+}
+
+mope::game_scene::game_scene(std::pmr::memory_resource* component_memory)
+    : component_manager{ component_memory }
+    , m_last_entity{ NoEntity }
     , m_game_systems{ }
-    , m_event_pool{ }
+    , m_event_pool{ component_memory }
     , m_events{ }
+    , m_coalescing_events{ }
     , m_sprite_renderer{ }
+    , m_dormant_entities{ }
+    , m_perf_counters{ nullptr }
+    , m_engine_stats{ nullptr }
+    , m_system_stats{ }
+    , m_flight_recorder{ nullptr }
+    , m_recorder_scene{ 0 }
+    , m_function_names{ }
     , m_done{ false }
 {
 }
 
 mope::game_scene::~game_scene() = default;
 
+auto mope::game_scene::name_function(std::type_info const& type, std::uintptr_t address) -> char const*
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), " at 0x%jx", static_cast<std::uintmax_t>(address));
+    return m_function_names.emplace_back(std::string{ type.name() } + buffer).c_str();
+}
+
 void mope::game_scene::set_done(bool done)
 {
     m_done = done;
@@ -47,6 +85,83 @@ void mope::game_scene::destroy_entity(entity_id entity)
     for (auto&& manager : m_entity_component_stores) {
         manager.second->remove(entity);
     }
+    m_dormant_entities.erase(entity);
+}
+
+void mope::game_scene::make_dormant(entity_id entity)
+{
+    if (m_dormant_entities.contains(entity)) {
+        return;
+    }
+
+    auto dormant = dormant_entity{ };
+    auto bytes = std::vector<std::byte>{};
+    for (auto&& [type, store] : m_entity_component_stores) {
+        auto offset = bytes.size();
+        if (store && store->make_dormant(entity, bytes)) {
+            dormant.components.emplace_back(store.get(), bytes.size() - offset);
+        }
+    }
+
+    dormant.size = bytes.size();
+    auto compressed = lz4::compress(bytes);
+    dormant.compressed = compressed.size() < bytes.size();
+    dormant.bytes = dormant.compressed ? std::move(compressed) : std::move(bytes);
+    dormant.bytes.shrink_to_fit();
+    m_dormant_entities.emplace(entity, std::move(dormant));
+}
+
+void mope::game_scene::wake(entity_id entity)
+{
+    auto node = m_dormant_entities.extract(entity);
+    if (!node) {
+        return;
+    }
+
+    auto& dormant = node.mapped();
+    auto bytes = std::vector<std::byte>{};
+    if (dormant.compressed) {
+        bytes.resize(dormant.size);
+        lz4::decompress(dormant.bytes, bytes);
+    }
+    else {
+        bytes = std::move(dormant.bytes);
+    }
+
+    auto offset = 0uz;
+    for (auto&& [store, size] : dormant.components) {
+        store->wake(entity, std::span{ bytes }.subspan(offset, size));
+        offset += size;
+    }
+}
+
+auto mope::game_scene::is_dormant(entity_id entity) const -> bool
+{
+    return m_dormant_entities.contains(entity);
+}
+
+void mope::game_scene::reset()
+{
+    for (auto&& events : m_events) {
+        for (auto&& queued : events) {
+            // The event being handled (if any) is released once it has been.
+            if (nullptr != queued.event) {
+                queued.release(*this, queued.event);
+            }
+        }
+        events.clear();
+    }
+    m_coalescing_events.clear();
+
+    for (auto&& [type, store] : m_entity_component_stores) {
+        if (store) {
+            store->clear();
+        }
+    }
+    m_dormant_entities.clear();
+    m_last_entity = NoEntity;
+
+    dispatch_reset(scene_reset_event{});
 }
 
 auto mope::game_scene::logger() -> I_logger*
@@ -56,27 +171,72 @@ auto mope::game_scene::logger() -> I_logger*
 
 void mope::game_scene::tick(double time_step, input_state const& inputs)
 {
-    m_sprite_renderer->pre_tick(*this);
+    // Scenes ticked without an engine, such as those of world shards, have
+    // nothing to draw with.
+    if (nullptr != m_sprite_renderer) {
+        m_sprite_renderer->pre_tick(*this);
+    }
+
+    if (nullptr != m_flight_recorder) {
+        m_flight_recorder->begin_tick(m_recorder_scene, time_step, inputs);
+    }
+
+    dispatch_tick(tick_event{ time_step, inputs });
+
+    // Run the phases in order until every queue is empty, q.v. event_phase.
+    auto first = std::ranges::find_if(m_events, [](auto&& events) { return !events.empty(); });
+    while (m_events.end() != first) {
+        for (auto iter = first; iter != m_events.end(); ++iter) {
+            auto& events = *iter;
+            for (auto i = 0uz; i < events.size(); ++i) {
+                // Processing events potentially pushes more events, which
+                // potentially invalidates any references we take here. Since
+                // this seems like a path to madness, we are intentionally
+                // copying here.
+                auto queued = events[i];
+                events[i].event = nullptr;
+                queued.process(*this, queued.event);
+            }
+            events.clear();
+        }
+        first = std::ranges::find_if(m_events, [](auto&& events) { return !events.empty(); });
+    }
 
-    emplace_event<tick_event>(time_step, inputs);
-    for (auto i = 0uz; i < m_events.size(); ++i) {
-        // Processing events potentially pushes more events, which potentially
-        // invalidates any references we take here. Since this seems like a path
-        // to madness, we are intentionally copying here.
-        auto [event, process_event] = m_events[i];
-        process_event(*this, event);
+    if (nullptr != m_flight_recorder) {
+        auto components = 0uz;
+        for (auto&& [type, store] : m_entity_component_stores) {
+            components += store ? store->size() : 0;
+        }
+        m_flight_recorder->end_tick(m_last_entity, m_dormant_entities.size(), components);
     }
-    m_events.clear();
 }
 
 void mope::game_scene::render(double alpha)
 {
-    m_sprite_renderer->render(*this, alpha);
+    auto drawn = m_sprite_renderer->render(*this, alpha);
+    if (nullptr != m_engine_stats) {
+        m_engine_stats->sprites.sprites += drawn.sprites;
+        m_engine_stats->sprites.draws += drawn.draws;
+        m_engine_stats->sprites.instance_bytes += drawn.instance_bytes;
+    }
+}
+
+void mope::game_scene::on_render_passes(frame_graph& graph, render_target_handle target, double alpha)
+{
+    graph.add_pass(
+        "scene",
+        [&](frame_graph::pass_builder& pass) { pass.write(target); },
+        [this, alpha](frame_graph::pass_context const&) { render(alpha); });
+}
+
+void mope::game_scene::add_render_passes(frame_graph& graph, render_target_handle target, double alpha)
+{
+    on_render_passes(graph, target, alpha);
 }
 
-void mope::game_scene::load(I_game_engine& engine)
+void mope::game_scene::load(I_game_engine& engine, std::unique_ptr<sprite_renderer> renderer)
 {
-    m_sprite_renderer = std::make_unique<sprite_renderer>();
+    m_sprite_renderer = std::move(renderer);
     on_load(engine);
 }
 
@@ -89,3 +249,87 @@ bool mope::game_scene::close()
 {
     return on_close();
 }
+
+void mope::game_scene::set_perf_counters(perf_counters* counters, engine_stats* stats)
+{
+    m_perf_counters = counters;
+    m_engine_stats = stats;
+
+    // The stats may have been reset, so find each system's entry afresh.
+    m_system_stats.clear();
+}
+
+void mope::game_scene::set_flight_recorder(flight_recorder* recorder, std::uint32_t scene)
+{
+    m_flight_recorder = recorder;
+    m_recorder_scene = scene;
+}
+
+auto mope::game_scene::flight_recorder_scene() const -> std::uint32_t
+{
+    return m_recorder_scene;
+}
+
+void mope::game_scene::dispatch_tick(tick_event const& event)
+{
+    emplace_event<tick_event>(event);
+}
+
+void mope::game_scene::dispatch_reset(scene_reset_event const& event)
+{
+    // Systems may add systems, which may move the handlers.
+    auto& handlers = m_game_systems[typeid(scene_reset_event)];
+    for (auto i = 0uz; i < handlers.size(); ++i) {
+        handlers[i](*this, &event);
+    }
+}
+
+void mope::game_scene::process_event_instrumented(
+    std::type_info const& event_type,
+    std::vector<detail::event_handler>& handlers,
+    void const* event)
+{
+    using clock = std::chrono::steady_clock;
+    auto start = nullptr != m_flight_recorder ? clock::now() : clock::time_point{};
+
+    if (nullptr == m_perf_counters) {
+        for (auto i = 0uz; i < handlers.size(); ++i) {
+            handlers[i](*this, event);
+        }
+    }
+    else {
+        count_handlers(event_type, handlers, event);
+    }
+
+    if (nullptr != m_flight_recorder) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start);
+        m_flight_recorder->record_event(event_type, static_cast<std::uint64_t>(elapsed.count()));
+    }
+}
+
+void mope::game_scene::count_handlers(
+    std::type_info const& event_type,
+    std::vector<detail::event_handler>& handlers,
+    void const* event)
+{
+    auto& stats = m_engine_stats->systems;
+    auto& indices = m_system_stats[event_type];
+    for (auto i = 0uz; i < handlers.size(); ++i) {
+        // Systems added since the last event of this type get an entry now.
+        if (i == indices.size()) {
+            indices.push_back(stats.size());
+            stats.push_back(system_stats{
+                .event = event_type.name(),
+                .system = handlers[i].name(),
+                .invocations = 0,
+                .counts = { },
+            });
+        }
+
+        auto before = m_perf_counters->read();
+        handlers[i](*this, event);
+        auto& entry = stats[indices[i]];
+        entry.counts += m_perf_counters->read() - before;
+        ++entry.invocations;
+    }
+}
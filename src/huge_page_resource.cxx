@@ -0,0 +1,171 @@
+#include "mope_game_engine/huge_page_resource.hxx"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <string>
+
+#if defined(__linux__)
+
+#include <sys/mman.h>
+
+#endif // defined(__linux__)
+
+namespace
+{
+    auto round_up(std::size_t size, std::size_t multiple) -> std::size_t
+    {
+        return (size + multiple - 1) / multiple * multiple;
+    }
+
+#if defined(__linux__)
+
+    /// Map `size` bytes aligned to a huge page, which the kernel only
+    /// guarantees for page-sized alignment, by over-allocating and trimming.
+    auto map_aligned(std::size_t size) -> void*
+    {
+        constexpr auto Alignment = mope::huge_page_resource::HugePageSize;
+
+        auto mapped = ::mmap(nullptr, size + Alignment, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (MAP_FAILED == mapped) {
+            return nullptr;
+        }
+
+        auto address = reinterpret_cast<std::uintptr_t>(mapped);
+        auto aligned = round_up(address, Alignment);
+        if (aligned != address) {
+            ::munmap(mapped, aligned - address);
+        }
+        if (auto tail = Alignment - (aligned - address); tail > 0) {
+            ::munmap(reinterpret_cast<void*>(aligned + size), tail);
+        }
+
+        // Only a hint: without transparent huge pages, this fails and the
+        // memory is simply backed by small pages.
+        ::madvise(reinterpret_cast<void*>(aligned), size, MADV_HUGEPAGE);
+        return reinterpret_cast<void*>(aligned);
+    }
+
+#endif // defined(__linux__)
+}
+
+mope::huge_page_resource::huge_page_resource(std::size_t threshold, std::pmr::memory_resource* upstream)
+    : m_threshold{ threshold }
+    , m_upstream{ upstream }
+    , m_mutex{ }
+    , m_mappings{ }
+    , m_mapped_bytes{ 0 }
+    , m_small_allocations{ 0 }
+    , m_small_bytes{ 0 }
+{
+}
+
+mope::huge_page_resource::~huge_page_resource()
+{
+#if defined(__linux__)
+    for (auto [address, size] : m_mappings) {
+        ::munmap(address, size);
+    }
+#endif // defined(__linux__)
+}
+
+auto mope::huge_page_resource::stats(bool count_huge_pages) const -> huge_page_stats
+{
+    auto lock = std::scoped_lock{ m_mutex };
+    auto stats = huge_page_stats{
+        .mapped_allocations = m_mappings.size(),
+        .mapped_bytes = m_mapped_bytes,
+        .huge_page_bytes = 0,
+        .small_allocations = m_small_allocations,
+        .small_bytes = m_small_bytes,
+    };
+
+#if defined(__linux__)
+    if (count_huge_pages && !m_mappings.empty()) {
+        // Each mapping, or run of adjacent mappings that the kernel merged,
+        // is headed by a "start-end perms ..." line and followed by fields
+        // including "AnonHugePages: N kB".
+        auto smaps = std::ifstream{ "/proc/self/smaps" };
+        auto line = std::string{};
+        auto ours = false;
+        while (std::getline(smaps, line)) {
+            auto start = std::size_t{};
+            auto end = std::size_t{};
+            auto kilobytes = std::size_t{};
+            if (2 == std::sscanf(line.c_str(), "%zx-%zx ", &start, &end)) {
+                ours = false;
+                for (auto [address, size] : m_mappings) {
+                    auto first = reinterpret_cast<std::size_t>(address);
+                    if (first < end && start < first + size) {
+                        ours = true;
+                        break;
+                    }
+                }
+            }
+            else if (ours && 1 == std::sscanf(line.c_str(), "AnonHugePages: %zu kB", &kilobytes)) {
+                stats.huge_page_bytes += kilobytes * 1024;
+            }
+        }
+    }
+#else // !defined(__linux__)
+    (void)count_huge_pages;
+#endif // defined(__linux__)
+
+    return stats;
+}
+
+auto mope::huge_page_resource::do_allocate(std::size_t bytes, std::size_t alignment) -> void*
+{
+#if defined(__linux__)
+    if (bytes >= m_threshold && alignment <= HugePageSize) {
+        auto size = round_up(bytes, HugePageSize);
+        auto address = map_aligned(size);
+        if (nullptr == address) {
+            throw std::bad_alloc{};
+        }
+
+        auto lock = std::scoped_lock{ m_mutex };
+        m_mappings.emplace(address, size);
+        m_mapped_bytes += size;
+        return address;
+    }
+#endif // defined(__linux__)
+
+    auto address = m_upstream->allocate(bytes, alignment);
+    auto lock = std::scoped_lock{ m_mutex };
+    ++m_small_allocations;
+    m_small_bytes += bytes;
+    return address;
+}
+
+void mope::huge_page_resource::do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment)
+{
+    auto lock = std::unique_lock{ m_mutex };
+
+#if defined(__linux__)
+    if (auto mapping = m_mappings.find(ptr); m_mappings.end() != mapping) {
+        auto size = mapping->second;
+        m_mappings.erase(mapping);
+        m_mapped_bytes -= size;
+        lock.unlock();
+
+        ::munmap(ptr, size);
+        return;
+    }
+#endif // defined(__linux__)
+
+    --m_small_allocations;
+    m_small_bytes -= bytes;
+    lock.unlock();
+
+    m_upstream->deallocate(ptr, bytes, alignment);
+}
+
+auto mope::huge_page_resource::do_is_equal(std::pmr::memory_resource const& that) const noexcept -> bool
+{
+    return this == &that;
+}
@@ -0,0 +1,769 @@
+#include "image_decoder.hxx"
+
+#include "mope_game_engine/game_engine_error.hxx"
+#include "mope_game_engine/texture.hxx"
+#include "mope_vec/mope_vec.hxx"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using mope::game_engine_error;
+    using byte_span = std::span<std::byte const>;
+
+    // We hand images off to the GPU, so there's no point decoding anything
+    // much larger than the largest texture an implementation will take.
+    constexpr auto MaxDimension = std::uint32_t{ 1 } << 15;
+
+    auto as_uint(std::byte b) -> unsigned int
+    {
+        return std::to_integer<unsigned int>(b);
+    }
+
+    auto read_u32_be(std::byte const* p) -> std::uint32_t
+    {
+        return (std::uint32_t{ as_uint(p[0]) } << 24)
+            | (std::uint32_t{ as_uint(p[1]) } << 16)
+            | (std::uint32_t{ as_uint(p[2]) } << 8)
+            | std::uint32_t{ as_uint(p[3]) };
+    }
+
+    auto starts_with(byte_span data, std::string_view magic) -> bool
+    {
+        return data.size() >= magic.size()
+            && std::ranges::equal(
+                data.first(magic.size()),
+                magic,
+                [](std::byte b, char c) { return as_uint(b) == static_cast<unsigned char>(c); });
+    }
+
+    void check_dimensions(std::uint32_t width, std::uint32_t height, char const* format)
+    {
+        if (0 == width || 0 == height || width > MaxDimension || height > MaxDimension) {
+            throw game_engine_error{
+                std::string{ "[" } + format + "] Unsupported image dimensions: "
+                    + std::to_string(width) + "x" + std::to_string(height) + "."
+            };
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    // DEFLATE (RFC 1951), wrapped in zlib (RFC 1950), as used by PNG.
+    ////////////////////////////////////////////////////////////////////////////
+
+    /// Reads bits from a DEFLATE stream, least significant bit first.
+    class bit_reader
+    {
+    public:
+        bit_reader(byte_span data)
+            : m_data{ data }
+            , m_position{ 0 }
+            , m_bit_buffer{ 0 }
+            , m_bit_count{ 0 }
+        {
+        }
+
+        auto bits(int count) -> unsigned int
+        {
+            auto value = m_bit_buffer;
+            while (m_bit_count < count) {
+                if (m_position >= m_data.size()) {
+                    throw game_engine_error{ "[PNG] Unexpected end of compressed data." };
+                }
+                value |= std::uint32_t{ as_uint(m_data[m_position++]) } << m_bit_count;
+                m_bit_count += 8;
+            }
+            m_bit_buffer = value >> count;
+            m_bit_count -= count;
+            return value & ((std::uint32_t{ 1 } << count) - 1);
+        }
+
+        /// Discard any bits left over from the current byte.
+        ///
+        /// We only ever pull in a byte once we need at least one of its bits,
+        /// so whatever is buffered belongs to the byte we're in the middle of.
+        void align_to_byte()
+        {
+            m_bit_buffer = 0;
+            m_bit_count = 0;
+        }
+
+        auto take_bytes(std::size_t count) -> byte_span
+        {
+            if (m_data.size() - m_position < count) {
+                throw game_engine_error{ "[PNG] Unexpected end of compressed data." };
+            }
+            auto result = m_data.subspan(m_position, count);
+            m_position += count;
+            return result;
+        }
+
+    private:
+        byte_span m_data;
+        std::size_t m_position;
+        std::uint32_t m_bit_buffer;
+        int m_bit_count;
+    };
+
+    constexpr auto MaxCodeLength = 15;
+
+    /// A canonical Huffman code, stored as the number of codes of each length
+    /// and the symbols ordered by code.
+    struct huffman_code
+    {
+        std::array<std::uint16_t, MaxCodeLength + 1> counts;
+        std::array<std::uint16_t, 288> symbols;
+    };
+
+    auto build_huffman_code(std::span<std::uint8_t const> lengths) -> huffman_code
+    {
+        auto code = huffman_code{};
+        for (auto length : lengths) {
+            ++code.counts[length];
+        }
+        code.counts[0] = 0;
+
+        // Incomplete codes are allowed (a distance code may legitimately
+        // contain a single symbol), but over-subscribed ones are not.
+        auto left = 1;
+        for (auto length = 1; length <= MaxCodeLength; ++length) {
+            left = (left << 1) - code.counts[length];
+            if (left < 0) {
+                throw game_engine_error{ "[PNG] Over-subscribed Huffman code." };
+            }
+        }
+
+        auto offsets = std::array<std::uint16_t, MaxCodeLength + 1>{};
+        for (auto length = 1; length < MaxCodeLength; ++length) {
+            offsets[length + 1] = offsets[length] + code.counts[length];
+        }
+        for (auto symbol = 0uz; symbol < lengths.size(); ++symbol) {
+            if (0 != lengths[symbol]) {
+                code.symbols[offsets[lengths[symbol]]++] = static_cast<std::uint16_t>(symbol);
+            }
+        }
+
+        return code;
+    }
+
+    auto decode_symbol(bit_reader& reader, huffman_code const& code) -> int
+    {
+        // Canonical codes of each length are consecutive, so we can walk down
+        // the lengths comparing against the first code of each.
+        auto bits = 0;
+        auto first = 0;
+        auto index = 0;
+        for (auto length = 1; length <= MaxCodeLength; ++length) {
+            bits |= static_cast<int>(reader.bits(1));
+            int count = code.counts[length];
+            if (bits - count < first) {
+                return code.symbols[index + (bits - first)];
+            }
+            index += count;
+            first = (first + count) << 1;
+            bits <<= 1;
+        }
+        throw game_engine_error{ "[PNG] Invalid Huffman code." };
+    }
+
+    constexpr auto LengthBase = std::to_array<std::uint16_t>({
+        3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+        35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 });
+    constexpr auto LengthExtraBits = std::to_array<std::uint8_t>({
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+        3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 });
+    constexpr auto DistanceBase = std::to_array<std::uint16_t>({
+        1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+        257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 });
+    constexpr auto DistanceExtraBits = std::to_array<std::uint8_t>({
+        0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+        7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 });
+
+    /// Inflated data may not grow past `limit` bytes, which is what the
+    /// image's header says it holds. Otherwise a small file could inflate to
+    /// gigabytes.
+    void check_inflated_size(std::size_t size, std::size_t limit)
+    {
+        if (size > limit) {
+            throw game_engine_error{ "[PNG] Image data is larger than the header says." };
+        }
+    }
+
+    void inflate_stored_block(bit_reader& reader, std::vector<std::byte>& out, std::size_t limit)
+    {
+        reader.align_to_byte();
+        auto header = reader.take_bytes(4);
+        auto length = as_uint(header[0]) | (as_uint(header[1]) << 8);
+        auto complement = as_uint(header[2]) | (as_uint(header[3]) << 8);
+        if (length != (~complement & 0xffff)) {
+            throw game_engine_error{ "[PNG] Corrupt stored block." };
+        }
+        check_inflated_size(out.size() + length, limit);
+        auto block = reader.take_bytes(length);
+        out.insert(out.end(), block.begin(), block.end());
+    }
+
+    void inflate_compressed_block(
+        bit_reader& reader,
+        std::vector<std::byte>& out,
+        std::size_t limit,
+        huffman_code const& literals,
+        huffman_code const& distances)
+    {
+        while (true) {
+            auto symbol = decode_symbol(reader, literals);
+            if (symbol < 256) {
+                check_inflated_size(out.size() + 1, limit);
+                out.push_back(static_cast<std::byte>(symbol));
+            }
+            else if (256 == symbol) {
+                return;
+            }
+            else {
+                auto length_index = static_cast<std::size_t>(symbol - 257);
+                if (length_index >= LengthBase.size()) {
+                    throw game_engine_error{ "[PNG] Invalid length symbol." };
+                }
+                auto length = LengthBase[length_index] + reader.bits(LengthExtraBits[length_index]);
+
+                auto distance_index = static_cast<std::size_t>(decode_symbol(reader, distances));
+                if (distance_index >= DistanceBase.size()) {
+                    throw game_engine_error{ "[PNG] Invalid distance symbol." };
+                }
+                auto distance = DistanceBase[distance_index] + reader.bits(DistanceExtraBits[distance_index]);
+                if (distance > out.size()) {
+                    throw game_engine_error{ "[PNG] Distance reaches before start of data." };
+                }
+
+                check_inflated_size(out.size() + length, limit);
+
+                // The copy may overlap the bytes it produces (e.g. a run of a
+                // single byte), so this has to go one byte at a time.
+                auto from = out.size() - distance;
+                for (auto i = 0u; i < length; ++i) {
+                    auto b = out[from + i];
+                    out.push_back(b);
+                }
+            }
+        }
+    }
+
+    auto fixed_huffman_codes() -> std::pair<huffman_code, huffman_code> const&
+    {
+        static auto const codes = []()
+            {
+                auto lengths = std::array<std::uint8_t, 288>{};
+                std::fill(lengths.begin(), lengths.begin() + 144, std::uint8_t{ 8 });
+                std::fill(lengths.begin() + 144, lengths.begin() + 256, std::uint8_t{ 9 });
+                std::fill(lengths.begin() + 256, lengths.begin() + 280, std::uint8_t{ 7 });
+                std::fill(lengths.begin() + 280, lengths.end(), std::uint8_t{ 8 });
+
+                auto distance_lengths = std::array<std::uint8_t, 30>{};
+                distance_lengths.fill(5);
+
+                return std::pair{
+                    build_huffman_code(lengths),
+                    build_huffman_code(distance_lengths)
+                };
+            }();
+        return codes;
+    }
+
+    auto read_dynamic_huffman_codes(bit_reader& reader) -> std::pair<huffman_code, huffman_code>
+    {
+        constexpr auto CodeLengthOrder = std::to_array<std::uint8_t>({
+            16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 });
+
+        auto literal_count = reader.bits(5) + 257;
+        auto distance_count = reader.bits(5) + 1;
+        auto code_length_count = reader.bits(4) + 4;
+        if (literal_count > 286 || distance_count > 30) {
+            throw game_engine_error{ "[PNG] Too many Huffman codes." };
+        }
+
+        auto code_length_lengths = std::array<std::uint8_t, 19>{};
+        for (auto i = 0u; i < code_length_count; ++i) {
+            code_length_lengths[CodeLengthOrder[i]] = static_cast<std::uint8_t>(reader.bits(3));
+        }
+        auto code_length_code = build_huffman_code(code_length_lengths);
+
+        auto lengths = std::array<std::uint8_t, 286 + 30>{};
+        auto total = literal_count + distance_count;
+        for (auto i = 0u; i < total; ) {
+            auto symbol = decode_symbol(reader, code_length_code);
+            if (symbol < 16) {
+                lengths[i++] = static_cast<std::uint8_t>(symbol);
+                continue;
+            }
+
+            auto repeated = std::uint8_t{ 0 };
+            auto repeat = 0u;
+            switch (symbol) {
+            case 16:
+                if (0 == i) {
+                    throw game_engine_error{ "[PNG] Repeated code length with no previous length." };
+                }
+                repeated = lengths[i - 1];
+                repeat = 3 + reader.bits(2);
+                break;
+            case 17:
+                repeat = 3 + reader.bits(3);
+                break;
+            default:
+                repeat = 11 + reader.bits(7);
+                break;
+            }
+
+            if (i + repeat > total) {
+                throw game_engine_error{ "[PNG] Code lengths overflow." };
+            }
+            std::fill_n(lengths.begin() + i, repeat, repeated);
+            i += repeat;
+        }
+
+        if (0 == lengths[256]) {
+            throw game_engine_error{ "[PNG] Missing end-of-block code." };
+        }
+
+        auto all_lengths = std::span{ lengths };
+        return {
+            build_huffman_code(all_lengths.first(literal_count)),
+            build_huffman_code(all_lengths.subspan(literal_count, distance_count))
+        };
+    }
+
+    /// The most bytes that a byte of deflate data can inflate to: 258 from
+    /// a length code and a distance code of a bit each.
+    constexpr auto MaxDeflateRatio = 1032uz;
+
+    auto zlib_decompress(byte_span data, std::size_t expected_size) -> std::vector<std::byte>
+    {
+        if (data.size() < 2) {
+            throw game_engine_error{ "[PNG] Missing zlib header." };
+        }
+        auto cmf = as_uint(data[0]);
+        auto flg = as_uint(data[1]);
+        if (8 != (cmf & 0x0f) || 0 != ((cmf << 8) | flg) % 31 || 0 != (flg & 0x20)) {
+            throw game_engine_error{ "[PNG] Invalid zlib header." };
+        }
+
+        // A header asking for more than the data could make can't be right,
+        // and checking it first bounds what is reserved by the data's size.
+        if ((expected_size - 1) / MaxDeflateRatio >= data.size()) {
+            throw game_engine_error{ "[PNG] Image is larger than its data could hold." };
+        }
+        auto out = std::vector<std::byte>{};
+        out.reserve(expected_size);
+
+        auto reader = bit_reader{ data.subspan(2) };
+        auto last_block = false;
+        while (!last_block) {
+            last_block = 1 == reader.bits(1);
+            switch (reader.bits(2)) {
+            case 0:
+                inflate_stored_block(reader, out, expected_size);
+                break;
+            case 1: {
+                auto&& [literals, distances] = fixed_huffman_codes();
+                inflate_compressed_block(reader, out, expected_size, literals, distances);
+                break;
+            }
+            case 2: {
+                auto [literals, distances] = read_dynamic_huffman_codes(reader);
+                inflate_compressed_block(reader, out, expected_size, literals, distances);
+                break;
+            }
+            default:
+                throw game_engine_error{ "[PNG] Invalid block type." };
+            }
+        }
+
+        return out;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    // PNG
+    ////////////////////////////////////////////////////////////////////////////
+
+    constexpr auto PngSignature = std::string_view{ "\x89PNG\r\n\x1a\n", 8 };
+
+    enum png_color_type : unsigned int
+    {
+        greyscale = 0,
+        truecolor = 2,
+        indexed = 3,
+        greyscale_alpha = 4,
+        truecolor_alpha = 6,
+    };
+
+    auto png_channel_count(unsigned int color_type) -> unsigned int
+    {
+        switch (color_type) {
+        case greyscale: return 1;
+        case truecolor: return 3;
+        case indexed: return 1;
+        case greyscale_alpha: return 2;
+        case truecolor_alpha: return 4;
+        default: return 0;
+        }
+    }
+
+    auto is_valid_png_bit_depth(unsigned int color_type, unsigned int bit_depth) -> bool
+    {
+        switch (color_type) {
+        case greyscale:
+            return 1 == bit_depth || 2 == bit_depth || 4 == bit_depth || 8 == bit_depth || 16 == bit_depth;
+        case indexed:
+            return 1 == bit_depth || 2 == bit_depth || 4 == bit_depth || 8 == bit_depth;
+        case truecolor:
+        case greyscale_alpha:
+        case truecolor_alpha:
+            return 8 == bit_depth || 16 == bit_depth;
+        default:
+            return false;
+        }
+    }
+
+    auto paeth_predictor(int a, int b, int c) -> int
+    {
+        auto p = a + b - c;
+        auto pa = std::abs(p - a);
+        auto pb = std::abs(p - b);
+        auto pc = std::abs(p - c);
+        return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+    }
+
+    /// Undo the per-row filters in place, leaving each row's filter byte be.
+    void unfilter_png(std::vector<std::byte>& data, std::size_t stride, std::size_t rows, std::size_t pixel_bytes)
+    {
+        if (data.size() < (stride + 1) * rows) {
+            throw game_engine_error{ "[PNG] Not enough image data." };
+        }
+
+        for (auto y = 0uz; y < rows; ++y) {
+            auto row = data.data() + y * (stride + 1);
+            auto filter = as_uint(row[0]);
+            auto current = row + 1;
+            auto previous = 0 == y ? nullptr : current - (stride + 1);
+
+            auto left = [&](std::size_t i) { return i >= pixel_bytes ? as_uint(current[i - pixel_bytes]) : 0u; };
+            auto up = [&](std::size_t i) { return nullptr != previous ? as_uint(previous[i]) : 0u; };
+            auto up_left = [&](std::size_t i) {
+                return nullptr != previous && i >= pixel_bytes ? as_uint(previous[i - pixel_bytes]) : 0u;
+            };
+
+            for (auto i = 0uz; i < stride; ++i) {
+                auto predicted = 0u;
+                switch (filter) {
+                case 0: break;
+                case 1: predicted = left(i); break;
+                case 2: predicted = up(i); break;
+                case 3: predicted = (left(i) + up(i)) / 2; break;
+                case 4:
+                    predicted = static_cast<unsigned int>(paeth_predictor(
+                        static_cast<int>(left(i)),
+                        static_cast<int>(up(i)),
+                        static_cast<int>(up_left(i))));
+                    break;
+                default:
+                    throw game_engine_error{ "[PNG] Invalid filter type." };
+                }
+                current[i] = static_cast<std::byte>((as_uint(current[i]) + predicted) & 0xff);
+            }
+        }
+    }
+
+    /// Read the @p index th sample of a row at its full bit depth.
+    auto read_png_sample(std::byte const* row, std::size_t index, unsigned int bit_depth) -> unsigned int
+    {
+        switch (bit_depth) {
+        case 8:
+            return as_uint(row[index]);
+        case 16:
+            return (as_uint(row[2 * index]) << 8) | as_uint(row[2 * index + 1]);
+        default: {
+            // Sub-byte samples are packed starting from the high bits.
+            auto bit = index * bit_depth;
+            auto shift = 8 - bit_depth - bit % 8;
+            return (as_uint(row[bit / 8]) >> shift) & ((1u << bit_depth) - 1);
+        }
+        }
+    }
+
+    auto scale_png_sample(unsigned int sample, unsigned int bit_depth) -> std::byte
+    {
+        return static_cast<std::byte>(
+            16 == bit_depth ? sample >> 8 : sample * 255 / ((1u << bit_depth) - 1));
+    }
+
+    auto decode_png(byte_span data) -> mope::decoded_image
+    {
+        auto position = PngSignature.size();
+
+        auto width = std::uint32_t{ 0 };
+        auto height = std::uint32_t{ 0 };
+        auto bit_depth = 0u;
+        auto color_type = 0u;
+        auto palette = std::vector<std::array<std::byte, 4>>{};
+        auto transparent_key = std::array<unsigned int, 3>{};
+        auto has_transparent_key = false;
+        auto compressed = std::vector<std::byte>{};
+        auto seen_header = false;
+        auto seen_end = false;
+
+        while (!seen_end) {
+            if (data.size() - position < 12) {
+                throw game_engine_error{ "[PNG] Truncated chunk." };
+            }
+            auto length = read_u32_be(data.data() + position);
+            auto type = std::string_view{ reinterpret_cast<char const*>(data.data() + position + 4), 4 };
+            if (data.size() - position - 12 < length) {
+                throw game_engine_error{ "[PNG] Truncated chunk." };
+            }
+            auto chunk = data.subspan(position + 8, length);
+            position += 12 + std::size_t{ length };
+
+            if ("IHDR" == type) {
+                if (13 != length) {
+                    throw game_engine_error{ "[PNG] Invalid header." };
+                }
+                width = read_u32_be(chunk.data());
+                height = read_u32_be(chunk.data() + 4);
+                bit_depth = as_uint(chunk[8]);
+                color_type = as_uint(chunk[9]);
+                check_dimensions(width, height, "PNG");
+                if (!is_valid_png_bit_depth(color_type, bit_depth)) {
+                    throw game_engine_error{ "[PNG] Invalid color type / bit depth combination." };
+                }
+                if (0 != as_uint(chunk[10]) || 0 != as_uint(chunk[11])) {
+                    throw game_engine_error{ "[PNG] Unknown compression or filter method." };
+                }
+                if (0 != as_uint(chunk[12])) {
+                    throw game_engine_error{ "[PNG] Interlaced images are not supported." };
+                }
+                seen_header = true;
+            }
+            else if (!seen_header) {
+                throw game_engine_error{ "[PNG] First chunk is not a header." };
+            }
+            else if ("PLTE" == type) {
+                palette.resize(length / 3);
+                for (auto i = 0uz; i < palette.size(); ++i) {
+                    palette[i] = { chunk[3 * i], chunk[3 * i + 1], chunk[3 * i + 2], std::byte{ 0xff } };
+                }
+            }
+            else if ("tRNS" == type) {
+                if (indexed == color_type) {
+                    for (auto i = 0uz; i < std::min(palette.size(), chunk.size()); ++i) {
+                        palette[i][3] = chunk[i];
+                    }
+                }
+                else if (greyscale == color_type && 2 <= length) {
+                    transparent_key[0] = read_png_sample(chunk.data(), 0, 16);
+                    has_transparent_key = true;
+                }
+                else if (truecolor == color_type && 6 <= length) {
+                    for (auto i = 0uz; i < 3; ++i) {
+                        transparent_key[i] = read_png_sample(chunk.data(), i, 16);
+                    }
+                    has_transparent_key = true;
+                }
+            }
+            else if ("IDAT" == type) {
+                compressed.insert(compressed.end(), chunk.begin(), chunk.end());
+            }
+            else if ("IEND" == type) {
+                seen_end = true;
+            }
+            // Any other chunks are ancillary as far as we're concerned.
+        }
+
+        if (indexed == color_type && palette.empty()) {
+            throw game_engine_error{ "[PNG] Indexed image has no palette." };
+        }
+
+        auto channels = png_channel_count(color_type);
+        auto bits_per_pixel = channels * bit_depth;
+        auto stride = (std::size_t{ width } * bits_per_pixel + 7) / 8;
+        auto pixel_bytes = std::max(std::size_t{ 1 }, std::size_t{ bits_per_pixel / 8 });
+
+        auto raw = zlib_decompress(compressed, (stride + 1) * height);
+        unfilter_png(raw, stride, height, pixel_bytes);
+
+        // Transparency keys are compared against samples at their full bit
+        // depth, so convert them from the 16-bit form they're stored in.
+        if (has_transparent_key && 16 != bit_depth) {
+            for (auto&& key : transparent_key) {
+                key &= (1u << bit_depth) - 1;
+            }
+        }
+
+        auto result = mope::decoded_image{
+            .pixels = std::vector<std::byte>(std::size_t{ width } * height * 4),
+            .size = mope::vec2i{ static_cast<int>(width), static_cast<int>(height) },
+            .format = mope::gl::pixel_format::rgba,
+        };
+
+        auto out = result.pixels.data();
+        for (auto y = 0uz; y < height; ++y) {
+            auto row = raw.data() + y * (stride + 1) + 1;
+            for (auto x = 0uz; x < width; ++x, out += 4) {
+                auto sample = [&](std::size_t channel) {
+                    return read_png_sample(row, x * channels + channel, bit_depth);
+                };
+
+                switch (color_type) {
+                case greyscale: {
+                    auto grey = sample(0);
+                    out[0] = out[1] = out[2] = scale_png_sample(grey, bit_depth);
+                    out[3] = has_transparent_key && grey == transparent_key[0]
+                        ? std::byte{ 0 } : std::byte{ 0xff };
+                    break;
+                }
+                case truecolor: {
+                    auto rgb = std::array{ sample(0), sample(1), sample(2) };
+                    for (auto i = 0uz; i < 3; ++i) {
+                        out[i] = scale_png_sample(rgb[i], bit_depth);
+                    }
+                    out[3] = has_transparent_key && rgb == transparent_key
+                        ? std::byte{ 0 } : std::byte{ 0xff };
+                    break;
+                }
+                case indexed: {
+                    auto index = sample(0);
+                    if (index >= palette.size()) {
+                        throw game_engine_error{ "[PNG] Palette index out of range." };
+                    }
+                    std::copy_n(palette[index].begin(), 4, out);
+                    break;
+                }
+                case greyscale_alpha:
+                    out[0] = out[1] = out[2] = scale_png_sample(sample(0), bit_depth);
+                    out[3] = scale_png_sample(sample(1), bit_depth);
+                    break;
+                case truecolor_alpha:
+                    for (auto i = 0uz; i < 4; ++i) {
+                        out[i] = scale_png_sample(sample(i), bit_depth);
+                    }
+                    break;
+                }
+            }
+        }
+
+        return result;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    // QOI (https://qoiformat.org/qoi-specification.pdf)
+    ////////////////////////////////////////////////////////////////////////////
+
+    constexpr auto QoiMagic = std::string_view{ "qoif" };
+    constexpr auto QoiHeaderSize = 14uz;
+    constexpr auto QoiMaxRun = 62uz;
+
+    auto decode_qoi(byte_span data) -> mope::decoded_image
+    {
+        if (data.size() < QoiHeaderSize) {
+            throw game_engine_error{ "[QOI] Truncated header." };
+        }
+        auto width = read_u32_be(data.data() + 4);
+        auto height = read_u32_be(data.data() + 8);
+        check_dimensions(width, height, "QOI");
+
+        // No byte of data makes more than the 62 pixels of a run, so don't
+        // allocate for an image the data can't hold.
+        if ((std::size_t{ width } * height - 1) / QoiMaxRun >= data.size() - QoiHeaderSize) {
+            throw game_engine_error{ "[QOI] Image is larger than its data could hold." };
+        }
+
+        auto result = mope::decoded_image{
+            .pixels = std::vector<std::byte>(std::size_t{ width } * height * 4),
+            .size = mope::vec2i{ static_cast<int>(width), static_cast<int>(height) },
+            .format = mope::gl::pixel_format::rgba,
+        };
+
+        using pixel = std::array<std::uint8_t, 4>;
+        auto seen = std::array<pixel, 64>{};
+        auto px = pixel{ 0, 0, 0, 255 };
+        auto run = 0u;
+        auto position = QoiHeaderSize;
+
+        auto next = [&]() -> std::uint8_t
+            {
+                if (position >= data.size()) {
+                    throw game_engine_error{ "[QOI] Unexpected end of data." };
+                }
+                return static_cast<std::uint8_t>(as_uint(data[position++]));
+            };
+
+        for (auto out = result.pixels.begin(); out != result.pixels.end(); out += 4) {
+            if (run > 0) {
+                --run;
+            }
+            else {
+                auto op = next();
+                if (0xfe == op) {
+                    px[0] = next();
+                    px[1] = next();
+                    px[2] = next();
+                }
+                else if (0xff == op) {
+                    px[0] = next();
+                    px[1] = next();
+                    px[2] = next();
+                    px[3] = next();
+                }
+                else {
+                    switch (op & 0xc0) {
+                    case 0x00:
+                        px = seen[op];
+                        break;
+                    case 0x40:
+                        px[0] = static_cast<std::uint8_t>(px[0] + ((op >> 4) & 0x03) - 2);
+                        px[1] = static_cast<std::uint8_t>(px[1] + ((op >> 2) & 0x03) - 2);
+                        px[2] = static_cast<std::uint8_t>(px[2] + (op & 0x03) - 2);
+                        break;
+                    case 0x80: {
+                        auto second = next();
+                        auto green_diff = (op & 0x3f) - 32;
+                        px[0] = static_cast<std::uint8_t>(px[0] + green_diff - 8 + ((second >> 4) & 0x0f));
+                        px[1] = static_cast<std::uint8_t>(px[1] + green_diff);
+                        px[2] = static_cast<std::uint8_t>(px[2] + green_diff - 8 + (second & 0x0f));
+                        break;
+                    }
+                    default:
+                        run = op & 0x3f;
+                        break;
+                    }
+                }
+                seen[(px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64] = px;
+            }
+
+            std::transform(px.begin(), px.end(), out, [](std::uint8_t c) { return std::byte{ c }; });
+        }
+
+        return result;
+    }
+}
+
+auto mope::decode_image(std::span<std::byte const> data) -> decoded_image
+{
+    if (starts_with(data, PngSignature)) {
+        return decode_png(data);
+    }
+    else if (starts_with(data, QoiMagic)) {
+        return decode_qoi(data);
+    }
+    else {
+        throw game_engine_error{ "Unrecognized image format." };
+    }
+}
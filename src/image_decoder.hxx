@@ -0,0 +1,35 @@
+#pragma once
+
+#include "mope_game_engine/texture.hxx"
+#include "mope_vec/mope_vec.hxx"
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace mope
+{
+    /// Pixels decoded from an image file.
+    ///
+    /// Rows are tightly packed and ordered top to bottom, which is the order
+    /// in which @ref sprite_renderer expects them.
+    struct decoded_image
+    {
+        std::vector<std::byte> pixels;
+        vec2i size;
+        gl::pixel_format format;
+
+        /// Baked textures may come with more than one mip level, and the
+        /// asset manager builds the rest of a decoded image's chain when its
+        /// filter samples them, q.v. @ref gl::texture_extra_options::levels.
+        int levels = 1;
+    };
+
+    /// Decode a PNG or QOI image from memory into 8-bit RGBA pixels.
+    ///
+    /// PNG support covers every non-interlaced color type; 16-bit channels are
+    /// truncated to 8 bits.
+    ///
+    /// Throws @ref game_engine_error if @p data isn't an image we understand.
+    auto decode_image(std::span<std::byte const> data) -> decoded_image;
+} // namespace mope
@@ -0,0 +1,72 @@
+#include "init_tracer.hxx"
+
+#include "mope_game_engine/components/logger.hxx"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+
+namespace
+{
+    auto to_ms(std::chrono::steady_clock::duration d) -> double
+    {
+        return std::chrono::duration<double, std::milli>{ d }.count();
+    }
+
+    auto format_step(double offset_ms, double length_ms, char const* name) -> std::string
+    {
+        char buffer[64];
+        std::snprintf(buffer, sizeof(buffer), "[init] +%8.2f ms %8.2f ms  ", offset_ms, length_ms);
+        return buffer + std::string{ name };
+    }
+}
+
+mope::init_tracer::scope::scope(init_tracer& tracer, char const* step)
+    : m_tracer{ tracer }
+    , m_step{ step }
+    , m_start{ clock::now() }
+{
+}
+
+mope::init_tracer::scope::~scope()
+{
+    m_tracer.record(m_step, m_start, clock::now());
+}
+
+mope::init_tracer::init_tracer()
+    : m_start{ clock::now() }
+    , m_mutex{ }
+    , m_steps{ }
+{
+}
+
+auto mope::init_tracer::trace(char const* step) -> scope
+{
+    return scope{ *this, step };
+}
+
+void mope::init_tracer::report(I_logger* logger, char const* total_name)
+{
+    auto total = clock::now() - m_start;
+    if (nullptr == logger) {
+        return;
+    }
+
+    auto lock = std::scoped_lock{ m_mutex };
+    std::ranges::sort(m_steps, {}, &step::offset);
+    for (auto&& step : m_steps) {
+        logger->log(
+            format_step(to_ms(step.offset), to_ms(step.length), step.name.c_str()).c_str(),
+            I_logger::log_level::debug
+        );
+    }
+    logger->log(format_step(0.0, to_ms(total), total_name).c_str(), I_logger::log_level::debug);
+}
+
+void mope::init_tracer::record(char const* name, clock::time_point start, clock::time_point end)
+{
+    auto lock = std::scoped_lock{ m_mutex };
+    m_steps.push_back({ name, start - m_start, end - start });
+}
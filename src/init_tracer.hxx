@@ -0,0 +1,63 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mope
+{
+    struct I_logger;
+
+    /// Records how long each step of engine startup takes, so that the time
+    /// to the first frame can be measured and picked apart.
+    ///
+    /// Steps may be traced from any thread. Each is reported with its offset
+    /// from the start of startup, which shows which steps overlapped.
+    class init_tracer
+    {
+        using clock = std::chrono::steady_clock;
+
+    public:
+        /// Records the step it was made for when it is destroyed.
+        class scope
+        {
+        public:
+            scope(init_tracer& tracer, char const* step);
+            ~scope();
+
+            scope(scope const&) = delete;
+            auto operator=(scope const&) -> scope& = delete;
+
+        private:
+            init_tracer& m_tracer;
+            char const* m_step;
+            clock::time_point m_start;
+        };
+
+        init_tracer();
+
+        init_tracer(init_tracer const&) = delete;
+        auto operator=(init_tracer const&) -> init_tracer& = delete;
+
+        auto trace(char const* step) -> scope;
+
+        /// Log every step recorded so far, then the total time since this
+        /// tracer was made.
+        void report(I_logger* logger, char const* total_name);
+
+    private:
+        struct step
+        {
+            std::string name;
+            clock::duration offset;
+            clock::duration length;
+        };
+
+        void record(char const* name, clock::time_point start, clock::time_point end);
+
+        clock::time_point m_start;
+        std::mutex m_mutex;
+        std::vector<step> m_steps;
+    };
+} // namespace mope
@@ -0,0 +1,60 @@
+#include "job_system.hxx"
+
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+mope::job_system::job_system(unsigned int thread_count)
+    : m_mutex{ }
+    , m_condition{ }
+    , m_jobs{ }
+    , m_threads{ }
+{
+    if (0 == thread_count) {
+        thread_count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+
+    m_threads.reserve(thread_count);
+    for (auto i = 0u; i < thread_count; ++i) {
+        m_threads.emplace_back([this](std::stop_token stop) { work(stop); });
+    }
+}
+
+mope::job_system::~job_system()
+{
+    // Ask every worker to stop before joining any of them, so that we aren't
+    // waiting on them one at a time.
+    for (auto&& thread : m_threads) {
+        thread.request_stop();
+    }
+    m_threads.clear();
+}
+
+void mope::job_system::submit(std::function<void()> job)
+{
+    {
+        auto lock = std::scoped_lock{ m_mutex };
+        m_jobs.push_back(std::move(job));
+    }
+    m_condition.notify_one();
+}
+
+void mope::job_system::work(std::stop_token stop)
+{
+    while (true) {
+        auto job = std::function<void()>{};
+        {
+            auto lock = std::unique_lock{ m_mutex };
+            if (!m_condition.wait(lock, stop, [this]() { return !m_jobs.empty(); })) {
+                // We were asked to stop.
+                return;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        std::invoke(job);
+    }
+}
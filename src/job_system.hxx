@@ -0,0 +1,46 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace mope
+{
+    /// A pool of worker threads that run jobs submitted from any thread.
+    ///
+    /// Jobs are started in the order they were submitted, but may finish in any
+    /// order. Jobs must not throw; report failures through whatever the job
+    /// produces instead.
+    ///
+    /// Destroying the job system discards jobs that have not started yet and
+    /// waits for running jobs to finish.
+    class job_system
+    {
+    public:
+        /// @param thread_count The number of worker threads. Zero picks one
+        /// fewer than the number of hardware threads (but at least one), which
+        /// leaves a core free for the thread driving the game loop.
+        explicit job_system(unsigned int thread_count = 0);
+        ~job_system();
+
+        job_system(job_system const&) = delete;
+        auto operator=(job_system const&) -> job_system& = delete;
+
+        void submit(std::function<void()> job);
+
+    private:
+        void work(std::stop_token stop);
+
+        std::mutex m_mutex;
+        std::condition_variable_any m_condition;
+        std::deque<std::function<void()>> m_jobs;
+
+        // Declared last so that the workers are joined before anything they
+        // touch is destroyed.
+        std::vector<std::jthread> m_threads;
+    };
+} // namespace mope
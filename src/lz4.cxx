@@ -0,0 +1,184 @@
+#include "lz4.hxx"
+
+#include "mope_game_engine/game_engine_error.hxx"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+// q.v. https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+
+namespace
+{
+    constexpr auto MinMatch = 4uz;
+    constexpr auto LastLiterals = 5uz;          ///< The last bytes of a block are always literals...
+    constexpr auto MatchSearchLimit = 12uz;     ///< ...and the last match starts at least this far from the end.
+    constexpr auto MaxDistance = 65535uz;
+    constexpr auto HashBits = 16;
+
+    auto read_u32(std::byte const* p) -> std::uint32_t
+    {
+        auto value = std::uint32_t{};
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    auto hash_position(std::byte const* p) -> std::uint32_t
+    {
+        return (read_u32(p) * 2654435761u) >> (32 - HashBits);
+    }
+
+    void write_length_extension(std::vector<std::byte>& out, std::size_t length)
+    {
+        while (length >= 255) {
+            out.push_back(std::byte{ 255 });
+            length -= 255;
+        }
+        out.push_back(static_cast<std::byte>(length));
+    }
+
+    void write_sequence(
+        std::vector<std::byte>& out,
+        std::span<std::byte const> literals,
+        std::size_t offset,
+        std::size_t match_length)
+    {
+        auto literal_nibble = std::min(literals.size(), 15uz);
+        auto match_nibble = 0 == match_length ? 0uz : std::min(match_length - MinMatch, 15uz);
+        out.push_back(static_cast<std::byte>((literal_nibble << 4) | match_nibble));
+
+        if (15 == literal_nibble) {
+            write_length_extension(out, literals.size() - 15);
+        }
+        out.insert(out.end(), literals.begin(), literals.end());
+
+        // The final sequence is literals only.
+        if (0 != match_length) {
+            out.push_back(static_cast<std::byte>(offset & 0xff));
+            out.push_back(static_cast<std::byte>(offset >> 8));
+            if (15 == match_nibble) {
+                write_length_extension(out, match_length - MinMatch - 15);
+            }
+        }
+    }
+
+    [[noreturn]] void throw_malformed()
+    {
+        throw mope::game_engine_error{ "[LZ4] Malformed block." };
+    }
+}
+
+auto mope::lz4::compress(std::span<std::byte const> source) -> std::vector<std::byte>
+{
+    auto out = std::vector<std::byte>{};
+    out.reserve(source.size() + source.size() / 255 + 16);
+
+    auto const base = source.data();
+    auto const size = source.size();
+    auto anchor = 0uz;
+
+    if (size > MatchSearchLimit) {
+        // Positions are stored off by one, so that zero means "empty".
+        auto table = std::vector<std::uint32_t>(std::size_t{ 1 } << HashBits, 0);
+        auto const search_end = size - MatchSearchLimit;
+        auto const match_end = size - LastLiterals;
+
+        for (auto position = 0uz; position < search_end; ) {
+            auto& slot = table[hash_position(base + position)];
+            auto candidate = static_cast<std::size_t>(slot);
+            slot = static_cast<std::uint32_t>(position + 1);
+
+            if (0 == candidate
+                || position - (candidate - 1) > MaxDistance
+                || read_u32(base + candidate - 1) != read_u32(base + position))
+            {
+                ++position;
+                continue;
+            }
+
+            auto match = candidate - 1;
+            auto length = MinMatch;
+            while (position + length < match_end && base[match + length] == base[position + length]) {
+                ++length;
+            }
+
+            write_sequence(out, source.subspan(anchor, position - anchor), position - match, length);
+            position += length;
+            anchor = position;
+        }
+    }
+
+    write_sequence(out, source.subspan(anchor), 0, 0);
+    return out;
+}
+
+void mope::lz4::decompress(std::span<std::byte const> source, std::span<std::byte> destination)
+{
+    auto in = 0uz;
+    auto out = 0uz;
+
+    auto read_length_extension = [&](std::size_t length)
+        {
+            auto next = std::uint8_t{};
+            do {
+                if (in >= source.size()) {
+                    throw_malformed();
+                }
+                next = std::to_integer<std::uint8_t>(source[in++]);
+                length += next;
+            } while (255 == next);
+            return length;
+        };
+
+    while (in < source.size()) {
+        auto token = std::to_integer<std::size_t>(source[in++]);
+
+        auto literal_length = token >> 4;
+        if (15 == literal_length) {
+            literal_length = read_length_extension(literal_length);
+        }
+        if (source.size() - in < literal_length || destination.size() - out < literal_length) {
+            throw_malformed();
+        }
+        std::copy_n(source.data() + in, literal_length, destination.data() + out);
+        in += literal_length;
+        out += literal_length;
+
+        if (in == source.size()) {
+            // That was the final, literals-only sequence.
+            break;
+        }
+
+        if (source.size() - in < 2) {
+            throw_malformed();
+        }
+        auto offset = std::to_integer<std::size_t>(source[in])
+            | (std::to_integer<std::size_t>(source[in + 1]) << 8);
+        in += 2;
+        if (0 == offset || offset > out) {
+            throw_malformed();
+        }
+
+        auto match_length = token & 0x0f;
+        if (15 == match_length) {
+            match_length = read_length_extension(match_length);
+        }
+        match_length += MinMatch;
+        if (destination.size() - out < match_length) {
+            throw_malformed();
+        }
+
+        // Matches may overlap their own output (that's how runs are encoded),
+        // so copy forwards one byte at a time.
+        for (auto from = out - offset, end = out + match_length; out < end; ) {
+            destination[out++] = destination[from++];
+        }
+    }
+
+    if (out != destination.size()) {
+        throw_malformed();
+    }
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace mope::lz4
+{
+    /// Compress @p source as a single LZ4 block (not an LZ4 frame).
+    ///
+    /// This is a plain greedy compressor: it favors simplicity and speed over
+    /// ratio, which suits both offline packing and the small blobs of dormant
+    /// entities. The output can be read by any LZ4 block decoder.
+    auto compress(std::span<std::byte const> source) -> std::vector<std::byte>;
+
+    /// Decompress a single LZ4 block into @p destination, whose size must be
+    /// exactly the size of the original data.
+    ///
+    /// Throws @ref game_engine_error if the block is malformed.
+    void decompress(std::span<std::byte const> source, std::span<std::byte> destination);
+} // namespace mope::lz4
@@ -0,0 +1,141 @@
+#include "mapped_file.hxx"
+
+#include "mope_game_engine/game_engine_error.hxx"
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+#if defined(_WIN32)
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+
+#else // !defined(_WIN32)
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#endif // defined(_WIN32)
+
+namespace
+{
+    [[noreturn]] void throw_mapping_error(char const* task, char const* path)
+    {
+        throw mope::game_engine_error{
+            std::string{ "Failed " } + task + " \"" + path + "\"."
+        };
+    }
+}
+
+mope::mapped_file::mapped_file()
+    : m_data{ nullptr }
+    , m_size{ 0 }
+{
+}
+
+#if defined(_WIN32)
+
+mope::mapped_file::mapped_file(char const* path)
+    : mapped_file{}
+{
+    auto file = ::CreateFileA(
+        path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (INVALID_HANDLE_VALUE == file) {
+        throw_mapping_error("opening", path);
+    }
+
+    auto size = LARGE_INTEGER{};
+    if (!::GetFileSizeEx(file, &size)) {
+        ::CloseHandle(file);
+        throw_mapping_error("getting the size of", path);
+    }
+
+    // Mapping an empty file fails, but an empty file is a perfectly good file.
+    if (0 != size.QuadPart) {
+        auto mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        ::CloseHandle(file);
+        if (nullptr == mapping) {
+            throw_mapping_error("mapping", path);
+        }
+
+        // The view keeps the mapping object alive by itself.
+        m_data = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        ::CloseHandle(mapping);
+        if (nullptr == m_data) {
+            throw_mapping_error("mapping", path);
+        }
+        m_size = static_cast<std::size_t>(size.QuadPart);
+    }
+    else {
+        ::CloseHandle(file);
+    }
+}
+
+mope::mapped_file::~mapped_file()
+{
+    if (nullptr != m_data) {
+        ::UnmapViewOfFile(m_data);
+    }
+}
+
+#else // !defined(_WIN32)
+
+mope::mapped_file::mapped_file(char const* path)
+    : mapped_file{}
+{
+    auto fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (-1 == fd) {
+        throw_mapping_error("opening", path);
+    }
+
+    struct stat status{};
+    if (-1 == ::fstat(fd, &status)) {
+        ::close(fd);
+        throw_mapping_error("getting the size of", path);
+    }
+
+    // Mapping an empty file fails, but an empty file is a perfectly good file.
+    if (0 != status.st_size) {
+        auto size = static_cast<std::size_t>(status.st_size);
+        auto data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (MAP_FAILED == data) {
+            throw_mapping_error("mapping", path);
+        }
+        m_data = data;
+        m_size = size;
+    }
+    else {
+        ::close(fd);
+    }
+}
+
+mope::mapped_file::~mapped_file()
+{
+    if (nullptr != m_data) {
+        ::munmap(const_cast<void*>(m_data), m_size);
+    }
+}
+
+#endif // defined(_WIN32)
+
+mope::mapped_file::mapped_file(mapped_file&& that) noexcept
+    : mapped_file{}
+{
+    swap(*this, that);
+}
+
+auto mope::mapped_file::operator=(mapped_file that) noexcept -> mapped_file&
+{
+    swap(*this, that);
+    return *this;
+}
+
+auto mope::mapped_file::contents() const -> std::span<std::byte const>
+{
+    return { static_cast<std::byte const*>(m_data), m_size };
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <utility>
+
+namespace mope
+{
+    /// A read-only view of a whole file, mapped into memory.
+    ///
+    /// Pages are only read from disk as they are touched, and the contents are
+    /// shared with the OS page cache, so handing out spans of a mapped file
+    /// costs nothing up front.
+    class mapped_file final
+    {
+    public:
+        mapped_file();
+
+        /// Throws @ref game_engine_error if the file can't be opened or mapped.
+        explicit mapped_file(char const* path);
+
+        mapped_file(mapped_file const&) = delete;
+        mapped_file(mapped_file&& that) noexcept;
+        ~mapped_file();
+
+        auto operator=(mapped_file that) noexcept -> mapped_file&;
+
+        auto contents() const -> std::span<std::byte const>;
+
+        friend void swap(mapped_file& a, mapped_file& b) noexcept
+        {
+            using std::swap;
+            swap(a.m_data, b.m_data);
+            swap(a.m_size, b.m_size);
+        }
+
+    private:
+        void const* m_data;
+        std::size_t m_size;
+    };
+} // namespace mope
@@ -0,0 +1,146 @@
+#include "mip_chain.hxx"
+
+#include "mope_vec/mope_vec.hxx"
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define MOPE_MIP_CHAIN_SSE2
+#include <emmintrin.h>
+#endif // defined(__SSE2__) || defined(_M_X64)
+
+namespace
+{
+    /// Average 2x2 squares of 4-channel pixels from two source rows into up
+    /// to @p count pixels of @p out. Returns how many it did, which is where
+    /// the scalar loop picks up.
+    auto downsample_rgba_row(
+        std::byte const* row0,
+        std::byte const* row1,
+        std::byte* out,
+        std::size_t count,
+        std::size_t source_width) -> std::size_t
+    {
+#if defined(MOPE_MIP_CHAIN_SSE2)
+        // Two output pixels at a time, from four source pixels in each row,
+        // as long as all four are in the row.
+        auto x = 0uz;
+        auto const zero = _mm_setzero_si128();
+        auto const two = _mm_set1_epi16(2);
+        for (; x + 2 <= count && 2 * x + 3 < source_width; x += 2) {
+            auto top = _mm_loadu_si128(reinterpret_cast<__m128i const*>(row0 + 8 * x));
+            auto bottom = _mm_loadu_si128(reinterpret_cast<__m128i const*>(row1 + 8 * x));
+
+            // Widen to 16 bits and add the rows: source pixels 0 and 1 in
+            // `left`, 2 and 3 in `right`.
+            auto left = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+            auto right = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+
+            // Add each pair of neighbors, which leaves the sums in the low
+            // halves, and put the two sums together.
+            left = _mm_add_epi16(left, _mm_srli_si128(left, 8));
+            right = _mm_add_epi16(right, _mm_srli_si128(right, 8));
+            auto sums = _mm_unpacklo_epi64(left, right);
+
+            // Round to nearest, like the scalar loop.
+            auto averages = _mm_srli_epi16(_mm_add_epi16(sums, two), 2);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 4 * x), _mm_packus_epi16(averages, zero));
+        }
+        return x;
+#else // !defined(MOPE_MIP_CHAIN_SSE2)
+        (void)row0;
+        (void)row1;
+        (void)out;
+        (void)count;
+        (void)source_width;
+        return 0;
+#endif // defined(MOPE_MIP_CHAIN_SSE2)
+    }
+}
+
+auto mope::downsample(std::span<std::byte const> pixels, vec2i size, int channels) -> std::vector<std::byte>
+{
+    auto width = static_cast<std::size_t>(size.x());
+    auto height = static_cast<std::size_t>(size.y());
+    auto stride = static_cast<std::size_t>(channels);
+    auto half_width = std::max(width / 2, 1uz);
+    auto half_height = std::max(height / 2, 1uz);
+
+    auto result = std::vector<std::byte>(half_width * half_height * stride);
+    for (auto y = 0uz; y < half_height; ++y) {
+        auto row0 = pixels.data() + std::min(2 * y, height - 1) * width * stride;
+        auto row1 = pixels.data() + std::min(2 * y + 1, height - 1) * width * stride;
+        auto out = result.data() + y * half_width * stride;
+
+        auto x = 4 == stride
+            ? downsample_rgba_row(row0, row1, out, half_width, width)
+            : 0uz;
+        for (; x < half_width; ++x) {
+            auto x0 = std::min(2 * x, width - 1) * stride;
+            auto x1 = std::min(2 * x + 1, width - 1) * stride;
+            for (auto c = 0uz; c < stride; ++c) {
+                auto sum = static_cast<unsigned int>(row0[x0 + c]) + static_cast<unsigned int>(row0[x1 + c])
+                    + static_cast<unsigned int>(row1[x0 + c]) + static_cast<unsigned int>(row1[x1 + c]);
+                out[x * stride + c] = static_cast<std::byte>((sum + 2) / 4);
+            }
+        }
+    }
+    return result;
+}
+
+auto mope::mip_level_count(vec2i size) -> int
+{
+    auto levels = 1;
+    while (size.x() > 1 || size.y() > 1) {
+        size = vec2i{ std::max(size.x() / 2, 1), std::max(size.y() / 2, 1) };
+        ++levels;
+    }
+    return levels;
+}
+
+auto mope::mip_level_size(vec2i size, int level) -> vec2i
+{
+    return vec2i{ std::max(size.x() >> level, 1), std::max(size.y() >> level, 1) };
+}
+
+auto mope::build_mip_chain(std::span<std::byte const> pixels, vec2i size, int channels)
+    -> std::vector<std::vector<std::byte>>
+{
+    auto levels = std::vector<std::vector<std::byte>>{};
+    levels.reserve(static_cast<std::size_t>(mip_level_count(size)));
+    levels.emplace_back(pixels.begin(), pixels.end());
+    while (size.x() > 1 || size.y() > 1) {
+        levels.push_back(downsample(levels.back(), size, channels));
+        size = vec2i{ std::max(size.x() / 2, 1), std::max(size.y() / 2, 1) };
+    }
+    return levels;
+}
+
+auto mope::append_mip_chain(std::vector<std::byte>& pixels, vec2i size, int channels) -> int
+{
+    auto total = pixels.size();
+    for (auto level = size; level.x() > 1 || level.y() > 1;) {
+        level = vec2i{ std::max(level.x() / 2, 1), std::max(level.y() / 2, 1) };
+        total += static_cast<std::size_t>(level.x()) * static_cast<std::size_t>(level.y())
+            * static_cast<std::size_t>(channels);
+    }
+    pixels.reserve(total);
+
+    auto level_bytes = pixels.size();
+    auto levels = 1;
+    while (size.x() > 1 || size.y() > 1) {
+        // Downsample out of the previous level before appending, since
+        // appending may move it.
+        auto previous = std::span<std::byte const>{ pixels }.last(level_bytes);
+        auto next = downsample(previous, size, channels);
+        pixels.insert(pixels.end(), next.begin(), next.end());
+
+        level_bytes = next.size();
+        size = vec2i{ std::max(size.x() / 2, 1), std::max(size.y() / 2, 1) };
+        ++levels;
+    }
+    return levels;
+}
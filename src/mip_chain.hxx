@@ -0,0 +1,35 @@
+#pragma once
+
+#include "mope_vec/mope_vec.hxx"
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace mope
+{
+    /// Halve an image of tightly packed 8-bit channels, making each pixel the
+    /// average of a 2x2 square (a box filter). Each side is rounded down,
+    /// but kept at least 1, and odd last rows and columns are averaged with
+    /// themselves.
+    ///
+    /// Four-channel images are done two pixels at a time with SSE2, where
+    /// available, with the same results.
+    auto downsample(std::span<std::byte const> pixels, vec2i size, int channels) -> std::vector<std::byte>;
+
+    /// How many levels a full mip chain for an image of this size has.
+    auto mip_level_count(vec2i size) -> int;
+
+    /// The size of level @p level of an image's mip chain.
+    auto mip_level_size(vec2i size, int level) -> vec2i;
+
+    /// Return the image and each smaller mip level, down to 1x1.
+    auto build_mip_chain(std::span<std::byte const> pixels, vec2i size, int channels)
+        -> std::vector<std::vector<std::byte>>;
+
+    /// Append each smaller mip level of the image in @p pixels to it, as
+    /// @ref gl::texture_extra_options::levels expects them.
+    ///
+    /// @return How many levels there are now.
+    auto append_mip_chain(std::vector<std::byte>& pixels, vec2i size, int channels) -> int;
+} // namespace mope
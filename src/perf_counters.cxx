@@ -0,0 +1,142 @@
+#include "perf_counters.hxx"
+
+#include "mope_game_engine/components/engine_stats.hxx"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__linux__)
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace
+{
+    struct counter
+    {
+        std::uint32_t type;
+        std::uint64_t config;
+        std::uint64_t mope::perf_counts::* member;
+    };
+
+    constexpr auto DtlbReadMisses = std::uint64_t{ PERF_COUNT_HW_CACHE_DTLB }
+        | (std::uint64_t{ PERF_COUNT_HW_CACHE_OP_READ } << 8)
+        | (std::uint64_t{ PERF_COUNT_HW_CACHE_RESULT_MISS } << 16);
+
+    // In the order of the members of perf_counts. The hardware group opens
+    // all of these; the software group only the last two.
+    constexpr auto Counters = std::array{
+        counter{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, &mope::perf_counts::cycles },
+        counter{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, &mope::perf_counts::instructions },
+        counter{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, &mope::perf_counts::cache_misses },
+        counter{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, &mope::perf_counts::branch_misses },
+        counter{ PERF_TYPE_HW_CACHE, DtlbReadMisses, &mope::perf_counts::dtlb_misses },
+        counter{ PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, &mope::perf_counts::task_clock_ns },
+        counter{ PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS, &mope::perf_counts::page_faults },
+    };
+    constexpr auto FirstSoftwareCounter = 5uz;
+
+    auto perf_event_open(perf_event_attr& attr, int group_fd) -> int
+    {
+        // Count this thread, on whichever CPU it runs.
+        return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+    }
+}
+
+mope::perf_counters::perf_counters()
+    : m_fds{ }
+    , m_first{ 0 }
+    , m_count{ 0 }
+    , m_source{ perf_counter_source::none }
+{
+    if (open_group(0, Counters.size())) {
+        m_source = perf_counter_source::hardware;
+    }
+    else if (open_group(FirstSoftwareCounter, Counters.size() - FirstSoftwareCounter)) {
+        m_source = perf_counter_source::software;
+    }
+}
+
+mope::perf_counters::~perf_counters()
+{
+    close_group();
+}
+
+auto mope::perf_counters::read() -> perf_counts
+{
+    auto counts = perf_counts{};
+    if (0 == m_count) {
+        return counts;
+    }
+
+    // With PERF_FORMAT_GROUP, the leader reads as the number of counters,
+    // followed by each counter's value.
+    auto buffer = std::array<std::uint64_t, 1 + MaxCounters>{};
+    auto size = static_cast<::ssize_t>((1 + m_count) * sizeof(std::uint64_t));
+    if (size != ::read(m_fds[0], buffer.data(), static_cast<std::size_t>(size))) {
+        return counts;
+    }
+
+    for (auto i = 0uz; i < m_count; ++i) {
+        counts.*Counters[m_first + i].member = buffer[1 + i];
+    }
+    return counts;
+}
+
+auto mope::perf_counters::open_group(std::size_t first, std::size_t count) -> bool
+{
+    m_first = first;
+    for (m_count = 0; m_count < count; ++m_count) {
+        auto const& counter = Counters[first + m_count];
+
+        auto attr = perf_event_attr{};
+        attr.size = sizeof(attr);
+        attr.type = counter.type;
+        attr.config = counter.config;
+        attr.read_format = PERF_FORMAT_GROUP;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        // The group starts counting as soon as its leader is open, and
+        // members count whenever the leader does.
+        auto leader = 0 == m_count ? -1 : m_fds[0];
+        auto fd = perf_event_open(attr, leader);
+        if (fd < 0) {
+            close_group();
+            return false;
+        }
+        m_fds[m_count] = fd;
+    }
+    return true;
+}
+
+void mope::perf_counters::close_group()
+{
+    // Members first, then the leader.
+    while (m_count > 0) {
+        ::close(m_fds[--m_count]);
+    }
+}
+
+#else // !defined(__linux__)
+
+mope::perf_counters::perf_counters()
+    : m_source{ perf_counter_source::none }
+{
+}
+
+mope::perf_counters::~perf_counters() = default;
+
+auto mope::perf_counters::read() -> perf_counts
+{
+    return perf_counts{};
+}
+
+#endif // defined(__linux__)
+
+auto mope::perf_counters::source() const -> perf_counter_source
+{
+    return m_source;
+}
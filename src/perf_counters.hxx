@@ -0,0 +1,51 @@
+#pragma once
+
+#include "mope_game_engine/components/engine_stats.hxx"
+
+#include <array>
+#include <cstddef>
+
+namespace mope
+{
+    /// Counts what the CPU and kernel do on the thread that made this.
+    ///
+    /// On Linux, this opens a group of `perf_event_open` counters, so that
+    /// they can all be read with one system call. If the CPU counters can't
+    /// be opened (most containers and VMs don't allow them) it falls back to
+    /// the kernel's own task clock and page fault counters. Elsewhere, and if
+    /// even those can't be opened, @ref read() returns zeros.
+    ///
+    /// Only user-space work is counted, which is all that unprivileged
+    /// processes are usually allowed to see.
+    class perf_counters
+    {
+    public:
+        perf_counters();
+        ~perf_counters();
+
+        perf_counters(perf_counters const&) = delete;
+        auto operator=(perf_counters const&) -> perf_counters& = delete;
+
+        auto source() const -> perf_counter_source;
+
+        /// The running totals since this was made. Subtract two readings to
+        /// get the counts for the work between them.
+        auto read() -> perf_counts;
+
+    private:
+        static constexpr auto MaxCounters = 7uz;
+
+#if defined(__linux__)
+        auto open_group(std::size_t first, std::size_t count) -> bool;
+        void close_group();
+
+        /// The open counters, the first being the group leader. They count
+        /// the members of @ref perf_counts in order, starting at `m_first`.
+        std::array<int, MaxCounters> m_fds;
+        std::size_t m_first;
+        std::size_t m_count;
+#endif // defined(__linux__)
+
+        perf_counter_source m_source;
+    };
+} // namespace mope
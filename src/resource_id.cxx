@@ -1,8 +1,10 @@
 #include "mope_game_engine/resource_id.hxx"
 
+#include <atomic>
+
 namespace
 {
-    auto OutstandingCount{ 0 };
+    auto OutstandingCount = std::atomic<int>{ 0 };
 }
 
 auto mope::gl::resource_id::outstanding_count() -> int
@@ -20,7 +22,7 @@ mope::gl::resource_id::resource_id()
 mope::gl::resource_id::resource_id(unsigned int id, void (*release)(unsigned int))
     : m_id{ id }
     , m_release{ release }
-    , m_use_count{ new long(1) }
+    , m_use_count{ new std::atomic<long>(1) }
 {
     ++OutstandingCount;
 }
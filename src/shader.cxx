@@ -5,51 +5,155 @@
 #include "mope_vec/mope_vec.hxx"
 #include "glad/glad.h"
 
+#include <cstring>
+#include <memory>
+
 namespace
 {
-    auto compile_shader(const char* src, GLenum type) -> GLuint
+    // From KHR_parallel_shader_compile, which our GL loader doesn't know about.
+    constexpr auto GL_COMPLETION_STATUS_KHR = GLenum{ 0x91B1 };
+
+    auto parallel_compile_supported() -> bool
+    {
+        static auto const supported = []()
+            {
+                // glGetStringi is only there from GL 3.0 on.
+                if (!::glGetStringi) {
+                    return false;
+                }
+
+                auto count = GLint{};
+                ::glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+                for (auto i = 0; i < count; ++i) {
+                    auto name = reinterpret_cast<char const*>(
+                        ::glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+                    if (!name) {
+                        continue;
+                    }
+                    if (0 == std::strcmp(name, "GL_KHR_parallel_shader_compile")
+                        || 0 == std::strcmp(name, "GL_ARB_parallel_shader_compile"))
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }();
+        return supported;
+    }
+
+    auto start_compile(const char* src, GLenum type) -> mope::gl::resource_id
     {
-        GLuint shader = ::glCreateShader(type);
+        auto shader = mope::gl::resource_id{ ::glCreateShader(type), ::glDeleteShader };
         ::glShaderSource(shader, 1, &src, 0);
         ::glCompileShader(shader);
+        return shader;
+    }
 
+    void check_compile(GLuint shader)
+    {
         int success;
         ::glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
         if (!success) {
             throw mope::game_engine_error{ "Shader compilation failed." };
         }
+    }
+
+    auto compile_shader(const char* src, GLenum type) -> mope::gl::resource_id
+    {
+        auto shader = start_compile(src, type);
+        check_compile(shader);
         return shader;
     }
 
-    void link_shader_program(GLuint program, GLuint vert_shader, GLuint frag_shader)
+    auto link_shader_program(GLuint program, GLuint vert_shader, GLuint frag_shader) -> bool
     {
         ::glAttachShader(program, vert_shader);
         ::glAttachShader(program, frag_shader);
         ::glLinkProgram(program);
+        ::glDetachShader(program, frag_shader);
+        ::glDetachShader(program, vert_shader);
 
         int success;
         ::glGetProgramiv(program, GL_LINK_STATUS, &success);
-        if (!success) {
-            throw mope::game_engine_error{ "Shader linking failed." };
+        return success;
+    }
+}
+
+void mope::gl::shader::make(char const* vert_source, char const* frag_source)
+{
+    auto vert_shader = compile_shader(vert_source, GL_VERTEX_SHADER);
+    auto frag_shader = compile_shader(frag_source, GL_FRAGMENT_SHADER);
+
+    // A failed link leaves a program unusable, so when we are remaking a
+    // program that is already in use (i.e., reloading it), try the link on a
+    // scratch program first. That way a broken edit leaves the old program
+    // working, and every copy of this shader keeps pointing at the same name.
+    if (m_id) {
+        auto scratch = resource_id{ ::glCreateProgram(), ::glDeleteProgram };
+        if (!link_shader_program(scratch, vert_shader, frag_shader)) {
+            throw game_engine_error{ "Shader linking failed." };
         }
+    }
 
-        ::glDetachShader(program, frag_shader);
-        ::glDetachShader(program, vert_shader);
+    // This supersedes any link that was still in flight. Its shaders are
+    // still attached, and linking alongside them would give every stage two
+    // `main()`s.
+    if (m_pending && m_pending->vert_shader) {
+        ::glDetachShader(m_id, m_pending->frag_shader);
+        ::glDetachShader(m_id, m_pending->vert_shader);
+        *m_pending = pending_link{};
     }
 
-    inline void delete_shader(GLuint shader)
-    {
-        ::glDeleteShader(shader);
+    if (!link_shader_program(ensure_id(), vert_shader, frag_shader)) {
+        throw game_engine_error{ "Shader linking failed." };
     }
 }
 
-void mope::gl::shader::make(char const* vert_source, char const* frag_source)
+void mope::gl::shader::make_async(char const* vert_source, char const* frag_source)
 {
-    auto vert_shader = compile_shader(vert_source, GL_VERTEX_SHADER);
-    auto frag_shader = compile_shader(frag_source, GL_FRAGMENT_SHADER);
-    link_shader_program(ensure_id(), vert_shader, frag_shader);
-    delete_shader(frag_shader);
-    delete_shader(vert_shader);
+    if (m_id) {
+        make(vert_source, frag_source);
+        return;
+    }
+
+    // Don't ask for any status here; asking is what makes the driver finish.
+    auto pending = std::make_shared<pending_link>(
+        start_compile(vert_source, GL_VERTEX_SHADER),
+        start_compile(frag_source, GL_FRAGMENT_SHADER)
+    );
+    ::glAttachShader(ensure_id(), pending->vert_shader);
+    ::glAttachShader(ensure_id(), pending->frag_shader);
+    ::glLinkProgram(ensure_id());
+    m_pending = std::move(pending);
+}
+
+auto mope::gl::shader::ready() -> bool
+{
+    if (!m_pending || !m_pending->vert_shader) {
+        return true;
+    }
+
+    if (parallel_compile_supported()) {
+        auto complete = GLint{};
+        ::glGetProgramiv(m_id, GL_COMPLETION_STATUS_KHR, &complete);
+        if (!complete) {
+            return false;
+        }
+    }
+
+    check_compile(m_pending->vert_shader);
+    check_compile(m_pending->frag_shader);
+
+    int success;
+    ::glGetProgramiv(m_id, GL_LINK_STATUS, &success);
+    if (!success) {
+        throw game_engine_error{ "Shader linking failed." };
+    }
+
+    ::glDetachShader(m_id, m_pending->frag_shader);
+    ::glDetachShader(m_id, m_pending->vert_shader);
+    *m_pending = pending_link{};
+    return true;
 }
 
 void mope::gl::shader::bind()
@@ -84,6 +188,12 @@ void mope::gl::shader::set_uniform_impl(char const* name, vec2f const& value)
     ::glUniform2fv(loc, 1, value.data());
 }
 
+void mope::gl::shader::set_uniform_impl(char const* name, vec3f const& value)
+{
+    GLint loc = ::glGetUniformLocation(ensure_id(), name);
+    ::glUniform3fv(loc, 1, value.data());
+}
+
 void mope::gl::shader::set_uniform_impl(char const* name, mat2f const& value)
 {
     GLint loc = ::glGetUniformLocation(ensure_id(), name);
@@ -3,12 +3,34 @@
 #include "mope_game_engine/resource_id.hxx"
 #include "mope_vec/mope_vec.hxx"
 
+#include <memory>
+
 namespace mope::gl
 {
     class shader
     {
     public:
         void make(char const* vert_source, char const* frag_source);
+
+        /// Start compiling and linking, without waiting for the driver to
+        /// finish. The program can't be used until @ref ready() returns true.
+        ///
+        /// Issuing several of these before asking whether any of them are
+        /// ready lets the driver compile them all at once, on its own threads
+        /// if it supports `KHR_parallel_shader_compile`.
+        ///
+        /// Remaking a program that already exists can't be deferred, since
+        /// copies of this shader may be drawing with it; that falls back to
+        /// @ref make().
+        void make_async(char const* vert_source, char const* frag_source);
+
+        /// Return whether the program has finished linking. This never blocks
+        /// if the driver supports `KHR_parallel_shader_compile`, and otherwise
+        /// waits for it to finish.
+        ///
+        /// Throws @ref game_engine_error if compiling or linking failed.
+        auto ready() -> bool;
+
         void bind();
 
         template <typename T>
@@ -18,14 +40,24 @@ namespace mope::gl
         }
 
     private:
+        /// The shader objects of a link that hasn't been checked yet. This is
+        /// shared by every copy, so that they agree about whether it's done.
+        struct pending_link
+        {
+            resource_id vert_shader;
+            resource_id frag_shader;
+        };
+
         auto ensure_id() -> resource_id const&;
         void set_uniform_impl(char const* name, float value);
         void set_uniform_impl(char const* name, int value);
         void set_uniform_impl(char const* name, vec2f const& value);
+        void set_uniform_impl(char const* name, vec3f const& value);
         void set_uniform_impl(char const* name, mat2f const& value);
         void set_uniform_impl(char const* name, mat3f const& value);
         void set_uniform_impl(char const* name, mat4f const& value);
 
         resource_id m_id;
+        std::shared_ptr<pending_link> m_pending;
     };
 } // namespace mope::gl
@@ -0,0 +1,106 @@
+#include "shm_ring.hxx"
+
+#include "mope_game_engine/game_engine_error.hxx"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <span>
+#include <vector>
+
+// Lock-free atomics are also address-free, which is what lets two processes
+// share them through different mappings.
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+/// The positions only ever grow; a position's place in the ring is the
+/// position modulo the capacity. The producer owns `head` and the consumer
+/// owns `tail`, on separate cache lines so that they don't slow each other
+/// down.
+struct mope::shm_ring::header
+{
+    alignas(64) std::atomic<std::uint64_t> head;
+    alignas(64) std::atomic<std::uint64_t> tail;
+    std::uint64_t capacity;
+};
+
+auto mope::shm_ring::footprint(std::size_t capacity) -> std::size_t
+{
+    return sizeof(header) + capacity;
+}
+
+void mope::shm_ring::initialize(std::span<std::byte> memory, std::size_t capacity)
+{
+    if (memory.size() < footprint(capacity) || capacity <= sizeof(std::uint32_t)) {
+        throw game_engine_error{ "Shared memory ring is too small." };
+    }
+    new (memory.data()) header{ { 0 }, { 0 }, capacity };
+}
+
+mope::shm_ring::shm_ring(std::span<std::byte> memory)
+    : m_header{ std::launder(reinterpret_cast<header*>(memory.data())) }
+    , m_data{ memory.data() + sizeof(header) }
+    , m_capacity{ static_cast<std::size_t>(m_header->capacity) }
+{
+}
+
+auto mope::shm_ring::try_push(std::span<std::byte const> message) -> bool
+{
+    auto head = m_header->head.load(std::memory_order_relaxed);
+    auto tail = m_header->tail.load(std::memory_order_acquire);
+    auto needed = sizeof(std::uint32_t) + message.size();
+    if (needed > m_capacity - static_cast<std::size_t>(head - tail)) {
+        return false;
+    }
+
+    auto length = static_cast<std::uint32_t>(message.size());
+    copy_in(head, std::as_bytes(std::span{ &length, 1 }));
+    copy_in(head + sizeof(length), message);
+    m_header->head.store(head + needed, std::memory_order_release);
+    return true;
+}
+
+auto mope::shm_ring::try_pop(std::vector<std::byte>& message) -> bool
+{
+    auto tail = m_header->tail.load(std::memory_order_relaxed);
+    auto head = m_header->head.load(std::memory_order_acquire);
+    if (head == tail) {
+        return false;
+    }
+
+    auto length = std::uint32_t{};
+    copy_out(tail, std::as_writable_bytes(std::span{ &length, 1 }));
+    message.resize(length);
+    copy_out(tail + sizeof(length), message);
+    m_header->tail.store(tail + sizeof(length) + length, std::memory_order_release);
+    return true;
+}
+
+auto mope::shm_ring::max_message() const -> std::size_t
+{
+    return m_capacity - sizeof(std::uint32_t);
+}
+
+void mope::shm_ring::copy_in(std::uint64_t position, std::span<std::byte const> bytes)
+{
+    if (bytes.empty()) {
+        return;
+    }
+    auto offset = static_cast<std::size_t>(position % m_capacity);
+    auto first = std::min(bytes.size(), m_capacity - offset);
+    std::memcpy(m_data + offset, bytes.data(), first);
+    std::memcpy(m_data, bytes.data() + first, bytes.size() - first);
+}
+
+void mope::shm_ring::copy_out(std::uint64_t position, std::span<std::byte> bytes) const
+{
+    if (bytes.empty()) {
+        return;
+    }
+    auto offset = static_cast<std::size_t>(position % m_capacity);
+    auto first = std::min(bytes.size(), m_capacity - offset);
+    std::memcpy(bytes.data(), m_data + offset, first);
+    std::memcpy(bytes.data() + first, m_data, bytes.size() - first);
+}
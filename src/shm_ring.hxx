@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace mope
+{
+    /// A queue of byte messages from one producer to one consumer, laid out
+    /// in memory that both can see, such as a shared mapping between
+    /// processes. Nothing in it is a pointer, so each side may map it at a
+    /// different address.
+    ///
+    /// Each message is a u32 length followed by its bytes, and may wrap
+    /// around the end of the ring. Neither side ever waits: a push that
+    /// doesn't fit and a pop of an empty ring just fail.
+    class shm_ring final
+    {
+    public:
+        /// The bytes of a ring that can hold @p capacity bytes of messages,
+        /// including their lengths.
+        static auto footprint(std::size_t capacity) -> std::size_t;
+
+        /// Lay out an empty ring at the start of @p memory, which must be
+        /// aligned for `std::atomic<std::uint64_t>` and be at least
+        /// @ref footprint bytes. Do this once, before either side uses it.
+        static void initialize(std::span<std::byte> memory, std::size_t capacity);
+
+        /// View a ring laid out with @ref initialize.
+        explicit shm_ring(std::span<std::byte> memory);
+
+        /// Append @p message, unless there isn't room for it yet. Only the
+        /// producer may call this.
+        auto try_push(std::span<std::byte const> message) -> bool;
+
+        /// Replace @p message with the oldest message, if there is one. Only
+        /// the consumer may call this.
+        auto try_pop(std::vector<std::byte>& message) -> bool;
+
+        /// The largest message that fits in an empty ring.
+        auto max_message() const -> std::size_t;
+
+    private:
+        struct header;
+
+        void copy_in(std::uint64_t position, std::span<std::byte const> bytes);
+        void copy_out(std::uint64_t position, std::span<std::byte> bytes) const;
+
+        header* m_header;
+        std::byte* m_data;
+        std::size_t m_capacity;
+    };
+} // namespace mope
@@ -0,0 +1,125 @@
+#include "mope_game_engine/simulation_lod.hxx"
+
+#include "mope_game_engine/components/transform.hxx"
+#include "mope_game_engine/components/world_focus.hxx"
+#include "mope_game_engine/game_scene.hxx"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+    using namespace mope;
+
+    using phase_lists = std::array<
+        std::vector<simulation_lod_component*>,
+        simulation_lod_component::ReducedInterval
+    >;
+
+    auto size_of(std::vector<simulation_lod_component*> const& phase) -> std::size_t
+    {
+        return phase.size();
+    }
+
+    auto emptiest(phase_lists const& phases) -> std::uint32_t
+    {
+        auto iter = std::ranges::min_element(phases, { }, size_of);
+        return static_cast<std::uint32_t>(iter - phases.begin());
+    }
+
+    auto fullest(phase_lists const& phases) -> std::uint32_t
+    {
+        auto iter = std::ranges::max_element(phases, { }, size_of);
+        return static_cast<std::uint32_t>(iter - phases.begin());
+    }
+
+    /// Give @p lod a new LOD and phase from @p tick on, remembering when it
+    /// was last simulated under the old ones.
+    void move_to(simulation_lod_component& lod, simulation_lod level, std::uint32_t phase, std::uint64_t tick)
+    {
+        if (level == lod.lod && phase == lod.phase) {
+            return;
+        }
+        lod.last_tick_before = lod.last_simulated_before(tick);
+        lod.since_tick = tick;
+        lod.lod = level;
+        lod.phase = phase;
+    }
+}
+
+mope::simulation_lod_system::simulation_lod_system(simulation_lod_options options)
+    : m_options{ options }
+    , m_tick{ 0 }
+{
+}
+
+void mope::simulation_lod_system::operator()(game_scene& scene, tick_event const&)
+{
+    if (0 == m_tick % std::max(m_options.update_interval, 1u)) {
+        update_lods(scene);
+    }
+    scene.set_component(simulation_clock{ { }, m_tick });
+    ++m_tick;
+}
+
+void mope::simulation_lod_system::update_lods(game_scene& scene)
+{
+    auto focus = scene.get_component<world_focus>();
+    if (nullptr == focus) {
+        return;
+    }
+
+    auto full_squared = m_options.full_distance * m_options.full_distance;
+    auto reduced_squared = m_options.reduced_distance * m_options.reduced_distance;
+
+    // Entities that stay reduced keep their phase, so that they aren't
+    // simulated twice (or skipped) around the update. Entities that become
+    // reduced are put in the emptiest phases. Whatever changes takes effect
+    // from this tick, which is why m_tick hasn't been advanced yet.
+    auto phases = phase_lists{};
+    auto newly_reduced = std::vector<simulation_lod_component*>{};
+    for (auto&& [lod, transform] : scene.query<simulation_lod_component, transform_component>().exec()) {
+        auto dx = transform.x_position() - focus->position.x();
+        auto dy = transform.y_position() - focus->position.y();
+        auto distance_squared = dx * dx + dy * dy;
+
+        auto level = distance_squared < full_squared ? simulation_lod::full
+            : distance_squared < reduced_squared ? simulation_lod::reduced
+            : simulation_lod::frozen;
+
+        if (simulation_lod::reduced != level) {
+            move_to(lod, level, lod.phase, m_tick);
+            continue;
+        }
+        if (simulation_lod::reduced == lod.lod && lod.phase < phases.size()) {
+            phases[lod.phase].push_back(&lod);
+        }
+        else {
+            newly_reduced.push_back(&lod);
+        }
+    }
+
+    for (auto&& lod : newly_reduced) {
+        auto phase = emptiest(phases);
+        move_to(*lod, simulation_lod::reduced, phase, m_tick);
+        phases[phase].push_back(lod);
+    }
+
+    // Reduced entities that have left or been destroyed can unbalance the
+    // phases that remain. Even them out, at the cost of moving a few entities
+    // to a different tick once.
+    while (true) {
+        auto from = fullest(phases);
+        auto to = emptiest(phases);
+        if (phases[from].size() <= phases[to].size() + 1) {
+            break;
+        }
+        auto lod = phases[from].back();
+        phases[from].pop_back();
+        move_to(*lod, simulation_lod::reduced, to, m_tick);
+        phases[to].push_back(lod);
+    }
+}
@@ -7,43 +7,119 @@
 #include "mope_vec/mope_vec.hxx"
 #include "vao.hxx"
 
+#include <algorithm>
 #include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <utility>
 
-mope::sprite_renderer::sprite_renderer()
-    : m_shader{ }
-    , m_vao{ }
-    , m_vbo{ }
-    , m_ebo{ }
+namespace
 {
-    m_shader.make(R"%%(
+    constexpr auto TextureUnit = 0;
+    constexpr auto ArrayTextureUnit = 1;
+
+    /// Round to the nearest half float, for the sprite size.
+    auto to_half(float value) -> std::uint16_t
+    {
+        auto bits = std::bit_cast<std::uint32_t>(value);
+        auto sign = (bits >> 16) & 0x8000u;
+        auto exponent = static_cast<int>((bits >> 23) & 0xffu) - 127 + 15;
+        auto mantissa = bits & 0x7fffffu;
+
+        // Too big, infinite or NaN.
+        if (exponent >= 31) {
+            auto nan = (bits & 0x7fffffffu) > 0x7f800000u;
+            return static_cast<std::uint16_t>(sign | 0x7c00u | (nan ? 0x200u : 0u));
+        }
+
+        // Too small for a normal half, so subnormal or zero.
+        if (exponent <= 0) {
+            if (exponent < -10) {
+                return static_cast<std::uint16_t>(sign);
+            }
+            mantissa |= 0x800000u;
+            auto shift = static_cast<unsigned int>(14 - exponent);
+            auto half = (mantissa >> shift) + ((mantissa >> (shift - 1)) & 1u);
+            return static_cast<std::uint16_t>(sign | half);
+        }
+
+        // Rounding may carry into the exponent, which is still right.
+        auto half = (static_cast<std::uint32_t>(exponent) << 10) | (mantissa >> 13);
+        half += (mantissa >> 12) & 1u;
+        return static_cast<std::uint16_t>(sign | half);
+    }
+
+    auto to_unorm16(float value) -> std::uint16_t
+    {
+        return static_cast<std::uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+    }
+
+    /// Quantize a position relative to a batch's origin, or return false if
+    /// it's too far away.
+    auto quantize_offset(mope::vec3f const& position, mope::vec3f const& origin, std::int16_t (&offset)[3]) -> bool
+    {
+        for (auto i = 0uz; i < 3; ++i) {
+            auto steps = std::lround((position[i] - origin[i]) * mope::sprite_instance::PositionScale);
+            if (steps < -32768 || steps > 32767) {
+                return false;
+            }
+            offset[i] = static_cast<std::int16_t>(steps);
+        }
+        return true;
+    }
+}
+
+void mope::sprite_renderer::make_default_shader(gl::shader& shader)
+{
+    shader.make_async(R"%%(
 #version 330 core
-uniform mat4 u_model;
 uniform mat4 u_view;
 uniform mat4 u_projection;
+uniform vec3 u_origin;
 layout (location = 0) in vec3 i_pos;
 layout (location = 1) in vec2 i_tex_coord;
+layout (location = 2) in vec3 i_offset;
+layout (location = 3) in vec2 i_size;
+layout (location = 4) in vec4 i_uv_rect;
+layout (location = 5) in uint i_page;
 out vec2 tex_coord;
+flat out uint page;
 void main()
 {
-    tex_coord = i_tex_coord;
-    gl_Position = u_projection * u_view * u_model * vec4(i_pos, 1.0f);
+    tex_coord = i_uv_rect.xy + i_tex_coord * i_uv_rect.zw;
+    page = i_page;
+    vec3 position = u_origin + i_offset / 16.0f + vec3(i_pos.xy * i_size, i_pos.z);
+    gl_Position = u_projection * u_view * vec4(position, 1.0f);
 }
 )%%", R"%%(
 #version 330 core
 in vec2 tex_coord;
+flat in uint page;
 out vec4 o_color;
 uniform sampler2D u_texture_2d;
+uniform sampler2DArray u_texture_array;
+uniform bool u_layered;
 void main()
 {
-    o_color = texture(u_texture_2d, tex_coord);
+    o_color = u_layered
+        ? texture(u_texture_array, vec3(tex_coord, float(page)))
+        : texture(u_texture_2d, tex_coord);
 }
 )%%");
-    m_shader.bind();
-    m_shader.set_uniform("u_model", mat4f::identity());
-    m_shader.set_uniform("u_view", mat4f::identity());
-    m_shader.set_uniform("u_projection", mat4f::identity());
+}
 
+mope::sprite_renderer::sprite_renderer(gl::shader shader)
+    : m_shader{ std::move(shader) }
+    , m_projection{ mat4f::identity() }
+    , m_vao{ }
+    , m_vbo{ }
+    , m_instance_vbo{ }
+    , m_ebo{ }
+    , m_instances{ }
+    , m_batches{ }
+{
     m_vao.bind();
     constexpr auto vertices = std::to_array<float>({
         0.0f, 0.0f, 0.0f, 0.0f, 1.0f,
@@ -66,13 +142,53 @@ void main()
         .stride = 5 * sizeof(float),
         .offset = 3 * sizeof(float),
         });
+
+    // One of these per sprite, refilled every frame.
+    m_instance_vbo.bind();
+    m_vao.add_attributes(
+        gl::attribute{
+            .index = 2,
+            .size = 3,
+            .type = gl::attribute::short_type,
+            .stride = sizeof(sprite_instance),
+            .offset = offsetof(sprite_instance, offset),
+            .divisor = 1,
+        },
+        gl::attribute{
+            .index = 3,
+            .size = 2,
+            .type = gl::attribute::half_float_type,
+            .stride = sizeof(sprite_instance),
+            .offset = offsetof(sprite_instance, size),
+            .divisor = 1,
+        },
+        gl::attribute{
+            .index = 4,
+            .size = 4,
+            .type = gl::attribute::unsigned_short_type,
+            .stride = sizeof(sprite_instance),
+            .offset = offsetof(sprite_instance, uv_rect),
+            .divisor = 1,
+            .normalized = true,
+        },
+        gl::attribute{
+            .index = 5,
+            .size = 1,
+            .type = gl::attribute::unsigned_byte_type,
+            .stride = sizeof(sprite_instance),
+            .offset = offsetof(sprite_instance, page),
+            .divisor = 1,
+            .integer = true,
+        }
+    );
+
     constexpr auto indices = std::to_array<uint8_t>({ 0, 1, 2, 3 });
     m_ebo.fill(indices);
 }
 
 void mope::sprite_renderer::set_projection(mope::mat4f const& projection)
 {
-    m_shader.set_uniform("u_projection", projection);
+    m_projection = projection;
 }
 
 void mope::sprite_renderer::pre_tick(game_scene& scene)
@@ -85,18 +201,82 @@ void mope::sprite_renderer::pre_tick(game_scene& scene)
     }
 }
 
-void mope::sprite_renderer::render(game_scene& scene, double alpha)
+auto mope::sprite_renderer::render(game_scene& scene, double alpha) -> sprite_stats
 {
-    m_shader.bind();
-    m_vao.bind();
+    // Nothing is drawn until the driver has finished building the program,
+    // rather than stalling the frame on it.
+    if (!m_shader.ready()) {
+        return sprite_stats{};
+    }
+
+    m_instances.clear();
+    m_batches.clear();
+    auto alphaf = static_cast<float>(alpha);
 
     for (auto&& [sprite, transform] : scene
         .query<sprite_component, transform_component>()
         .exec())
     {
-        sprite.texture.bind();
-        auto alphaf = static_cast<float>(alpha);
-        m_shader.set_uniform("u_model", transform.blend(alphaf));
-        ::glDrawElements(GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_BYTE, 0);
+        // The model is a translation times a scale, and so is a blend of two
+        // of them, so the position and size can be read straight out of it.
+        auto model = transform.blend(alphaf);
+        auto position = vec3f{ model[3][0], model[3][1], model[3][2] };
+
+        auto instance = sprite_instance{};
+        if (m_batches.empty()
+            || !m_batches.back().texture->same_as(sprite.texture)
+            || !quantize_offset(position, m_batches.back().origin, instance.offset))
+        {
+            m_batches.push_back(batch{ &sprite.texture, position, m_instances.size(), 0 });
+            quantize_offset(position, position, instance.offset);
+        }
+
+        instance.size[0] = to_half(model[0][0]);
+        instance.size[1] = to_half(model[1][1]);
+        instance.uv_rect[0] = to_unorm16(sprite.uv_offset.x());
+        instance.uv_rect[1] = to_unorm16(sprite.uv_offset.y());
+        instance.uv_rect[2] = to_unorm16(sprite.uv_size.x());
+        instance.uv_rect[3] = to_unorm16(sprite.uv_size.y());
+        instance.page = sprite.page;
+
+        m_instances.push_back(instance);
+        ++m_batches.back().count;
+    }
+
+    auto instance_bytes = m_instances.size() * sizeof(sprite_instance);
+    m_instance_vbo.stream(m_instances.data(), instance_bytes);
+
+    // The program is shared with every other scene, and relinking it resets
+    // its uniforms, so we can't rely on them having kept our values.
+    m_shader.bind();
+    m_shader.set_uniform("u_view", mat4f::identity());
+    m_shader.set_uniform("u_projection", m_projection);
+    m_shader.set_uniform("u_texture_2d", TextureUnit);
+    m_shader.set_uniform("u_texture_array", ArrayTextureUnit);
+    m_vao.bind();
+
+    for (auto&& batch : m_batches) {
+        // The two kinds of sampler can't share a texture unit, even if only
+        // one is used.
+        auto layered = batch.texture->layered();
+        ::glActiveTexture(GL_TEXTURE0 + (layered ? ArrayTextureUnit : TextureUnit));
+        batch.texture->bind();
+        ::glActiveTexture(GL_TEXTURE0);
+        m_shader.set_uniform("u_layered", layered ? 1 : 0);
+        m_shader.set_uniform("u_origin", batch.origin);
+        ::glDrawElementsInstancedBaseInstance(
+            GL_TRIANGLE_STRIP,
+            4,
+            GL_UNSIGNED_BYTE,
+            nullptr,
+            static_cast<GLsizei>(batch.count),
+            static_cast<GLuint>(batch.first)
+        );
     }
+
+    return sprite_stats{
+        .sprites = m_instances.size(),
+        .draws = m_batches.size(),
+        .instance_bytes = instance_bytes,
+    };
 }
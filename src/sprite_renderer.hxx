@@ -1,26 +1,87 @@
 #pragma once
 
 #include "buffer_object.hxx"
+#include "mope_game_engine/components/engine_stats.hxx"
 #include "mope_vec/mope_vec.hxx"
 #include "shader.hxx"
 #include "vao.hxx"
 
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
 namespace mope
 {
     class game_scene;
 
+    namespace gl
+    {
+        class texture;
+    }
+
+    /// What the vertex shader reads for each sprite, in 20 bytes rather than
+    /// the 64 of a model matrix.
+    struct sprite_instance
+    {
+        /// How many steps position offsets are quantized to per unit.
+        static constexpr auto PositionScale = 16.0f;
+
+        /// The sprite's position, relative to the origin of its batch, in
+        /// steps of 1 / @ref PositionScale. This covers 2048 units either
+        /// side of the origin, past which the renderer starts a new batch.
+        std::int16_t offset[3];
+
+        /// Half floats.
+        std::uint16_t size[2];
+
+        /// The offset and size of the sprite's part of the texture, mapped
+        /// from [0, 1].
+        std::uint16_t uv_rect[4];
+
+        std::uint8_t page;
+        std::uint8_t padding;
+    };
+    static_assert(20 == sizeof(sprite_instance));
+
     class sprite_renderer
     {
     public:
-        sprite_renderer();
+        /// Start building the shader sprites are drawn with when the game
+        /// doesn't provide its own. It's built asynchronously, q.v.
+        /// @ref gl::shader::make_async.
+        static void make_default_shader(gl::shader& shader);
+
+        /// @p shader is shared rather than copied: every copy of a
+        /// @ref gl::shader refers to the same program, so remaking it (e.g.,
+        /// when its sources are reloaded) affects every renderer at once.
+        explicit sprite_renderer(gl::shader shader);
         void set_projection(mope::mat4f const& projection);
         void pre_tick(game_scene& scene);
-        void render(game_scene& scene, double alpha);
+
+        /// Draw every sprite in the scene, with one instanced draw for each
+        /// run of sprites that share a texture, or any layers of the same
+        /// texture array.
+        auto render(game_scene& scene, double alpha) -> sprite_stats;
 
     private:
+        /// A run of instances drawn with one call.
+        struct batch
+        {
+            gl::texture* texture;
+            vec3f origin;
+            std::size_t first;
+            std::size_t count;
+        };
+
         gl::shader m_shader;
+        mat4f m_projection;
         gl::vao m_vao;
         gl::vbo m_vbo;
+        gl::vbo m_instance_vbo;
         gl::ebo m_ebo;
+
+        /// Kept between frames so that their memory is reused.
+        std::vector<sprite_instance> m_instances;
+        std::vector<batch> m_batches;
     };
 } // namespace mope
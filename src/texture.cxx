@@ -1,6 +1,8 @@
 #include "mope_game_engine/texture.hxx"
 
 #include "glad/glad.h"
+#include "mip_chain.hxx"
+#include "mope_game_engine/game_engine_error.hxx"
 #include "mope_game_engine/resource_id.hxx"
 #include "mope_vec/mope_vec.hxx"
 
@@ -15,6 +17,12 @@ namespace
     using namespace mope;
     using namespace mope::gl;
 
+    // From EXT_texture_compression_s3tc, which every desktop driver has, but
+    // which isn't core, so our loader doesn't define them.
+    constexpr auto CompressedRgbaS3tcDxt1 = GLenum{ 0x83F1 };
+    constexpr auto CompressedRgbaS3tcDxt5 = GLenum{ 0x83F3 };
+
+    /// Compressed formats have no separate client format, so theirs is 0.
     auto map_pixel_format(pixel_format format) -> std::pair<GLint, GLenum>
     {
         switch (format) {
@@ -24,10 +32,52 @@ namespace
         case pixel_format::bgr: return { GL_RGB8, GL_BGR };
         case pixel_format::rgba: return { GL_RGBA8, GL_RGBA };
         case pixel_format::bgra: return { GL_RGBA8, GL_BGRA };
+        case pixel_format::bc1: return { CompressedRgbaS3tcDxt1, 0 };
+        case pixel_format::bc3: return { CompressedRgbaS3tcDxt5, 0 };
+        case pixel_format::bc4: return { GL_COMPRESSED_RED_RGTC1, 0 };
+        case pixel_format::bc5: return { GL_COMPRESSED_RG_RGTC2, 0 };
+        case pixel_format::bc7: return { GL_COMPRESSED_RGBA_BPTC_UNORM, 0 };
         default: std::unreachable();
         }
     }
 
+    auto level_size(vec2i size, int level) -> vec2i
+    {
+        return { std::max(size.x() >> level, 1), std::max(size.y() >> level, 1) };
+    }
+
+    /// Allocate one mip level of the bound texture, and fill it if @p bytes
+    /// isn't null.
+    void specify_level(pixel_format format, int level, vec2i size, std::byte const* bytes)
+    {
+        auto&& [internal_format, client_format] = map_pixel_format(format);
+        if (is_compressed(format)) {
+            ::glCompressedTexImage2D(
+                GL_TEXTURE_2D,
+                level,
+                static_cast<GLenum>(internal_format),
+                size.x(),
+                size.y(),
+                0,
+                static_cast<GLsizei>(image_size(format, size)),
+                bytes
+            );
+        }
+        else {
+            ::glTexImage2D(
+                GL_TEXTURE_2D,
+                level,
+                internal_format,
+                size.x(),
+                size.y(),
+                0,
+                client_format,
+                GL_UNSIGNED_BYTE,
+                bytes
+            );
+        }
+    }
+
     auto map_color_component(color_component component) -> GLenum
     {
         switch (component) {
@@ -62,6 +112,11 @@ namespace
         default: std::unreachable();
         }
     }
+
+    auto texture_target(bool layered) -> GLenum
+    {
+        return layered ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D;
+    }
 }
 
 void mope::gl::texture::bind()
@@ -76,7 +131,7 @@ void mope::gl::texture::bind()
             }
         };
     }
-    ::glBindTexture(GL_TEXTURE_2D, m_id);
+    ::glBindTexture(texture_target(m_layered), m_id);
 }
 
 auto mope::gl::texture::make(
@@ -86,43 +141,179 @@ auto mope::gl::texture::make(
     texture_extra_options const& extra_options
 ) & -> texture&
 {
+    set_layered(false);
     bind();
 
     ::glPixelStorei(GL_UNPACK_ALIGNMENT, extra_options.row_alignment);
-    auto&& [internal_format, format] = map_pixel_format(input_format);
+    for (auto level = 0; level < extra_options.levels; ++level) {
+        auto level_pixels = level_size(size, level);
+        specify_level(input_format, level, level_pixels, bytes);
+        if (nullptr != bytes) {
+            bytes += image_size(input_format, level_pixels, extra_options.row_alignment);
+        }
+    }
+
+    apply_filters(extra_options, input_format);
+    return *this;
+}
+
+auto mope::gl::texture::make(
+    std::byte const* bytes,
+    vec2i size,
+    pixel_format input_format,
+    texture_extra_options const& extra_options
+) && -> texture&&
+{
+    return std::move(make(bytes, size, input_format, extra_options));
+}
+
+auto mope::gl::texture::make(
+    texture const& source,
+    vec2i size,
+    pixel_format input_format,
+    texture_extra_options const& extra_options
+) & -> texture&
+{
+    set_layered(false);
+    bind();
+
+    // Allocate storage for each level without filling it; the copy will.
+    for (auto level = 0; level < extra_options.levels; ++level) {
+        auto level_pixels = level_size(size, level);
+        specify_level(input_format, level, level_pixels, nullptr);
+        ::glCopyImageSubData(
+            source.m_id, GL_TEXTURE_2D, level, 0, 0, 0,
+            m_id, GL_TEXTURE_2D, level, 0, 0, 0,
+            level_pixels.x(), level_pixels.y(), 1
+        );
+    }
+
+    apply_filters(extra_options, input_format);
+    return *this;
+}
+
+auto mope::gl::texture::make(
+    texture const& source,
+    vec2i size,
+    pixel_format input_format,
+    texture_extra_options const& extra_options
+) && -> texture&&
+{
+    return std::move(make(source, size, input_format, extra_options));
+}
+
+auto mope::gl::texture::update(
+    std::byte const* bytes,
+    vec2i offset,
+    vec2i size,
+    pixel_format input_format,
+    int row_length,
+    int level
+) & -> texture&
+{
+    bind();
+
+    ::glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    ::glPixelStorei(GL_UNPACK_ROW_LENGTH, row_length);
+    auto format = map_pixel_format(input_format).second;
 
-    ::glTexImage2D(
+    ::glTexSubImage2D(
         GL_TEXTURE_2D,
-        0,
-        internal_format,
+        level,
+        offset.x(),
+        offset.y(),
         size.x(),
         size.y(),
-        0,
         format,
         GL_UNSIGNED_BYTE,
         bytes
     );
+    ::glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    return *this;
+}
 
-    auto mag_filter = map_mag_filter(extra_options.mag_filter);
-    ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, mag_filter);
+auto mope::gl::texture::make_array(
+    vec2i size,
+    int layers,
+    pixel_format format,
+    texture_extra_options const& extra_options
+) & -> texture&
+{
+    if (is_compressed(format)) {
+        throw game_engine_error{ "Texture arrays can't be compressed." };
+    }
 
-    auto [min_filter, gen_mipmap] = map_min_filter(extra_options.min_filter);
-    ::glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, min_filter);
-    if (gen_mipmap) {
-        ::glGenerateMipmap(GL_TEXTURE_2D);
+    set_layered(true);
+    bind();
+
+    // Layers are filled with their levels by update_layer, rather than
+    // having them generated on the GPU.
+    auto options = extra_options;
+    options.levels = is_mipmapped(options.min_filter) ? mip_level_count(size) : 1;
+
+    auto [internal_format, input_format] = map_pixel_format(format);
+    for (auto level = 0; level < options.levels; ++level) {
+        auto level_pixels = level_size(size, level);
+        ::glTexImage3D(
+            GL_TEXTURE_2D_ARRAY,
+            level,
+            internal_format,
+            level_pixels.x(),
+            level_pixels.y(),
+            layers,
+            0,
+            input_format,
+            GL_UNSIGNED_BYTE,
+            nullptr
+        );
     }
 
+    apply_filters(options, format);
     return *this;
 }
 
-auto mope::gl::texture::make(
-    std::byte const* bytes,
+auto mope::gl::texture::make_array(
     vec2i size,
-    pixel_format input_format,
+    int layers,
+    pixel_format format,
     texture_extra_options const& extra_options
 ) && -> texture&&
 {
-    return std::move(make(bytes, size, input_format, extra_options));
+    return std::move(make_array(size, layers, format, extra_options));
+}
+
+auto mope::gl::texture::update_layer(
+    int layer,
+    std::byte const* bytes,
+    pixel_format input_format,
+    int levels
+) & -> texture&
+{
+    bind();
+
+    auto size = std::array<GLint, 2>{};
+    ::glGetTexLevelParameteriv(GL_TEXTURE_2D_ARRAY, 0, GL_TEXTURE_WIDTH, &size[0]);
+    ::glGetTexLevelParameteriv(GL_TEXTURE_2D_ARRAY, 0, GL_TEXTURE_HEIGHT, &size[1]);
+
+    ::glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (auto level = 0; level < levels; ++level) {
+        auto level_pixels = level_size(vec2i{ size[0], size[1] }, level);
+        ::glTexSubImage3D(
+            GL_TEXTURE_2D_ARRAY,
+            level,
+            0,
+            0,
+            layer,
+            level_pixels.x(),
+            level_pixels.y(),
+            1,
+            map_pixel_format(input_format).second,
+            GL_UNSIGNED_BYTE,
+            bytes
+        );
+        bytes += image_size(input_format, level_pixels);
+    }
+    return *this;
 }
 
 auto mope::gl::texture::swizzle(std::array<color_component, 4> const& sources) & -> texture&
@@ -136,7 +327,7 @@ auto mope::gl::texture::swizzle(std::array<color_component, 4> const& sources) &
         });
     std::copy_n(view.begin(), 4, swizzle_mask.begin());
 
-    ::glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle_mask.data());
+    ::glTexParameteriv(texture_target(m_layered), GL_TEXTURE_SWIZZLE_RGBA, swizzle_mask.data());
     return *this;
 }
 
@@ -144,3 +335,93 @@ auto mope::gl::texture::swizzle(std::array<color_component, 4> const& sources) &
 {
     return std::move(swizzle(sources));
 }
+
+void mope::gl::texture::set_layered(bool layered)
+{
+    // A texture's target is fixed the first time it's bound, so changing it
+    // takes a new texture.
+    if (layered != m_layered) {
+        m_id = resource_id{};
+        m_layered = layered;
+    }
+}
+
+void mope::gl::texture::apply_filters(texture_extra_options const& extra_options, pixel_format format)
+{
+    auto target = texture_target(m_layered);
+    auto mag_filter = map_mag_filter(extra_options.mag_filter);
+    ::glTexParameteri(target, GL_TEXTURE_MAG_FILTER, mag_filter);
+
+    auto [min_filter, gen_mipmap] = map_min_filter(extra_options.min_filter);
+    ::glTexParameteri(target, GL_TEXTURE_MIN_FILTER, min_filter);
+
+    // Levels that were given are used as they are, and compressed textures
+    // can't have theirs generated, so sampling stops at the last one given.
+    // Remaking a texture resets this.
+    if (extra_options.levels > 1 || is_compressed(format)) {
+        ::glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, extra_options.levels - 1);
+    }
+    else {
+        ::glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, 1000);
+        if (gen_mipmap) {
+            ::glGenerateMipmap(target);
+        }
+    }
+}
+
+auto mope::gl::is_mipmapped(texture_min_filter min_filter) -> bool
+{
+    return map_min_filter(min_filter).second;
+}
+
+auto mope::gl::is_compressed(pixel_format format) -> bool
+{
+    switch (format) {
+    case pixel_format::bc1:
+    case pixel_format::bc3:
+    case pixel_format::bc4:
+    case pixel_format::bc5:
+    case pixel_format::bc7:
+        return true;
+    default:
+        return false;
+    }
+}
+
+auto mope::gl::image_size(pixel_format format, vec2i size, int row_alignment) -> std::size_t
+{
+    auto width = static_cast<std::size_t>(size.x());
+    auto height = static_cast<std::size_t>(size.y());
+
+    auto block_bytes = 0uz;
+    switch (format) {
+    case pixel_format::bc1:
+    case pixel_format::bc4:
+        block_bytes = 8;
+        break;
+    case pixel_format::bc3:
+    case pixel_format::bc5:
+    case pixel_format::bc7:
+        block_bytes = 16;
+        break;
+    default:
+        break;
+    }
+    if (0 != block_bytes) {
+        return (width + 3) / 4 * ((height + 3) / 4) * block_bytes;
+    }
+
+    auto pixel_bytes = 0uz;
+    switch (format) {
+    case pixel_format::r: pixel_bytes = 1; break;
+    case pixel_format::rg: pixel_bytes = 2; break;
+    case pixel_format::rgb: pixel_bytes = 3; break;
+    case pixel_format::bgr: pixel_bytes = 3; break;
+    case pixel_format::rgba: pixel_bytes = 4; break;
+    case pixel_format::bgra: pixel_bytes = 4; break;
+    default: std::unreachable();
+    }
+    auto alignment = static_cast<std::size_t>(std::max(row_alignment, 1));
+    auto row = (width * pixel_bytes + alignment - 1) / alignment * alignment;
+    return row * height;
+}
@@ -0,0 +1,91 @@
+#include "mope_game_engine/texture_array.hxx"
+
+#include "mip_chain.hxx"
+#include "mope_game_engine/game_engine_error.hxx"
+#include "mope_game_engine/texture.hxx"
+#include "mope_vec/mope_vec.hxx"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+mope::gl::texture_array::texture_array(
+    vec2i size,
+    int layers,
+    pixel_format format,
+    texture_extra_options const& extra_options
+)
+    : m_texture{ }
+    , m_size{ size }
+    , m_layers{ layers }
+    , m_levels{ is_mipmapped(extra_options.min_filter) ? mip_level_count(size) : 1 }
+    , m_free{ }
+    , m_in_use{ }
+{
+    if (layers < 1 || layers > MaxLayers) {
+        throw game_engine_error{
+            "A texture array can't have " + std::to_string(layers) + " layers."
+        };
+    }
+
+    m_texture.make_array(size, layers, format, extra_options);
+    for (auto layer = layers; layer > 0; --layer) {
+        m_free.push_back(static_cast<std::uint8_t>(layer - 1));
+    }
+}
+
+auto mope::gl::texture_array::allocate(std::byte const* bytes, pixel_format input_format) -> std::uint8_t
+{
+    if (m_free.empty()) {
+        throw game_engine_error{ "Every layer of the texture array is in use." };
+    }
+
+    auto layer = m_free.back();
+    if (1 == m_levels) {
+        m_texture.update_layer(layer, bytes, input_format);
+    }
+    else {
+        // Build the smaller levels on the CPU, as the asset manager does for
+        // images, rather than generating every layer's on the GPU.
+        auto pixels = std::vector<std::byte>(bytes, bytes + image_size(input_format, m_size));
+        auto channels = static_cast<int>(image_size(input_format, vec2i{ 1, 1 }));
+        append_mip_chain(pixels, m_size, channels);
+        m_texture.update_layer(layer, pixels.data(), input_format, m_levels);
+    }
+    m_free.pop_back();
+    m_in_use.set(layer);
+    return layer;
+}
+
+void mope::gl::texture_array::release(std::uint8_t layer)
+{
+    if (layer >= m_layers) {
+        throw game_engine_error{
+            "Texture array layer " + std::to_string(layer) + " is out of range."
+        };
+    }
+    if (!m_in_use.test(layer)) {
+        throw game_engine_error{
+            "Texture array layer " + std::to_string(layer) + " isn't in use."
+        };
+    }
+
+    m_in_use.reset(layer);
+    m_free.push_back(layer);
+}
+
+auto mope::gl::texture_array::texture() const -> gl::texture const&
+{
+    return m_texture;
+}
+
+auto mope::gl::texture_array::size() const -> vec2i
+{
+    return m_size;
+}
+
+auto mope::gl::texture_array::free_layers() const -> std::size_t
+{
+    return m_free.size();
+}
@@ -0,0 +1,111 @@
+#include "upload_worker.hxx"
+
+#include "glad/glad.h"
+#include "mope_game_engine/components/logger.hxx"
+#include "mope_game_engine/game_window.hxx"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+mope::upload_worker::upload_worker(std::unique_ptr<gl::shared_context> context)
+    : m_context{ std::move(context) }
+    , m_mutex{ }
+    , m_condition{ }
+    , m_jobs{ }
+    , m_fenced{ }
+    , m_pending{ }
+    , m_thread{ [this](std::stop_token stop) { work(stop); } }
+{
+}
+
+mope::upload_worker::~upload_worker()
+{
+    m_thread.request_stop();
+    m_thread.join();
+
+    // The fences are shared between the contexts, so it's fine to delete the
+    // worker's fences from here.
+    for (auto&& fenced : m_pending) {
+        ::glDeleteSync(fenced.fence);
+    }
+    for (auto&& fenced : m_fenced) {
+        ::glDeleteSync(fenced.fence);
+    }
+}
+
+void mope::upload_worker::submit(std::function<void()> upload, std::function<void(bool uploaded)> on_ready)
+{
+    {
+        auto lock = std::scoped_lock{ m_mutex };
+        m_jobs.push_back({ std::move(upload), std::move(on_ready) });
+    }
+    m_condition.notify_one();
+}
+
+void mope::upload_worker::poll(I_logger* logger)
+{
+    {
+        auto lock = std::scoped_lock{ m_mutex };
+        std::ranges::move(m_fenced, std::back_inserter(m_pending));
+        m_fenced.clear();
+    }
+
+    // Fences signal in the order they were issued, so we can stop at the first
+    // one that hasn't.
+    auto ready = m_pending.begin();
+    for (; ready != m_pending.end(); ++ready) {
+        auto status = ::glClientWaitSync(ready->fence, 0, 0);
+        if (GL_TIMEOUT_EXPIRED == status) {
+            break;
+        }
+
+        // A fence that can't be waited on will never signal, so rather than
+        // stall every upload behind it, give up on its own.
+        auto uploaded = GL_WAIT_FAILED != status;
+        if (!uploaded && nullptr != logger) {
+            logger->log(
+                ("Waiting on an upload's fence failed (GL error " + std::to_string(::glGetError()) + ").").c_str(),
+                I_logger::log_level::error
+            );
+        }
+        ::glDeleteSync(ready->fence);
+        std::invoke(ready->on_ready, uploaded);
+    }
+    m_pending.erase(m_pending.begin(), ready);
+}
+
+void mope::upload_worker::work(std::stop_token stop)
+{
+    auto context = m_context->make_current();
+
+    while (true) {
+        auto next = job{};
+        {
+            auto lock = std::unique_lock{ m_mutex };
+            if (!m_condition.wait(lock, stop, [this]() { return !m_jobs.empty(); })) {
+                // We were asked to stop.
+                return;
+            }
+            next = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        std::invoke(next.upload);
+
+        // Flushing makes sure that the fence actually reaches the GPU, which
+        // a fence waited on from another context relies on.
+        auto fence = ::glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        ::glFlush();
+
+        auto lock = std::scoped_lock{ m_mutex };
+        m_fenced.push_back({ fence, std::move(next.on_ready) });
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "glad/glad.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace mope::gl
+{
+    struct shared_context;
+}
+
+namespace mope
+{
+    struct I_logger;
+
+    /// A thread that owns a GL context shared with the render thread, for
+    /// creating and filling resources without stalling rendering.
+    ///
+    /// Each upload is followed by a fence. The render thread calls @ref poll()
+    /// once per frame, which checks the fences without waiting on them, and
+    /// runs the completion callback of every upload the GPU has finished.
+    /// Only then is it safe for the render thread to use what was uploaded.
+    class upload_worker
+    {
+    public:
+        /// Must be called on the render thread, with its context current.
+        explicit upload_worker(std::unique_ptr<gl::shared_context> context);
+        ~upload_worker();
+
+        upload_worker(upload_worker const&) = delete;
+        auto operator=(upload_worker const&) -> upload_worker& = delete;
+
+        /// Run @p upload on the worker thread, then @p on_ready on the render
+        /// thread once the GPU has finished the commands that @p upload issued.
+        ///
+        /// @p on_ready is told whether they did. If waiting on the upload's
+        /// fence failed, it gets `false`, and what was uploaded can't be
+        /// relied on.
+        ///
+        /// Neither function may throw. If the worker is destroyed first,
+        /// @p on_ready is never called.
+        void submit(std::function<void()> upload, std::function<void(bool uploaded)> on_ready);
+
+        /// Used by the render thread to run the callbacks of finished uploads.
+        /// Fences that can't be waited on are reported to @p logger, if any.
+        void poll(I_logger* logger);
+
+    private:
+        struct job
+        {
+            std::function<void()> upload;
+            std::function<void(bool)> on_ready;
+        };
+
+        struct fenced_job
+        {
+            GLsync fence;
+            std::function<void(bool)> on_ready;
+        };
+
+        void work(std::stop_token stop);
+
+        std::unique_ptr<gl::shared_context> m_context;
+        std::mutex m_mutex;
+        std::condition_variable_any m_condition;
+        std::deque<job> m_jobs;
+
+        /// Fenced by the worker, but not yet seen by @ref poll().
+        std::vector<fenced_job> m_fenced;
+
+        /// Only touched by @ref poll(), so it needs no lock.
+        std::vector<fenced_job> m_pending;
+
+        // Declared last so that the worker is joined before anything it
+        // touches is destroyed.
+        std::jthread m_thread;
+    };
+} // namespace mope
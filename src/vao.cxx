@@ -16,6 +16,14 @@ namespace
         {
         case attribute_type::float_type:
             return GL_FLOAT;
+        case attribute_type::half_float_type:
+            return GL_HALF_FLOAT;
+        case attribute_type::short_type:
+            return GL_SHORT;
+        case attribute_type::unsigned_short_type:
+            return GL_UNSIGNED_SHORT;
+        case attribute_type::unsigned_byte_type:
+            return GL_UNSIGNED_BYTE;
         default:
             throw mope::game_engine_error{
                 "Invalid attribute type: " + std::to_string(attr)
@@ -27,14 +35,25 @@ namespace
 void mope::gl::vao::add_attribute(attribute const& attr)
 {
     bind();
-    ::glVertexAttribPointer(
-        attr.index,
-        attr.size,
-        map_attribute_type(attr.type),
-        GL_FALSE,
-        attr.stride,
-        reinterpret_cast<void*>(attr.offset)
-    );
+    if (attr.integer) {
+        ::glVertexAttribIPointer(
+            attr.index,
+            attr.size,
+            map_attribute_type(attr.type),
+            attr.stride,
+            reinterpret_cast<void*>(attr.offset)
+        );
+    }
+    else {
+        ::glVertexAttribPointer(
+            attr.index,
+            attr.size,
+            map_attribute_type(attr.type),
+            attr.normalized ? GL_TRUE : GL_FALSE,
+            attr.stride,
+            reinterpret_cast<void*>(attr.offset)
+        );
+    }
     ::glEnableVertexAttribArray(attr.index);
     ::glVertexAttribDivisor(attr.index, attr.divisor);
 }
@@ -19,12 +19,24 @@ namespace mope::gl
 
         enum
         {
-            float_type
+            float_type,
+            half_float_type,
+            short_type,
+            unsigned_short_type,
+            unsigned_byte_type,
         } type;
 
         int stride;
         std::size_t offset;
         unsigned int divisor = 0;
+
+        /// Map integer types to [0, 1] (or [-1, 1] if signed) rather than
+        /// converting their values to float as they are.
+        bool normalized = false;
+
+        /// Pass integer types to the shader as integers (`int`, `uint`)
+        /// rather than floats.
+        bool integer = false;
     };
 
     ////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,526 @@
+#include "mope_game_engine/world_partition.hxx"
+
+#include "job_system.hxx"
+#include "mope_game_engine/components/logger.hxx"
+#include "mope_game_engine/components/transform.hxx"
+#include "mope_game_engine/components/world_focus.hxx"
+#include "mope_game_engine/game_engine_error.hxx"
+#include "mope_game_engine/game_scene.hxx"
+#include "mope_vec/mope_vec.hxx"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <span>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using namespace mope;
+
+    // A cell file is a sequence of entity records, each of which is:
+    //
+    //     u32 component_count
+    //     component_count times:
+    //         u32 stream_index
+    //         u32 size
+    //         size bytes, as saved by the component_serializer
+    //
+    // There is no header, so entities that wander into a cell that isn't
+    // loaded can be appended to its file without reading it first.
+
+    using cell_key = std::uint64_t;
+
+    auto make_key(vec2i cell) -> cell_key
+    {
+        return std::uint64_t{ static_cast<std::uint32_t>(cell.x()) } << 32
+            | static_cast<std::uint32_t>(cell.y());
+    }
+
+    auto key_cell(cell_key key) -> vec2i
+    {
+        return vec2i{
+            static_cast<std::int32_t>(static_cast<std::uint32_t>(key >> 32)),
+            static_cast<std::int32_t>(static_cast<std::uint32_t>(key))
+        };
+    }
+
+    auto cell_of(vec2f position, float cell_size) -> vec2i
+    {
+        return vec2i{
+            static_cast<int>(std::floor(position.x() / cell_size)),
+            static_cast<int>(std::floor(position.y() / cell_size))
+        };
+    }
+
+    auto cell_distance(vec2i a, vec2i b) -> int
+    {
+        return std::max(std::abs(a.x() - b.x()), std::abs(a.y() - b.y()));
+    }
+
+    void append_u32(std::vector<std::byte>& out, std::uint32_t value)
+    {
+        auto bytes = std::as_bytes(std::span{ &value, 1 });
+        out.insert(out.end(), bytes.begin(), bytes.end());
+    }
+
+    void patch_u32(std::vector<std::byte>& out, std::size_t offset, std::uint32_t value)
+    {
+        std::memcpy(out.data() + offset, &value, sizeof(value));
+    }
+
+    auto read_u32(std::span<std::byte const> bytes, std::size_t offset) -> std::uint32_t
+    {
+        auto value = std::uint32_t{};
+        std::memcpy(&value, bytes.data() + offset, sizeof(value));
+        return value;
+    }
+
+    /// The contents of a cell file, split into entity records. The records
+    /// point into `bytes`.
+    struct cell_contents
+    {
+        std::vector<std::byte> bytes;
+        std::vector<std::span<std::byte const>> entities;
+    };
+
+    auto parse_cell(std::vector<std::byte> bytes) -> cell_contents
+    {
+        auto contents = cell_contents{ std::move(bytes), { } };
+        auto data = std::span<std::byte const>{ contents.bytes };
+
+        auto offset = 0uz;
+        while (offset < data.size()) {
+            auto start = offset;
+            if (data.size() - offset < 4) {
+                throw game_engine_error{ "Truncated entity record." };
+            }
+            auto count = read_u32(data, offset);
+            offset += 4;
+
+            for (auto i = 0u; i < count; ++i) {
+                if (data.size() - offset < 8) {
+                    throw game_engine_error{ "Truncated component record." };
+                }
+                auto size = read_u32(data, offset + 4);
+                offset += 8;
+                if (data.size() - offset < size) {
+                    throw game_engine_error{ "Truncated component record." };
+                }
+                offset += size;
+            }
+            contents.entities.push_back(data.subspan(start, offset - start));
+        }
+        return contents;
+    }
+
+    auto read_file(std::filesystem::path const& path) -> std::vector<std::byte>
+    {
+        auto file = std::ifstream{ path, std::ios::binary | std::ios::ate };
+        if (!file) {
+            // A cell that was never written is empty.
+            return { };
+        }
+
+        auto size = static_cast<std::streamsize>(file.tellg());
+        auto bytes = std::vector<std::byte>(static_cast<std::size_t>(size));
+        file.seekg(0);
+        if (!file.read(reinterpret_cast<char*>(bytes.data()), size)) {
+            throw game_engine_error{ "Failed to read \"" + path.string() + "\"." };
+        }
+        return bytes;
+    }
+
+    void log(game_scene& scene, std::string const& message, I_logger::log_level level)
+    {
+        if (auto logger = scene.logger(); nullptr != logger) {
+            logger->log(message.c_str(), level);
+        }
+    }
+}
+
+class mope::world_partition::imp
+{
+public:
+    explicit imp(world_partition_options options)
+        : m_options{ std::move(options) }
+        , m_streams{ }
+        , m_cells{ }
+        , m_pending{ }
+        , m_generation{ 0 }
+        , m_mutex{ }
+        , m_loaded{ }
+        , m_errors{ }
+        , m_io{ 1 }
+    {
+        auto ec = std::error_code{};
+        std::filesystem::create_directories(m_options.directory, ec);
+        if (ec) {
+            throw game_engine_error{
+                "Failed to create \"" + m_options.directory + "\": " + ec.message()
+            };
+        }
+    }
+
+    ~imp()
+    {
+        // The job system discards jobs that haven't started, and some of
+        // those may be writes.
+        wait();
+    }
+
+    void add_stream(save_function save, load_function load)
+    {
+        m_streams.emplace_back(save, load);
+    }
+
+    void update(game_scene& scene, vec2f focus)
+    {
+        auto center = cell_of(focus, m_options.cell_size);
+        receive_loads(scene);
+        request_loads(center);
+        evict(scene, center, m_options.unload_radius);
+        instantiate(scene);
+    }
+
+    /// Forget every cell without saving it, so that the world is read from
+    /// disk again as it was last saved. Loads that are still under way are
+    /// dropped when they arrive, as if their cells were evicted.
+    void reset()
+    {
+        m_cells.clear();
+        m_pending.clear();
+    }
+
+    void flush(game_scene& scene)
+    {
+        receive_loads(scene);
+        // Every cell is further than -1 cells away.
+        evict(scene, vec2i{ }, -1);
+        wait();
+    }
+
+private:
+    enum class cell_state
+    {
+        loading,
+        loaded,
+    };
+
+    struct cell
+    {
+        cell_state state;
+        /// Tells a load that finishes after its cell was evicted (and maybe
+        /// requested again) from the load we are waiting for.
+        unsigned int generation;
+    };
+
+    struct loaded_cell
+    {
+        cell_key key;
+        unsigned int generation;
+        cell_contents contents;
+        std::string error;
+    };
+
+    struct pending_cell
+    {
+        cell_key key;
+        cell_contents contents;
+        std::size_t next;
+    };
+
+    auto path_of(cell_key key) const -> std::filesystem::path
+    {
+        auto cell = key_cell(key);
+        return std::filesystem::path{ m_options.directory }
+            / (std::to_string(cell.x()) + "_" + std::to_string(cell.y()) + ".cell");
+    }
+
+    void receive_loads(game_scene& scene)
+    {
+        auto loaded = std::vector<loaded_cell>{};
+        auto errors = std::vector<std::string>{};
+        {
+            auto lock = std::scoped_lock{ m_mutex };
+            loaded.swap(m_loaded);
+            errors.swap(m_errors);
+        }
+
+        for (auto&& error : errors) {
+            log(scene, error, I_logger::log_level::error);
+        }
+
+        for (auto&& load : loaded) {
+            auto iter = m_cells.find(load.key);
+            if (m_cells.end() == iter || iter->second.generation != load.generation) {
+                // Evicted before it arrived. The file is untouched, so there
+                // is nothing to do.
+                continue;
+            }
+
+            iter->second.state = cell_state::loaded;
+            if (!load.error.empty()) {
+                log(scene, load.error, I_logger::log_level::error);
+            }
+            else if (!load.contents.entities.empty()) {
+                m_pending.emplace_back(load.key, std::move(load.contents), 0uz);
+            }
+        }
+    }
+
+    void request_loads(vec2i center)
+    {
+        auto radius = m_options.load_radius;
+        for (auto y = center.y() - radius; y <= center.y() + radius; ++y) {
+            for (auto x = center.x() - radius; x <= center.x() + radius; ++x) {
+                auto key = make_key(vec2i{ x, y });
+                if (!m_cells.contains(key)) {
+                    m_cells.emplace(key, cell{ cell_state::loading, ++m_generation });
+                    read(key, m_generation);
+                }
+            }
+        }
+    }
+
+    void evict(game_scene& scene, vec2i center, int radius)
+    {
+        // Cells that are leaving are rewritten with whatever is in them now.
+        auto leaving = std::unordered_map<cell_key, std::vector<std::byte>>{};
+        for (auto iter = m_cells.begin(); iter != m_cells.end(); ) {
+            if (cell_distance(key_cell(iter->first), center) > radius) {
+                if (cell_state::loaded == iter->second.state) {
+                    leaving.emplace(iter->first, std::vector<std::byte>{ });
+                }
+                iter = m_cells.erase(iter);
+            }
+            else {
+                ++iter;
+            }
+        }
+
+        // Entities that haven't been instantiated yet go back to disk as they
+        // are.
+        std::erase_if(m_pending, [&](pending_cell& pending)
+            {
+                auto iter = leaving.find(pending.key);
+                if (leaving.end() == iter) {
+                    return false;
+                }
+                for (auto i = pending.next; i < pending.contents.entities.size(); ++i) {
+                    auto record = pending.contents.entities[i];
+                    iter->second.insert(iter->second.end(), record.begin(), record.end());
+                }
+                return true;
+            });
+
+        // Entities in cells that aren't loaded at all have wandered off, or
+        // were laid out out of range, and are appended to those cells, even
+        // on ticks when no cell leaves. Entities in cells that are still
+        // loading are left alone until their cell arrives.
+        auto strays = std::unordered_map<cell_key, std::vector<std::byte>>{};
+        auto saved = std::vector<entity_id>{};
+        for (auto&& [streamed, transform] : scene.query<streamed_component, transform_component>().exec()) {
+            auto position = vec2f{ transform.x_position(), transform.y_position() };
+            auto key = make_key(cell_of(position, m_options.cell_size));
+
+            auto out = static_cast<std::vector<std::byte>*>(nullptr);
+            if (auto iter = leaving.find(key); leaving.end() != iter) {
+                out = &iter->second;
+            }
+            else if (!m_cells.contains(key)) {
+                out = &strays[key];
+            }
+            else {
+                continue;
+            }
+
+            save_entity(scene, streamed.entity, *out);
+            saved.push_back(streamed.entity);
+        }
+
+        for (auto&& entity : saved) {
+            scene.destroy_entity(entity);
+        }
+
+        for (auto&& [key, bytes] : leaving) {
+            write(key, std::move(bytes), false);
+        }
+        for (auto&& [key, bytes] : strays) {
+            write(key, std::move(bytes), true);
+        }
+    }
+
+    void instantiate(game_scene& scene)
+    {
+        auto budget = m_options.max_instantiations_per_tick;
+        while (budget > 0 && !m_pending.empty()) {
+            auto& pending = m_pending.front();
+            if (pending.next == pending.contents.entities.size()) {
+                m_pending.pop_front();
+                continue;
+            }
+
+            instantiate_entity(scene, pending.contents.entities[pending.next++]);
+            --budget;
+        }
+    }
+
+    void save_entity(game_scene& scene, entity_id entity, std::vector<std::byte>& out)
+    {
+        auto count_offset = out.size();
+        auto count = std::uint32_t{ 0 };
+        append_u32(out, count);
+
+        for (auto i = 0uz; i < m_streams.size(); ++i) {
+            auto size_offset = out.size() + 4;
+            append_u32(out, static_cast<std::uint32_t>(i));
+            append_u32(out, 0);
+            if (m_streams[i].first(scene, entity, out)) {
+                patch_u32(out, size_offset, static_cast<std::uint32_t>(out.size() - size_offset - 4));
+                ++count;
+            }
+            else {
+                out.resize(size_offset - 4);
+            }
+        }
+        patch_u32(out, count_offset, count);
+    }
+
+    void instantiate_entity(game_scene& scene, std::span<std::byte const> record)
+    {
+        auto entity = scene.create_entity();
+        scene.set_component(streamed_component{ { entity } });
+
+        auto count = read_u32(record, 0);
+        auto offset = 4uz;
+        for (auto i = 0u; i < count; ++i) {
+            auto index = read_u32(record, offset);
+            auto size = read_u32(record, offset + 4);
+            offset += 8;
+            // Skip components that aren't registered this run.
+            if (index < m_streams.size()) {
+                m_streams[index].second(scene, entity, record.subspan(offset, size));
+            }
+            offset += size;
+        }
+
+        if (m_options.on_instantiate) {
+            m_options.on_instantiate(scene, entity);
+        }
+    }
+
+    void read(cell_key key, unsigned int generation)
+    {
+        m_io.submit([this, key, generation, path = path_of(key)]()
+            {
+                auto load = loaded_cell{ key, generation, { }, { } };
+                try {
+                    load.contents = parse_cell(read_file(path));
+                }
+                catch (std::exception const& ex) {
+                    // Move the file aside rather than letting the next write
+                    // of this cell replace it.
+                    auto aside = path;
+                    aside += ".corrupt";
+                    auto ec = std::error_code{};
+                    std::filesystem::rename(path, aside, ec);
+                    load.error = "Failed to load \"" + path.string() + "\" (moved to \""
+                        + aside.string() + "\"): " + ex.what();
+                }
+
+                auto lock = std::scoped_lock{ m_mutex };
+                m_loaded.push_back(std::move(load));
+            });
+    }
+
+    void write(cell_key key, std::vector<std::byte> bytes, bool append)
+    {
+        m_io.submit([this, bytes = std::move(bytes), append, path = path_of(key)]()
+            {
+                if (!append && bytes.empty()) {
+                    auto ec = std::error_code{};
+                    std::filesystem::remove(path, ec);
+                    return;
+                }
+
+                auto mode = std::ios::binary | (append ? std::ios::app : std::ios::trunc);
+                auto file = std::ofstream{ path, mode };
+                file.write(reinterpret_cast<char const*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+                if (!file) {
+                    auto lock = std::scoped_lock{ m_mutex };
+                    m_errors.push_back("Failed writing \"" + path.string() + "\".");
+                }
+            });
+    }
+
+    void wait()
+    {
+        // There is only one I/O thread, so once this runs, so has everything
+        // submitted before it.
+        auto done = std::promise<void>{};
+        auto future = done.get_future();
+        m_io.submit([&done]() { done.set_value(); });
+        future.wait();
+    }
+
+    world_partition_options m_options;
+    std::vector<std::pair<save_function, load_function>> m_streams;
+    std::unordered_map<cell_key, cell> m_cells;
+    std::deque<pending_cell> m_pending;
+    unsigned int m_generation;
+
+    // Filled by the I/O thread.
+    std::mutex m_mutex;
+    std::vector<loaded_cell> m_loaded;
+    std::vector<std::string> m_errors;
+
+    // Declared last so that it is joined before anything its jobs touch is
+    // destroyed. A single thread keeps reads and writes of a cell in the
+    // order they were submitted.
+    job_system m_io;
+};
+
+mope::world_partition::world_partition(world_partition_options options)
+    : m_imp{ std::make_unique<imp>(std::move(options)) }
+{
+    // The transform is always saved first, since it decides the cell.
+    stream<transform_component>();
+}
+
+mope::world_partition::~world_partition() = default;
+
+void mope::world_partition::operator()(game_scene& scene, tick_event const&)
+{
+    if (auto focus = scene.get_component<world_focus>(); nullptr != focus) {
+        m_imp->update(scene, focus->position);
+    }
+}
+
+void mope::world_partition::operator()(game_scene&, scene_reset_event const&)
+{
+    m_imp->reset();
+}
+
+void mope::world_partition::flush(game_scene& scene)
+{
+    m_imp->flush(scene);
+}
+
+void mope::world_partition::add_stream(save_function save, load_function load)
+{
+    m_imp->add_stream(save, load);
+}
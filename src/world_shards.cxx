@@ -0,0 +1,753 @@
+#include "mope_game_engine/world_shards.hxx"
+
+#include "shm_ring.hxx"
+#include "mope_game_engine/components/transform.hxx"
+#include "mope_game_engine/events/tick.hxx"
+#include "mope_game_engine/game_engine_error.hxx"
+#include "mope_game_engine/game_scene.hxx"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <span>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+
+#include <csignal>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#endif // defined(__linux__)
+
+namespace
+{
+    using namespace mope;
+
+    // Entities cross between processes as records, each of which is:
+    //
+    //     u32 component_count
+    //     component_count times:
+    //         u32 stream_index
+    //         u32 size
+    //         size bytes, as saved by the component_serializer
+    //
+    // A migration message is a u32 tick number followed by one record. A
+    // snapshot message is a u32 entity count followed by, for each entity,
+    // its u64 id in the shard's scene and its record.
+
+    /// What the coordinator and one worker share, besides the rings. Ticks
+    /// are counted from 1, and wrap.
+    struct shard_control
+    {
+        /// The last tick the coordinator asked for. Bumped once more to
+        /// stop the worker.
+        std::atomic<std::uint32_t> requested;
+
+        /// The last tick the worker finished, or gave up on.
+        std::atomic<std::uint32_t> completed;
+
+        std::atomic<std::uint32_t> stop;
+        std::atomic<std::uint32_t> failed;
+
+        double time_step;
+        char error[256];
+    };
+
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+
+    enum ring_index
+    {
+        FromLeft,       ///< Entities from the shard before this one.
+        FromRight,      ///< Entities from the shard after this one.
+        ToCoordinator,  ///< Snapshots of this shard.
+        RingsPerShard,
+    };
+
+    constexpr auto CacheLine = 64uz;
+
+    auto round_up(std::size_t size, std::size_t multiple) -> std::size_t
+    {
+        return (size + multiple - 1) / multiple * multiple;
+    }
+
+    void append_u32(std::vector<std::byte>& out, std::uint32_t value)
+    {
+        auto bytes = std::as_bytes(std::span{ &value, 1 });
+        out.insert(out.end(), bytes.begin(), bytes.end());
+    }
+
+    void append_u64(std::vector<std::byte>& out, std::uint64_t value)
+    {
+        auto bytes = std::as_bytes(std::span{ &value, 1 });
+        out.insert(out.end(), bytes.begin(), bytes.end());
+    }
+
+    void patch_u32(std::vector<std::byte>& out, std::size_t offset, std::uint32_t value)
+    {
+        std::memcpy(out.data() + offset, &value, sizeof(value));
+    }
+
+    auto read_u32(std::span<std::byte const> bytes, std::size_t offset) -> std::uint32_t
+    {
+        if (bytes.size() < offset + sizeof(std::uint32_t)) {
+            throw game_engine_error{ "Truncated message between world shards." };
+        }
+        auto value = std::uint32_t{};
+        std::memcpy(&value, bytes.data() + offset, sizeof(value));
+        return value;
+    }
+
+    auto read_u64(std::span<std::byte const> bytes, std::size_t offset) -> std::uint64_t
+    {
+        if (bytes.size() < offset + sizeof(std::uint64_t)) {
+            throw game_engine_error{ "Truncated message between world shards." };
+        }
+        auto value = std::uint64_t{};
+        std::memcpy(&value, bytes.data() + offset, sizeof(value));
+        return value;
+    }
+
+    /// The length of the entity record at the start of @p bytes.
+    auto record_size(std::span<std::byte const> bytes) -> std::size_t
+    {
+        auto count = read_u32(bytes, 0);
+        auto offset = 4uz;
+        for (auto i = 0u; i < count; ++i) {
+            offset += 8 + read_u32(bytes, offset + 4);
+        }
+        if (bytes.size() < offset) {
+            throw game_engine_error{ "Truncated message between world shards." };
+        }
+        return offset;
+    }
+
+#if defined(__linux__)
+
+    // Futexes without FUTEX_PRIVATE_FLAG, unlike those behind
+    // std::atomic::wait, work between processes sharing the memory.
+
+    /// Sleep while @p word holds @p value, for at most @p timeout_ms, or
+    /// until woken, if negative. May return early.
+    void wait_while(std::atomic<std::uint32_t>& word, std::uint32_t value, int timeout_ms)
+    {
+        auto timeout = timespec{ timeout_ms / 1000, (timeout_ms % 1000) * 1'000'000L };
+        ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT, value,
+            timeout_ms < 0 ? nullptr : &timeout, nullptr, 0);
+    }
+
+    void wake_all(std::atomic<std::uint32_t>& word)
+    {
+        ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+    }
+
+    /// The number of threads in this process, or 0 if it can't be told.
+    auto thread_count() -> int
+    {
+        auto status = std::ifstream{ "/proc/self/status" };
+        auto line = std::string{};
+        while (std::getline(status, line)) {
+            if (line.starts_with("Threads:")) {
+                auto count = 0;
+                std::istringstream{ line.substr(8) } >> count;
+                return count;
+            }
+        }
+        return 0;
+    }
+
+#else // !defined(__linux__)
+
+    // Never reached, since workers can't be started.
+
+    void wait_while(std::atomic<std::uint32_t>&, std::uint32_t, int)
+    {
+        std::this_thread::yield();
+    }
+
+    void wake_all(std::atomic<std::uint32_t>&)
+    {
+    }
+
+#endif // defined(__linux__)
+}
+
+class mope::world_shards::imp
+{
+public:
+    explicit imp(world_shard_options options)
+        : m_options{ std::move(options) }
+        , m_streams{ }
+        , m_memory{ nullptr }
+        , m_memory_size{ 0 }
+        , m_slot_size{ 0 }
+        , m_ring_size{ 0 }
+        , m_workers{ }
+        , m_tick{ 0 }
+        , m_proxies{ }
+        , m_held{ }
+        , m_message{ }
+        , m_record{ }
+    {
+        if (m_options.shard_count < 1) {
+            throw game_engine_error{ "A sharded world needs at least one shard." };
+        }
+        if (!(m_options.shard_width > 0.0f)) {
+            throw game_engine_error{ "World shards need a positive width." };
+        }
+        if (!m_options.make_scene) {
+            throw game_engine_error{ "World shards need a way to make their scenes." };
+        }
+        m_proxies.resize(static_cast<std::size_t>(m_options.shard_count));
+    }
+
+    ~imp()
+    {
+        stop();
+    }
+
+    void add_stream(save_function save, load_function load)
+    {
+        if (nullptr != m_memory) {
+            throw game_engine_error{ "Streams can't be added to world shards once they have started." };
+        }
+        m_streams.emplace_back(save, load);
+    }
+
+    auto shard_of(float x) const -> int
+    {
+        auto strip = std::floor((x - m_options.origin) / m_options.shard_width);
+        if (!(strip > 0.0f)) {
+            // Including NaN, which would otherwise be cast to who knows what.
+            return 0;
+        }
+        // Clamp as a float, since the strip may be too far out for an int.
+        return static_cast<int>(std::min(strip, static_cast<float>(m_options.shard_count - 1)));
+    }
+
+    void start()
+    {
+#if defined(__linux__)
+        if (nullptr != m_memory) {
+            return;
+        }
+
+        // A forked worker only has the thread that forked it, and any lock
+        // another thread held at the time stays held there forever.
+        if (1 < thread_count()) {
+            throw game_engine_error{
+                "World shards have to start before any other thread does, "
+                "e.g. before the game engine is made."
+            };
+        }
+
+        auto shards = static_cast<std::size_t>(m_options.shard_count);
+        m_ring_size = round_up(shm_ring::footprint(m_options.ring_bytes), CacheLine);
+        m_slot_size = round_up(sizeof(shard_control), CacheLine) + RingsPerShard * m_ring_size;
+        m_memory_size = shards * m_slot_size;
+
+        auto mapped = ::mmap(nullptr, m_memory_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (MAP_FAILED == mapped) {
+            throw game_engine_error{ "Failed to map memory for world shards." };
+        }
+        m_memory = static_cast<std::byte*>(mapped);
+
+        for (auto shard = 0; shard < m_options.shard_count; ++shard) {
+            new (m_memory + slot_offset(shard)) shard_control{ };
+            for (auto i = 0; i < RingsPerShard; ++i) {
+                shm_ring::initialize(ring_memory(shard, static_cast<ring_index>(i)), m_options.ring_bytes);
+            }
+        }
+
+        auto coordinator = ::getpid();
+        for (auto shard = 0; shard < m_options.shard_count; ++shard) {
+            auto pid = ::fork();
+            if (-1 == pid) {
+                stop();
+                throw game_engine_error{ "Failed to start world shard " + std::to_string(shard) + "." };
+            }
+            if (0 == pid) {
+                // Don't outlive the coordinator, however it goes.
+                ::prctl(PR_SET_PDEATHSIG, SIGKILL);
+                if (::getppid() != coordinator) {
+                    std::_Exit(1);
+                }
+                run_worker(shard);
+            }
+            m_workers.push_back(pid);
+        }
+#else // !defined(__linux__)
+        throw game_engine_error{ "World shards are only supported on Linux." };
+#endif // defined(__linux__)
+    }
+
+    void tick(game_scene& scene, double time_step)
+    {
+        if (nullptr == m_memory) {
+            throw game_engine_error{ "World shards have to be started before they tick." };
+        }
+
+        ++m_tick;
+        for (auto shard = 0; shard < m_options.shard_count; ++shard) {
+            auto& shared = control(shard);
+            shared.time_step = time_step;
+            shared.requested.store(m_tick, std::memory_order_release);
+            wake_all(shared.requested);
+        }
+
+        // Wait for every shard even if one has failed, so that none of them
+        // is still sending when the snapshots are thrown away.
+        auto failure = std::exception_ptr{};
+        for (auto shard = 0; shard < m_options.shard_count; ++shard) {
+            try {
+                wait_for(shard);
+            }
+            catch (...) {
+                if (!failure) {
+                    failure = std::current_exception();
+                }
+            }
+        }
+
+        try {
+            if (failure) {
+                std::rethrow_exception(failure);
+            }
+            for (auto shard = 0; shard < m_options.shard_count; ++shard) {
+                merge(scene, shard);
+            }
+        }
+        catch (...) {
+            // Otherwise the next tick would merge what is left of this one.
+            discard_snapshots();
+            throw;
+        }
+    }
+
+    void reset()
+    {
+        for (auto&& proxies : m_proxies) {
+            proxies.clear();
+        }
+    }
+
+private:
+    auto slot_offset(int shard) const -> std::size_t
+    {
+        return static_cast<std::size_t>(shard) * m_slot_size;
+    }
+
+    auto control(int shard) -> shard_control&
+    {
+        return *std::launder(reinterpret_cast<shard_control*>(m_memory + slot_offset(shard)));
+    }
+
+    auto ring_memory(int shard, ring_index index) -> std::span<std::byte>
+    {
+        auto offset = slot_offset(shard) + round_up(sizeof(shard_control), CacheLine)
+            + static_cast<std::size_t>(index) * m_ring_size;
+        return std::span{ m_memory + offset, m_ring_size };
+    }
+
+    auto ring(int shard, ring_index index) -> shm_ring
+    {
+        return shm_ring{ ring_memory(shard, index) };
+    }
+
+    void wait_for(int shard)
+    {
+        auto& shared = control(shard);
+        for (auto completed = shared.completed.load(std::memory_order_acquire);
+            completed != m_tick;
+            completed = shared.completed.load(std::memory_order_acquire))
+        {
+            // Check on the worker now and then, in case it died without
+            // saying so.
+            wait_while(shared.completed, completed, 100);
+            if (!alive(shard) && shared.completed.load(std::memory_order_acquire) != m_tick) {
+                throw game_engine_error{ "World shard " + std::to_string(shard) + " exited." };
+            }
+        }
+
+        if (0 != shared.failed.load(std::memory_order_acquire)) {
+            throw game_engine_error{
+                "World shard " + std::to_string(shard) + " failed: " + shared.error
+            };
+        }
+    }
+
+    auto alive(int shard) -> bool
+    {
+#if defined(__linux__)
+        auto& pid = m_workers[static_cast<std::size_t>(shard)];
+        if (-1 != pid && pid == ::waitpid(pid, nullptr, WNOHANG)) {
+            pid = -1;
+        }
+        return -1 != pid;
+#else // !defined(__linux__)
+        (void)shard;
+        return false;
+#endif // defined(__linux__)
+    }
+
+    void stop()
+    {
+#if defined(__linux__)
+        if (nullptr == m_memory) {
+            return;
+        }
+
+        for (auto shard = 0uz; shard < m_workers.size(); ++shard) {
+            auto& shared = control(static_cast<int>(shard));
+            shared.stop.store(1, std::memory_order_release);
+            shared.requested.store(m_tick + 1, std::memory_order_release);
+            wake_all(shared.requested);
+        }
+        for (auto pid : m_workers) {
+            if (-1 != pid) {
+                while (-1 == ::waitpid(pid, nullptr, 0) && EINTR == errno) {
+                }
+            }
+        }
+        m_workers.clear();
+
+        ::munmap(m_memory, m_memory_size);
+        m_memory = nullptr;
+#endif // defined(__linux__)
+    }
+
+    void discard_snapshots()
+    {
+        for (auto shard = 0; shard < m_options.shard_count; ++shard) {
+            auto inbound = ring(shard, ToCoordinator);
+            while (inbound.try_pop(m_message)) {
+            }
+        }
+    }
+
+    /// Give the coordinator's scene the entities in @p shard's snapshot,
+    /// reusing the proxies they had last tick.
+    void merge(game_scene& scene, int shard)
+    {
+        if (!ring(shard, ToCoordinator).try_pop(m_message)) {
+            throw game_engine_error{ "World shard " + std::to_string(shard) + " sent no snapshot." };
+        }
+
+        auto& previous = m_proxies[static_cast<std::size_t>(shard)];
+        auto current = std::unordered_map<entity_id, entity_id>{};
+        auto snapshot = std::span<std::byte const>{ m_message };
+        auto count = read_u32(snapshot, 0);
+        auto offset = 4uz;
+        for (auto i = 0u; i < count; ++i) {
+            auto remote = entity_id{ read_u64(snapshot, offset) };
+            offset += 8;
+            auto record = snapshot.subspan(offset);
+            record = record.first(record_size(record));
+            offset += record.size();
+
+            if (auto iter = previous.find(remote); previous.end() != iter) {
+                update_proxy(scene, iter->second, record);
+                current.emplace(remote, iter->second);
+                previous.erase(iter);
+            }
+            else {
+                auto entity = scene.create_entity();
+                scene.set_component(shard_proxy_component{ { entity }, shard, remote });
+                load_record(scene, entity, record);
+                if (m_options.on_proxy) {
+                    m_options.on_proxy(scene, entity);
+                }
+                current.emplace(remote, entity);
+            }
+        }
+
+        // Whatever is left has gone, or moved to another shard, which makes
+        // a proxy of its own.
+        for (auto&& [remote, entity] : previous) {
+            scene.destroy_entity(entity);
+        }
+        previous = std::move(current);
+    }
+
+    void update_proxy(game_scene& scene, entity_id entity, std::span<std::byte const> record)
+    {
+        // Move the transform rather than replacing it, so that the proxy is
+        // drawn between its last two positions like any other entity.
+        auto count = read_u32(record, 0);
+        auto offset = 4uz;
+        for (auto i = 0u; i < count; ++i) {
+            auto index = read_u32(record, offset);
+            auto size = read_u32(record, offset + 4);
+            auto bytes = record.subspan(offset + 8, size);
+            offset += 8 + size;
+
+            auto transform = 0 == index ? scene.get_component<transform_component>(entity) : nullptr;
+            if (nullptr != transform) {
+                auto saved = component_serializer<transform_component>::load(entity, bytes);
+                transform->set_position(saved.position());
+                transform->set_size(saved.size());
+            }
+            else if (index < m_streams.size()) {
+                m_streams[index].second(scene, entity, bytes);
+            }
+        }
+    }
+
+    void save_entity(game_scene& scene, entity_id entity, std::vector<std::byte>& out)
+    {
+        auto count_offset = out.size();
+        auto count = std::uint32_t{ 0 };
+        append_u32(out, count);
+
+        for (auto i = 0uz; i < m_streams.size(); ++i) {
+            auto size_offset = out.size() + 4;
+            append_u32(out, static_cast<std::uint32_t>(i));
+            append_u32(out, 0);
+            if (m_streams[i].first(scene, entity, out)) {
+                patch_u32(out, size_offset, static_cast<std::uint32_t>(out.size() - size_offset - 4));
+                ++count;
+            }
+            else {
+                out.resize(size_offset - 4);
+            }
+        }
+        patch_u32(out, count_offset, count);
+    }
+
+    void load_record(game_scene& scene, entity_id entity, std::span<std::byte const> record)
+    {
+        auto count = read_u32(record, 0);
+        auto offset = 4uz;
+        for (auto i = 0u; i < count; ++i) {
+            auto index = read_u32(record, offset);
+            auto size = read_u32(record, offset + 4);
+            if (index < m_streams.size()) {
+                m_streams[index].second(scene, entity, record.subspan(offset + 8, size));
+            }
+            offset += 8 + size;
+        }
+    }
+
+    // The rest runs in the worker processes, each with its own copy of this
+    // object as it was when they were forked.
+
+    [[noreturn]] void run_worker(int shard)
+    {
+        auto& shared = control(shard);
+        try {
+            work(shard);
+            std::_Exit(0);
+        }
+        catch (std::exception const& ex) {
+            auto length = std::min(std::strlen(ex.what()), sizeof(shared.error) - 1);
+            std::memcpy(shared.error, ex.what(), length);
+            shared.error[length] = '\0';
+        }
+        catch (...) {
+            std::strcpy(shared.error, "Unknown error.");
+        }
+
+        // Finish the tick that failed, so that the coordinator stops waiting.
+        shared.failed.store(1, std::memory_order_release);
+        shared.completed.store(shared.requested.load(std::memory_order_acquire), std::memory_order_release);
+        wake_all(shared.completed);
+        std::_Exit(1);
+    }
+
+    void work(int shard)
+    {
+        auto scene = m_options.make_scene(shard);
+        if (nullptr == scene) {
+            throw game_engine_error{ "No scene was made for the shard." };
+        }
+
+        auto& shared = control(shard);
+        auto inputs = input_state{ };
+        auto done = std::uint32_t{ 0 };
+        while (true) {
+            auto requested = shared.requested.load(std::memory_order_acquire);
+            while (requested == done) {
+                wait_while(shared.requested, done, -1);
+                requested = shared.requested.load(std::memory_order_acquire);
+            }
+            if (0 != shared.stop.load(std::memory_order_acquire)) {
+                return;
+            }
+
+            receive(*scene, shard, requested);
+            scene->tick(shared.time_step, inputs);
+            send_snapshot(*scene, shard);
+            send_leavers(*scene, shard, requested);
+
+            done = requested;
+            shared.completed.store(done, std::memory_order_release);
+            wake_all(shared.completed);
+        }
+    }
+
+    /// Instantiate the entities that neighbors sent last tick. A neighbor
+    /// that is ahead may already have sent some this tick, which are held
+    /// back for the next, so that every entity spends the same ticks in
+    /// transit, however the workers are scheduled.
+    void receive(game_scene& scene, int shard, std::uint32_t tick)
+    {
+        auto held = std::exchange(m_held, { });
+        for (auto&& message : held) {
+            instantiate(scene, message);
+        }
+
+        for (auto index : { FromLeft, FromRight }) {
+            auto inbound = ring(shard, index);
+            while (inbound.try_pop(m_message)) {
+                if (read_u32(m_message, 0) == tick) {
+                    m_held.push_back(m_message);
+                }
+                else {
+                    instantiate(scene, m_message);
+                }
+            }
+        }
+    }
+
+    void instantiate(game_scene& scene, std::span<std::byte const> message)
+    {
+        auto entity = scene.create_entity();
+        scene.set_component(sharded_component{ { entity } });
+        load_record(scene, entity, message.subspan(4));
+        if (m_options.on_arrive) {
+            m_options.on_arrive(scene, entity);
+        }
+    }
+
+    /// Send every sharded entity, including those that are about to leave,
+    /// which their new shard only shows from the next tick.
+    void send_snapshot(game_scene& scene, int shard)
+    {
+        m_record.clear();
+        append_u32(m_record, 0);
+        auto count = std::uint32_t{ 0 };
+        for (auto&& [sharded, transform] : scene.query<sharded_component, transform_component>().exec()) {
+            append_u64(m_record, sharded.entity);
+            save_entity(scene, sharded.entity, m_record);
+            ++count;
+        }
+        patch_u32(m_record, 0, count);
+
+        if (!ring(shard, ToCoordinator).try_push(m_record)) {
+            throw game_engine_error{
+                "A snapshot of " + std::to_string(m_record.size())
+                + " bytes doesn't fit in the ring to the coordinator; raise ring_bytes."
+            };
+        }
+    }
+
+    /// Hand each entity that has left this shard's strip to the neighbor on
+    /// that side, which passes it on if it went further.
+    void send_leavers(game_scene& scene, int shard, std::uint32_t tick)
+    {
+        auto left = std::vector<entity_id>{};
+        for (auto&& [sharded, transform] : scene.query<sharded_component, transform_component>().exec()) {
+            auto destination = shard_of(transform.x_position());
+            if (destination == shard) {
+                continue;
+            }
+
+            auto outbound = destination < shard
+                ? ring(shard - 1, FromRight)
+                : ring(shard + 1, FromLeft);
+            m_record.clear();
+            append_u32(m_record, tick);
+            save_entity(scene, sharded.entity, m_record);
+            if (m_record.size() > outbound.max_message()) {
+                throw game_engine_error{ "An entity is too big for the rings between shards; raise ring_bytes." };
+            }
+
+            // If the neighbor hasn't caught up with what it was sent, the
+            // entity stays here for another tick.
+            if (outbound.try_push(m_record)) {
+                left.push_back(sharded.entity);
+            }
+        }
+
+        for (auto&& entity : left) {
+            scene.destroy_entity(entity);
+        }
+    }
+
+    world_shard_options m_options;
+    std::vector<std::pair<save_function, load_function>> m_streams;
+
+    // The shared memory: a slot per shard, holding its shard_control and
+    // then its rings, each on its own cache lines.
+    std::byte* m_memory;
+    std::size_t m_memory_size;
+    std::size_t m_slot_size;
+    std::size_t m_ring_size;
+
+    /// The process of each worker, or -1 once it has been reaped.
+    std::vector<int> m_workers;
+    std::uint32_t m_tick;
+
+    /// Per shard, the proxy of each of its entities, by their ids there.
+    std::vector<std::unordered_map<entity_id, entity_id>> m_proxies;
+
+    /// In a worker, migration messages to instantiate next tick.
+    std::vector<std::vector<std::byte>> m_held;
+
+    std::vector<std::byte> m_message;
+    std::vector<std::byte> m_record;
+};
+
+mope::world_shards::world_shards(world_shard_options options)
+    : m_imp{ std::make_unique<imp>(std::move(options)) }
+{
+    // The transform is always sent first, since it decides the shard.
+    stream<transform_component>();
+}
+
+mope::world_shards::~world_shards() = default;
+
+void mope::world_shards::start()
+{
+    m_imp->start();
+}
+
+auto mope::world_shards::shard_of(float x) const -> int
+{
+    return m_imp->shard_of(x);
+}
+
+void mope::world_shards::operator()(game_scene& scene, tick_event const& event)
+{
+    m_imp->tick(scene, event.time_step);
+}
+
+void mope::world_shards::operator()(game_scene&, scene_reset_event const&)
+{
+    m_imp->reset();
+}
+
+void mope::world_shards::add_stream(save_function save, load_function load)
+{
+    m_imp->add_stream(save, load);
+}
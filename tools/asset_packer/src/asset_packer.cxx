@@ -0,0 +1,191 @@
+#include "asset_archive.hxx"
+#include "block_encoder.hxx"
+#include "image_decoder.hxx"
+#include "mip_chain.hxx"
+#include "mope_game_engine/game_engine_error.hxx"
+#include "mope_game_engine/texture.hxx"
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    constexpr auto Usage =
+        "usage: mope_asset_packer -o ARCHIVE [--root DIR] [--lz4] [--bake-images]\n"
+        "                         [--encode FORMAT] [--mipmaps] FILE...\n"
+        "\n"
+        "  -o ARCHIVE        The archive to write.\n"
+        "  --root DIR        Name entries by their path relative to DIR (default: the\n"
+        "                    current directory).\n"
+        "  --lz4             Compress entries with LZ4, where that makes them smaller.\n"
+        "  --bake-images     Decode PNG and QOI images at pack time, and store their\n"
+        "                    pixels ready for upload.\n"
+        "  --encode FORMAT   Store baked images in a GPU-compressed format: bc1 (RGB,\n"
+        "                    1-bit alpha), bc3 (RGBA), bc4 (red only, e.g. glyphs),\n"
+        "                    bc5 (red and green) or bc7 (RGBA, higher quality).\n"
+        "                    Implies --bake-images.\n"
+        "  --mipmaps         Store every mip level of baked images, so that none\n"
+        "                    need generating at load time.\n";
+
+    struct options
+    {
+        std::filesystem::path output;
+        std::filesystem::path root;
+        bool compress = false;
+        bool bake_images = false;
+        std::optional<mope::gl::pixel_format> encode;
+        bool mipmaps = false;
+        std::vector<std::filesystem::path> files;
+    };
+
+    auto parse_encoding(std::string_view name) -> mope::gl::pixel_format
+    {
+        if ("bc1" == name) {
+            return mope::gl::pixel_format::bc1;
+        }
+        else if ("bc3" == name) {
+            return mope::gl::pixel_format::bc3;
+        }
+        else if ("bc4" == name) {
+            return mope::gl::pixel_format::bc4;
+        }
+        else if ("bc5" == name) {
+            return mope::gl::pixel_format::bc5;
+        }
+        else if ("bc7" == name) {
+            return mope::gl::pixel_format::bc7;
+        }
+        throw mope::game_engine_error{ "Unrecognized texture format \"" + std::string{ name } + "\"." };
+    }
+
+    auto parse_options(int argc, char* argv[]) -> options
+    {
+        auto result = options{};
+        result.root = std::filesystem::current_path();
+        for (auto i = 1; i < argc; ++i) {
+            auto arg = std::string_view{ argv[i] };
+            if ("-o" == arg && i + 1 < argc) {
+                result.output = argv[++i];
+            }
+            else if ("--root" == arg && i + 1 < argc) {
+                result.root = argv[++i];
+            }
+            else if ("--lz4" == arg) {
+                result.compress = true;
+            }
+            else if ("--bake-images" == arg) {
+                result.bake_images = true;
+            }
+            else if ("--encode" == arg && i + 1 < argc) {
+                result.encode = parse_encoding(argv[++i]);
+                result.bake_images = true;
+            }
+            else if ("--mipmaps" == arg) {
+                result.mipmaps = true;
+            }
+            else if (arg.starts_with("-")) {
+                throw mope::game_engine_error{ "Unrecognized option \"" + std::string{ arg } + "\"." };
+            }
+            else {
+                result.files.emplace_back(arg);
+            }
+        }
+
+        if (result.output.empty() || result.files.empty()) {
+            throw mope::game_engine_error{ "An archive and at least one file are required." };
+        }
+        return result;
+    }
+
+    auto read_file(std::filesystem::path const& path) -> std::vector<std::byte>
+    {
+        auto file = std::ifstream{ path, std::ios::binary | std::ios::ate };
+        if (!file) {
+            throw mope::game_engine_error{ "Failed to open \"" + path.string() + "\"." };
+        }
+
+        auto size = static_cast<std::streamsize>(file.tellg());
+        auto contents = std::vector<std::byte>(static_cast<std::size_t>(size));
+        file.seekg(0);
+        if (!file.read(reinterpret_cast<char*>(contents.data()), size)) {
+            throw mope::game_engine_error{ "Failed to read \"" + path.string() + "\"." };
+        }
+        return contents;
+    }
+
+    auto is_image(std::filesystem::path const& path) -> bool
+    {
+        auto extension = path.extension();
+        return ".png" == extension || ".qoi" == extension;
+    }
+
+    auto make_input(options const& opts, std::filesystem::path const& path) -> mope::asset_archive_input
+    {
+        // Entries are named the way the game will ask for them, which is with
+        // forward slashes on every platform.
+        auto input = mope::asset_archive_input{
+            .name = std::filesystem::relative(path, opts.root).generic_string(),
+            .kind = mope::asset_kind::blob,
+            .contents = read_file(path),
+            .texture = { },
+            .compress = opts.compress,
+        };
+
+        if (opts.bake_images && is_image(path)) {
+            // Always RGBA, q.v. decode_image().
+            auto decoded = mope::decode_image(input.contents);
+            auto levels = opts.mipmaps
+                ? mope::build_mip_chain(decoded.pixels, decoded.size, 4)
+                : std::vector<std::vector<std::byte>>{ std::move(decoded.pixels) };
+
+            input.kind = mope::asset_kind::texture;
+            input.contents.clear();
+            auto level_size = decoded.size;
+            for (auto&& level : levels) {
+                auto stored = opts.encode
+                    ? mope::encode_blocks(level, level_size, *opts.encode)
+                    : std::move(level);
+                input.contents.insert(input.contents.end(), stored.begin(), stored.end());
+                level_size = mope::vec2i{ std::max(level_size.x() / 2, 1), std::max(level_size.y() / 2, 1) };
+            }
+
+            input.texture = {
+                .size = decoded.size,
+                .format = opts.encode.value_or(decoded.format),
+                .row_alignment = 1,
+                .levels = static_cast<int>(levels.size()),
+            };
+        }
+        return input;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try {
+        auto opts = parse_options(argc, argv);
+
+        auto inputs = std::vector<mope::asset_archive_input>{};
+        inputs.reserve(opts.files.size());
+        for (auto&& path : opts.files) {
+            inputs.push_back(make_input(opts, path));
+            std::cout << inputs.back().name << '\n';
+        }
+
+        mope::write_asset_archive(opts.output.string().c_str(), inputs);
+        return 0;
+    }
+    catch (std::exception const& ex) {
+        std::cerr << ex.what() << "\n\n" << Usage;
+        return 1;
+    }
+}
@@ -0,0 +1,310 @@
+#include "block_encoder.hxx"
+
+#include "mope_game_engine/game_engine_error.hxx"
+#include "mope_game_engine/texture.hxx"
+#include "mope_vec/mope_vec.hxx"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using texel = std::array<int, 4>;
+    using block = std::array<texel, 16>;
+
+    auto distance(texel const& a, texel const& b, std::size_t channels) -> int
+    {
+        auto result = 0;
+        for (auto c = 0uz; c < channels; ++c) {
+            result += (a[c] - b[c]) * (a[c] - b[c]);
+        }
+        return result;
+    }
+
+    void put_le(std::byte*& out, std::uint64_t value, std::size_t bytes)
+    {
+        for (auto i = 0uz; i < bytes; ++i) {
+            *out++ = static_cast<std::byte>(value >> (8 * i));
+        }
+    }
+
+    auto to_565(texel const& color) -> std::uint16_t
+    {
+        return static_cast<std::uint16_t>(
+            ((color[0] * 31 + 127) / 255) << 11
+            | ((color[1] * 63 + 127) / 255) << 5
+            | ((color[2] * 31 + 127) / 255));
+    }
+
+    auto from_565(std::uint16_t color) -> texel
+    {
+        auto r = (color >> 11) & 31;
+        auto g = (color >> 5) & 63;
+        auto b = color & 31;
+        return { (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 255 };
+    }
+
+    /// 8 bytes. With @p punch_through, pixels with alpha below half become
+    /// transparent, using BC1's three-color mode; BC3's color half can't.
+    void encode_bc1(block const& pixels, bool punch_through, std::byte*& out)
+    {
+        auto transparent = [&](texel const& pixel) { return punch_through && pixel[3] < 128; };
+
+        auto low = texel{ 255, 255, 255, 255 };
+        auto high = texel{ 0, 0, 0, 255 };
+        auto any_transparent = false;
+        for (auto&& pixel : pixels) {
+            if (transparent(pixel)) {
+                any_transparent = true;
+                continue;
+            }
+            for (auto c = 0uz; c < 3; ++c) {
+                low[c] = std::min(low[c], pixel[c]);
+                high[c] = std::max(high[c], pixel[c]);
+            }
+        }
+        if (std::ranges::all_of(pixels, transparent)) {
+            low = high = texel{ 0, 0, 0, 255 };
+        }
+
+        // Pull the ends in a little, since few pixels sit right at the
+        // corners of the box.
+        for (auto c = 0uz; c < 3; ++c) {
+            auto inset = (high[c] - low[c]) / 16;
+            low[c] += inset;
+            high[c] -= inset;
+        }
+
+        // The order of the endpoints picks the mode: four colors if the
+        // first is greater, three and transparent black if not.
+        auto color0 = to_565(high);
+        auto color1 = to_565(low);
+        if (any_transparent) {
+            std::swap(color0, color1);
+        }
+
+        auto palette = std::array<texel, 4>{ from_565(color0), from_565(color1) };
+        auto palette_size = 4uz;
+        for (auto c = 0uz; c < 3; ++c) {
+            if (any_transparent) {
+                palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            }
+            else {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+        }
+        if (any_transparent) {
+            palette_size = 3;
+        }
+        else if (color0 == color1) {
+            // Both modes would be ambiguous; every pixel is the one color.
+            palette_size = 1;
+        }
+
+        auto indices = std::uint32_t{ 0 };
+        for (auto i = 0uz; i < pixels.size(); ++i) {
+            auto best = 3uz;
+            if (!transparent(pixels[i])) {
+                best = 0;
+                for (auto j = 1uz; j < palette_size; ++j) {
+                    if (distance(pixels[i], palette[j], 3) < distance(pixels[i], palette[best], 3)) {
+                        best = j;
+                    }
+                }
+            }
+            indices |= static_cast<std::uint32_t>(best) << (2 * i);
+        }
+
+        put_le(out, color0, 2);
+        put_le(out, color1, 2);
+        put_le(out, indices, 4);
+    }
+
+    /// 8 bytes, for one channel: the alpha of BC3, and the channels of BC4
+    /// and BC5.
+    void encode_bc4(block const& pixels, std::size_t channel, std::byte*& out)
+    {
+        auto high = 0;
+        auto low = 255;
+        for (auto&& pixel : pixels) {
+            high = std::max(high, pixel[channel]);
+            low = std::min(low, pixel[channel]);
+        }
+
+        // With the first endpoint greater, there are six steps between them.
+        auto palette = std::array<int, 8>{ high, low };
+        for (auto i = 2; i < 8; ++i) {
+            palette[i] = ((8 - i) * high + (i - 1) * low) / 7;
+        }
+
+        auto indices = std::uint64_t{ 0 };
+        if (high != low) {
+            for (auto i = 0uz; i < pixels.size(); ++i) {
+                auto value = pixels[i][channel];
+                auto best = 0uz;
+                for (auto j = 1uz; j < palette.size(); ++j) {
+                    if (std::abs(value - palette[j]) < std::abs(value - palette[best])) {
+                        best = j;
+                    }
+                }
+                indices |= std::uint64_t{ best } << (3 * i);
+            }
+        }
+
+        put_le(out, static_cast<std::uint64_t>(high), 1);
+        put_le(out, static_cast<std::uint64_t>(low), 1);
+        put_le(out, indices, 6);
+    }
+
+    /// Quantize an endpoint to mode 6's seven bits a channel plus a shared
+    /// low bit, picking whichever low bit fits best.
+    auto quantize_bc7_endpoint(texel const& color, texel& quantized, int& p_bit) -> texel
+    {
+        auto best = std::numeric_limits<int>::max();
+        auto decoded = texel{};
+        for (auto p = 0; p < 2; ++p) {
+            auto candidate = texel{};
+            auto candidate_decoded = texel{};
+            for (auto c = 0uz; c < 4; ++c) {
+                candidate[c] = std::clamp((color[c] - p + 1) / 2, 0, 127);
+                candidate_decoded[c] = (candidate[c] << 1) | p;
+            }
+            if (auto error = distance(color, candidate_decoded, 4); error < best) {
+                best = error;
+                quantized = candidate;
+                p_bit = p;
+                decoded = candidate_decoded;
+            }
+        }
+        return decoded;
+    }
+
+    /// 16 bytes, in mode 6.
+    void encode_bc7(block const& pixels, std::byte*& out)
+    {
+        constexpr auto Weights = std::array{ 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+        auto low = texel{ 255, 255, 255, 255 };
+        auto high = texel{ 0, 0, 0, 0 };
+        for (auto&& pixel : pixels) {
+            for (auto c = 0uz; c < 4; ++c) {
+                low[c] = std::min(low[c], pixel[c]);
+                high[c] = std::max(high[c], pixel[c]);
+            }
+        }
+
+        auto endpoints = std::array<texel, 2>{};
+        auto p_bits = std::array<int, 2>{};
+        auto decoded = std::array{
+            quantize_bc7_endpoint(low, endpoints[0], p_bits[0]),
+            quantize_bc7_endpoint(high, endpoints[1], p_bits[1]),
+        };
+
+        auto palette = std::array<texel, 16>{};
+        for (auto i = 0uz; i < palette.size(); ++i) {
+            for (auto c = 0uz; c < 4; ++c) {
+                palette[i][c] = ((64 - Weights[i]) * decoded[0][c] + Weights[i] * decoded[1][c] + 32) >> 6;
+            }
+        }
+
+        auto indices = std::array<int, 16>{};
+        for (auto i = 0uz; i < pixels.size(); ++i) {
+            for (auto j = 1; j < 16; ++j) {
+                if (distance(pixels[i], palette[j], 4) < distance(pixels[i], palette[indices[i]], 4)) {
+                    indices[i] = j;
+                }
+            }
+        }
+
+        // The first pixel's index has only three bits, its top one being
+        // implied zero, so swap the endpoints if it needs the fourth.
+        if (indices[0] >= 8) {
+            std::swap(endpoints[0], endpoints[1]);
+            std::swap(p_bits[0], p_bits[1]);
+            for (auto&& index : indices) {
+                index = 15 - index;
+            }
+        }
+
+        auto bits = std::array<std::uint64_t, 2>{};
+        auto position = 0uz;
+        auto put = [&](std::uint64_t value, std::size_t count)
+            {
+                for (auto i = 0uz; i < count; ++i, ++position) {
+                    bits[position / 64] |= ((value >> i) & 1) << (position % 64);
+                }
+            };
+
+        put(1 << 6, 7);
+        for (auto c = 0uz; c < 4; ++c) {
+            put(static_cast<std::uint64_t>(endpoints[0][c]), 7);
+            put(static_cast<std::uint64_t>(endpoints[1][c]), 7);
+        }
+        put(static_cast<std::uint64_t>(p_bits[0]), 1);
+        put(static_cast<std::uint64_t>(p_bits[1]), 1);
+        for (auto i = 0uz; i < indices.size(); ++i) {
+            put(static_cast<std::uint64_t>(indices[i]), 0 == i ? 3 : 4);
+        }
+
+        put_le(out, bits[0], 8);
+        put_le(out, bits[1], 8);
+    }
+}
+
+auto mope::encode_blocks(std::span<std::byte const> rgba, vec2i size, gl::pixel_format format)
+    -> std::vector<std::byte>
+{
+    if (!gl::is_compressed(format)) {
+        throw game_engine_error{ "Blocks can only be encoded in a compressed format." };
+    }
+
+    auto width = size.x();
+    auto height = size.y();
+    auto result = std::vector<std::byte>(gl::image_size(format, size));
+    auto out = result.data();
+
+    for (auto block_y = 0; block_y < height; block_y += 4) {
+        for (auto block_x = 0; block_x < width; block_x += 4) {
+            auto pixels = block{};
+            for (auto i = 0; i < 16; ++i) {
+                auto x = std::min(block_x + i % 4, width - 1);
+                auto y = std::min(block_y + i / 4, height - 1);
+                auto source = rgba.data() + (static_cast<std::size_t>(y) * width + x) * 4;
+                for (auto c = 0uz; c < 4; ++c) {
+                    pixels[i][c] = static_cast<int>(source[c]);
+                }
+            }
+
+            switch (format) {
+            case gl::pixel_format::bc1:
+                encode_bc1(pixels, true, out);
+                break;
+            case gl::pixel_format::bc3:
+                encode_bc4(pixels, 3, out);
+                encode_bc1(pixels, false, out);
+                break;
+            case gl::pixel_format::bc4:
+                encode_bc4(pixels, 0, out);
+                break;
+            case gl::pixel_format::bc5:
+                encode_bc4(pixels, 0, out);
+                encode_bc4(pixels, 1, out);
+                break;
+            case gl::pixel_format::bc7:
+                encode_bc7(pixels, out);
+                break;
+            default:
+                std::unreachable();
+            }
+        }
+    }
+    return result;
+}
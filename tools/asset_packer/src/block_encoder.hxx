@@ -0,0 +1,25 @@
+#pragma once
+
+#include "mope_game_engine/texture.hxx"
+#include "mope_vec/mope_vec.hxx"
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace mope
+{
+    /// Encode tightly packed 8-bit RGBA pixels into the blocks of a
+    /// compressed @p format, for `glCompressedTexImage2D`.
+    ///
+    /// BC4 keeps only red, and BC5 red and green. Blocks at the right and
+    /// bottom edges of images whose size isn't a multiple of 4 are filled
+    /// out by repeating the last column and row.
+    ///
+    /// The encoders are quick rather than thorough: each block's endpoints
+    /// are the corners of its colors' bounding box, and BC7 only uses
+    /// mode 6 (one subset, RGBA endpoints, 4-bit indices), which suits
+    /// smooth sprites well.
+    auto encode_blocks(std::span<std::byte const> rgba, vec2i size, gl::pixel_format format)
+        -> std::vector<std::byte>;
+} // namespace mope
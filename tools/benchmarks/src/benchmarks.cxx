@@ -0,0 +1,48 @@
+#include "benchmarks.hxx"
+
+#include <algorithm>
+#include <iostream>
+#include <string_view>
+
+namespace
+{
+    struct benchmark
+    {
+        std::string_view name;
+        void (*run)();
+    };
+
+    constexpr benchmark Benchmarks[] = {
+        { "static_scene", mope::benchmarks::static_scene_dispatch },
+        { "component_stores", mope::benchmarks::component_store_pages },
+    };
+
+    void print_usage()
+    {
+        std::cerr << "usage: mope_benchmarks [NAME...]\n\nRuns every benchmark, or those named:\n";
+        for (auto const& benchmark : Benchmarks) {
+            std::cerr << "  " << benchmark.name << '\n';
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (1 == argc) {
+        for (auto const& benchmark : Benchmarks) {
+            benchmark.run();
+        }
+        return 0;
+    }
+
+    for (auto i = 1; i < argc; ++i) {
+        auto name = std::string_view{ argv[i] };
+        auto found = std::ranges::find(Benchmarks, name, &benchmark::name);
+        if (std::ranges::end(Benchmarks) == found) {
+            print_usage();
+            return 1;
+        }
+        found->run();
+    }
+    return 0;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace mope::benchmarks
+{
+    /// Run @p body @p runs times, and return the median time it took, in
+    /// milliseconds. The median keeps one slow run (a page fault storm, the
+    /// scheduler) from skewing the result.
+    template <typename Body>
+    auto median_ms(int runs, Body&& body) -> double
+    {
+        auto times = std::vector<double>{};
+        for (auto run = 0; run < runs; ++run) {
+            auto start = std::chrono::steady_clock::now();
+            body();
+            times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::ranges::sort(times);
+        return times[times.size() / 2];
+    }
+
+    /// Dispatching events through a @ref static_scene against the
+    /// type-erased queues of a @ref game_scene.
+    void static_scene_dispatch();
+
+    /// Reading components scattered across a large store, with the store on
+    /// default pages against a @ref huge_page_resource.
+    void component_store_pages();
+} // namespace mope::benchmarks
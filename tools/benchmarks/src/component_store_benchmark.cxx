@@ -0,0 +1,83 @@
+#include "benchmarks.hxx"
+
+#include "mope_game_engine/components/component.hxx"
+#include "mope_game_engine/component_manager.hxx"
+#include "mope_game_engine/huge_page_resource.hxx"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <memory_resource>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <vector>
+
+// Components are read in a shuffled order, as systems that follow links from
+// one entity to another do, so that nearly every read lands on a different
+// page from the last. That is where huge pages help: a contiguous walk is
+// mostly served by the prefetcher either way.
+
+namespace
+{
+    constexpr auto Components = 4'000'000uz;
+    constexpr auto Runs = 5;
+
+    /// 64 bytes, one cache line.
+    struct body : public mope::entity_component
+    {
+        float values[14];
+    };
+
+    /// Somewhere for the reads to go, so that they aren't optimized away.
+    auto g_sum = 0.0;
+
+    struct walk_result
+    {
+        double ms;
+
+        /// How the store's memory was mapped, if it had huge pages.
+        mope::huge_page_stats pages;
+    };
+
+    auto walk(std::pmr::memory_resource* memory, std::vector<std::size_t> const& order) -> walk_result
+    {
+        auto components = mope::component_manager{ memory };
+        for (auto entity = 1uz; entity <= Components; ++entity) {
+            auto component = body{};
+            component.entity = entity;
+            component.values[0] = static_cast<float>(entity);
+            components.set_component(std::move(component));
+        }
+
+        auto bodies = components.get_components<body>();
+        auto first = &*std::ranges::begin(bodies);
+        auto ms = mope::benchmarks::median_ms(Runs, [&]()
+            {
+                for (auto index : order) {
+                    g_sum += first[index].values[0];
+                }
+            });
+
+        auto huge_pages = dynamic_cast<mope::huge_page_resource const*>(memory);
+        return { ms, nullptr != huge_pages ? huge_pages->stats(true) : mope::huge_page_stats{ } };
+    }
+}
+
+void mope::benchmarks::component_store_pages()
+{
+    auto order = std::vector<std::size_t>(Components);
+    std::iota(order.begin(), order.end(), 0uz);
+    std::ranges::shuffle(order, std::mt19937_64{ 1 });
+
+    auto huge_pages = huge_page_resource{};
+    auto by_default = walk(std::pmr::get_default_resource(), order).ms;
+    auto [huge, pages] = walk(&huge_pages, order);
+
+    std::printf("component_stores: %zu components of %zu bytes, read in a shuffled order (median of %d runs)\n",
+        Components, sizeof(body), Runs);
+    std::printf("  default pages  %8.1f ms  %6.2f ns/read\n", by_default, by_default * 1e6 / Components);
+    std::printf("  huge pages     %8.1f ms  %6.2f ns/read  (%.2fx)\n", huge, huge * 1e6 / Components, by_default / huge);
+    std::printf("  %zu MiB mapped for the huge-page store, %zu MiB of it backed by huge pages\n",
+        pages.mapped_bytes >> 20, pages.huge_page_bytes >> 20);
+}
@@ -0,0 +1,108 @@
+#include "benchmarks.hxx"
+
+#include "mope_game_engine/events/tick.hxx"
+#include "mope_game_engine/game_scene.hxx"
+#include "mope_game_engine/static_scene.hxx"
+
+#include <cstdio>
+
+// Each tick, one system pushes a batch of pings; a second handles each ping,
+// answering every other one with a pong; a third handles the pongs. The same
+// three systems run in a game_scene, added as lambdas, and in a static_scene.
+
+namespace
+{
+    constexpr auto PingsPerTick = 1000;
+    constexpr auto Ticks = 2000;
+    constexpr auto Runs = 5;
+
+    struct ping
+    {
+        int value;
+    };
+
+    struct pong
+    {
+        int value;
+    };
+
+    /// Somewhere for the handlers' work to go, so that it isn't optimized
+    /// away.
+    auto g_sum = 0ll;
+
+    struct spawner
+    {
+        void operator()(auto& scene, mope::tick_event const&)
+        {
+            for (auto i = 0; i < PingsPerTick; ++i) {
+                scene.template emplace_event<ping>(i);
+            }
+        }
+    };
+
+    struct pinger
+    {
+        void operator()(auto& scene, ping const& event)
+        {
+            if (0 != event.value % 2) {
+                scene.template emplace_event<pong>(event.value);
+            }
+            g_sum += event.value;
+        }
+    };
+
+    struct ponger
+    {
+        void operator()(auto&, pong const& event)
+        {
+            g_sum -= event.value;
+        }
+    };
+
+    class dynamic_scene : public mope::game_scene
+    {
+    public:
+        dynamic_scene()
+        {
+            add_game_system([](mope::game_scene& scene, mope::tick_event const& event) { spawner{}(scene, event); });
+            add_game_system([](mope::game_scene& scene, ping const& event) { pinger{}(scene, event); });
+            add_game_system([](mope::game_scene& scene, pong const& event) { ponger{}(scene, event); });
+        }
+    };
+
+    using fixed_scene = mope::static_scene<mope::event_list<ping, pong>, spawner, pinger, ponger>;
+
+    template <typename Scene>
+    auto run_ticks() -> double
+    {
+        auto scene = Scene{};
+        auto inputs = mope::input_state{};
+        return mope::benchmarks::median_ms(Runs, [&]()
+            {
+                for (auto tick = 0; tick < Ticks; ++tick) {
+                    scene.tick(0.01, inputs);
+                }
+            });
+    }
+}
+
+void mope::benchmarks::static_scene_dispatch()
+{
+    // Each tick handles a tick event, the pings, and half as many pongs.
+    constexpr auto Events = Ticks * (1.0 + PingsPerTick * 1.5);
+
+    g_sum = 0;
+    auto dynamic = run_ticks<dynamic_scene>();
+    auto dynamic_sum = g_sum;
+
+    g_sum = 0;
+    auto fixed = run_ticks<fixed_scene>();
+    auto fixed_sum = g_sum;
+
+    std::printf("static_scene: %d ticks of %d pings (median of %d runs)\n", Ticks, PingsPerTick, Runs);
+    std::printf("  game_scene    %8.1f ms  %6.1f ns/event\n", dynamic, dynamic * 1e6 / Events);
+    std::printf("  static_scene  %8.1f ms  %6.1f ns/event  (%.2fx)\n", fixed, fixed * 1e6 / Events, dynamic / fixed);
+    if (dynamic_sum != fixed_sum) {
+        std::printf("  The scenes disagree: %lld against %lld.\n", dynamic_sum, fixed_sum);
+    }
+}
@@ -0,0 +1,147 @@
+#include "flight_recorder.hxx"
+#include "mope_game_engine/game_engine_error.hxx"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#endif
+
+namespace
+{
+    constexpr auto Usage =
+        "usage: mope_flight_decoder [--keys] RECORDING\n"
+        "\n"
+        "  --keys   Also list the keys pressed, released and held each tick.\n";
+
+    /// Type names are recorded as `typeid(...).name()`, which GCC and Clang
+    /// mangle.
+    auto demangle(std::string const& name) -> std::string
+    {
+#if __has_include(<cxxabi.h>)
+        auto status = 0;
+        if (auto demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status)) {
+            auto result = std::string{ demangled };
+            std::free(demangled);
+            return result;
+        }
+#endif
+        return name;
+    }
+
+    auto format_keys(std::uint64_t const (&words)[4]) -> std::string
+    {
+        auto result = std::string{};
+        for (auto key = 0uz; key < 256; ++key) {
+            if (0 != (words[key / 64] & (std::uint64_t{ 1 } << (key % 64)))) {
+                result += (result.empty() ? "" : ",") + std::to_string(key);
+            }
+        }
+        return result.empty() ? "-" : result;
+    }
+
+    void print_record(
+        mope::flight_recording const& recording,
+        mope::flight_record const& record,
+        bool in_progress,
+        bool keys)
+    {
+        char line[256];
+        std::snprintf(
+            line,
+            sizeof(line),
+            "#%llu scene %u  dt %.4f s  %s%.3f ms  entities %llu (%llu dormant)  components %llu  cursor (%.1f, %.1f) d(%.1f, %.1f)\n",
+            static_cast<unsigned long long>(record.sequence),
+            record.scene,
+            record.time_step,
+            in_progress ? "IN PROGRESS " : "",
+            record.tick_ns / 1e6,
+            static_cast<unsigned long long>(record.entities_created),
+            static_cast<unsigned long long>(record.entities_dormant),
+            static_cast<unsigned long long>(record.components),
+            record.cursor_position[0],
+            record.cursor_position[1],
+            record.cursor_deltas[0],
+            record.cursor_deltas[1]
+        );
+        std::cout << line;
+
+        if (keys) {
+            std::cout << "    pressed " << format_keys(record.pressed_keys)
+                << "  released " << format_keys(record.released_keys)
+                << "  held " << format_keys(record.held_keys) << '\n';
+        }
+
+        // A torn record may have any count at all.
+        auto count = record.event_type_count;
+        if (count > mope::flight_record::MaxEventTypes) {
+            count = mope::flight_record::MaxEventTypes;
+        }
+        for (auto i = 0u; i < count; ++i) {
+            auto const& event = record.events[i];
+            auto name = event.type < recording.names.size()
+                ? demangle(recording.names[event.type])
+                : std::string{ "(other events)" };
+            std::snprintf(
+                line,
+                sizeof(line),
+                "    %8u x %10.3f ms  ",
+                event.count,
+                event.handler_ns / 1e6
+            );
+            std::cout << line << name << '\n';
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    auto keys = false;
+    char const* path = nullptr;
+    for (auto i = 1; i < argc; ++i) {
+        auto arg = std::string_view{ argv[i] };
+        if ("--keys" == arg) {
+            keys = true;
+        }
+        else if (nullptr == path && !arg.starts_with("-")) {
+            path = argv[i];
+        }
+        else {
+            std::cerr << Usage;
+            return 1;
+        }
+    }
+    if (nullptr == path) {
+        std::cerr << Usage;
+        return 1;
+    }
+
+    try {
+        auto recording = mope::read_flight_recording(path);
+        auto const& header = recording.header;
+
+        if (0 == header.reason) {
+            std::cout << "Dumped after an exception.\n";
+        }
+        else {
+            std::cout << "Dumped on signal " << header.reason << ".\n";
+        }
+        std::cout << header.record_count << " complete ticks, oldest first.\n\n";
+
+        for (auto i = 0uz; i < recording.records.size(); ++i) {
+            print_record(recording, recording.records[i], i == header.record_count, keys);
+        }
+        return 0;
+    }
+    catch (std::exception const& ex) {
+        std::cerr << ex.what() << '\n';
+        return 1;
+    }
+}
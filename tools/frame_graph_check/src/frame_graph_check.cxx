@@ -0,0 +1,216 @@
+#include "mope_game_engine/frame_graph.hxx"
+#include "mope_game_engine/game_engine_error.hxx"
+#include "mope_vec/mope_vec.hxx"
+
+#include <cstring>
+#include <iostream>
+#include <span>
+#include <string>
+#include <vector>
+
+// Compiling a frame graph needs no graphics context, so each check builds a
+// graph, compiles it, and looks at the plan.
+
+namespace
+{
+    using builder = mope::frame_graph::pass_builder;
+
+    auto g_failures = 0;
+
+    void check(bool condition, char const* what)
+    {
+        if (!condition) {
+            std::cerr << "FAILED: " << what << '\n';
+            ++g_failures;
+        }
+    }
+
+    auto order_is(mope::frame_graph const& graph, std::span<char const* const> expected) -> bool
+    {
+        auto order = graph.order();
+        if (order.size() != expected.size()) {
+            return false;
+        }
+        for (auto i = 0uz; i < order.size(); ++i) {
+            if (0 != std::strcmp(order[i], expected[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    auto describe(mope::frame_graph const& graph) -> std::string
+    {
+        auto result = std::string{};
+        for (auto name : graph.order()) {
+            result += (result.empty() ? "" : " ") + std::string{ name };
+        }
+        return result;
+    }
+
+    /// Passes whose output never reaches the window are left out, along with
+    /// the passes that only feed them.
+    void check_culling()
+    {
+        auto graph = mope::frame_graph{};
+        auto scene = mope::render_target_handle{};
+        auto debug = mope::render_target_handle{};
+        auto debug_blur = mope::render_target_handle{};
+        graph.add_pass("scene", [&](builder& pass) { scene = pass.create({}); pass.write(scene); }, {});
+        graph.add_pass("debug", [&](builder& pass) { pass.read(scene); debug = pass.create({}); pass.write(debug); }, {});
+        graph.add_pass("debug blur", [&](builder& pass)
+            {
+                pass.read(debug);
+                debug_blur = pass.create({});
+                pass.write(debug_blur);
+            }, {});
+        graph.add_pass("present", [&](builder& pass) { pass.read(scene); pass.write(graph.backbuffer()); }, {});
+        graph.compile();
+
+        constexpr char const* Expected[] = { "scene", "present" };
+        check(order_is(graph, Expected), "culling: only scene and present run");
+        check(2 == graph.stats().culled_passes, "culling: two passes are culled");
+        check(-1 == graph.framebuffer_of(debug), "culling: a culled pass's target gets no framebuffer");
+        check(-1 == graph.framebuffer_of(debug_blur), "culling: so does the target of a pass that only feeds it");
+    }
+
+    /// A kept pass runs, with the passes it reads from, though nothing reads
+    /// what it draws.
+    void check_keep()
+    {
+        auto graph = mope::frame_graph{};
+        auto scene = mope::render_target_handle{};
+        auto capture = mope::render_target_handle{};
+        graph.add_pass("scene", [&](builder& pass) { scene = pass.create({}); pass.write(scene); }, {});
+        graph.add_pass("capture", [&](builder& pass)
+            {
+                pass.read(scene);
+                capture = pass.create({ mope::vec2i{ 64, 64 } });
+                pass.write(capture);
+                pass.keep();
+            }, {});
+        graph.add_pass("unused", [&](builder& pass) { pass.write(pass.create({})); }, {});
+        graph.compile();
+
+        constexpr char const* Expected[] = { "scene", "capture" };
+        check(order_is(graph, Expected), "keep: a kept pass and its inputs run");
+        check(1 == graph.stats().culled_passes, "keep: only the unused pass is culled");
+        check(-1 != graph.framebuffer_of(capture), "keep: a kept pass's target gets a framebuffer");
+    }
+
+    /// Every target is written before it is read, whatever order the passes
+    /// were added in, and passes with no say in the matter keep theirs.
+    void check_ordering()
+    {
+        auto graph = mope::frame_graph{};
+        auto scene = mope::render_target_handle{};
+        auto bright = mope::render_target_handle{};
+        auto blur = mope::render_target_handle{};
+        auto ui = mope::render_target_handle{};
+
+        // Targets are created by the first pass to mention them, so the
+        // readers, added first, create them here.
+        graph.add_pass("tonemap", [&](builder& pass)
+            {
+                scene = pass.create({});
+                blur = pass.create({ mope::vec2i{ 128, 128 } });
+                pass.read(scene);
+                pass.read(blur);
+                pass.write(graph.backbuffer());
+            }, {});
+        graph.add_pass("blur", [&](builder& pass)
+            {
+                bright = pass.create({ mope::vec2i{ 128, 128 } });
+                pass.read(bright);
+                pass.write(blur);
+            }, {});
+        graph.add_pass("ui", [&](builder& pass) { ui = pass.create({}); pass.write(ui); }, {});
+        graph.add_pass("bright", [&](builder& pass) { pass.read(scene); pass.write(bright); }, {});
+        graph.add_pass("scene", [&](builder& pass) { pass.write(scene); }, {});
+        graph.add_pass("overlay", [&](builder& pass) { pass.read(ui); pass.write(graph.backbuffer()); }, {});
+        graph.compile();
+
+        constexpr char const* Expected[] = { "ui", "scene", "bright", "blur", "tonemap", "overlay" };
+        check(order_is(graph, Expected), ("ordering: writers run before readers, got " + describe(graph)).c_str());
+    }
+
+    /// Targets of the same description whose uses don't overlap share a
+    /// framebuffer; targets whose uses overlap, or whose descriptions differ,
+    /// don't.
+    void check_aliasing()
+    {
+        auto graph = mope::frame_graph{};
+        auto chain = std::vector<mope::render_target_handle>(4);
+        auto small = mope::render_target_handle{};
+        graph.add_pass("first", [&](builder& pass) { chain[0] = pass.create({}); pass.write(chain[0]); }, {});
+        for (auto i = 1uz; i < chain.size(); ++i) {
+            graph.add_pass("next", [&](builder& pass)
+                {
+                    pass.read(chain[i - 1]);
+                    chain[i] = pass.create({});
+                    pass.write(chain[i]);
+                }, {});
+        }
+        graph.add_pass("small", [&](builder& pass)
+            {
+                pass.read(chain.back());
+                small = pass.create({ mope::vec2i{ 32, 32 } });
+                pass.write(small);
+            }, {});
+        graph.add_pass("present", [&](builder& pass) { pass.read(small); pass.write(graph.backbuffer()); }, {});
+        graph.compile();
+
+        // Each step of the chain reads the one before while writing its own,
+        // so neighbors overlap, but every other one can share.
+        check(graph.framebuffer_of(chain[0]) != graph.framebuffer_of(chain[1]), "aliasing: overlapping targets don't share");
+        check(graph.framebuffer_of(chain[0]) == graph.framebuffer_of(chain[2]), "aliasing: disjoint targets share");
+        check(graph.framebuffer_of(chain[1]) == graph.framebuffer_of(chain[3]), "aliasing: disjoint targets share");
+        check(graph.framebuffer_of(small) != graph.framebuffer_of(chain[0])
+            && graph.framebuffer_of(small) != graph.framebuffer_of(chain[1]),
+            "aliasing: targets of other sizes don't share");
+        check(5 == graph.stats().transient_targets, "aliasing: five transient targets are used");
+        check(3 == graph.stats().framebuffers, "aliasing: they need three framebuffers");
+    }
+
+    /// Passes that depend on each other in a cycle can't be ordered.
+    void check_cycle()
+    {
+        auto graph = mope::frame_graph{};
+        auto a = mope::render_target_handle{};
+        auto b = mope::render_target_handle{};
+        graph.add_pass("x", [&](builder& pass)
+            {
+                a = pass.create({});
+                b = pass.create({});
+                pass.read(b);
+                pass.write(a);
+            }, {});
+        graph.add_pass("y", [&](builder& pass) { pass.read(a); pass.write(b); }, {});
+        graph.add_pass("present", [&](builder& pass) { pass.read(b); pass.write(graph.backbuffer()); }, {});
+
+        auto threw = false;
+        try {
+            graph.compile();
+        }
+        catch (mope::game_engine_error const&) {
+            threw = true;
+        }
+        check(threw, "cycle: compiling throws game_engine_error");
+    }
+}
+
+int main()
+{
+    check_culling();
+    check_keep();
+    check_ordering();
+    check_aliasing();
+    check_cycle();
+
+    if (0 != g_failures) {
+        std::cerr << g_failures << " checks failed.\n";
+        return 1;
+    }
+    std::cout << "Every frame graph check passed.\n";
+    return 0;
+}
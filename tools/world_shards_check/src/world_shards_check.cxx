@@ -0,0 +1,196 @@
+#include "mope_game_engine/components/transform.hxx"
+#include "mope_game_engine/events/tick.hxx"
+#include "mope_game_engine/game_engine_error.hxx"
+#include "mope_game_engine/game_scene.hxx"
+#include "mope_game_engine/world_shards.hxx"
+
+#include <iostream>
+#include <latch>
+#include <memory>
+#include <string>
+#include <thread>
+
+// Each check forks real workers, which only works while this is the only
+// thread, so the check that starts a thread of its own goes last.
+
+namespace
+{
+    using mope::world_shards;
+
+    auto g_failures = 0;
+
+    void check(bool condition, char const* what)
+    {
+        if (!condition) {
+            std::cerr << "FAILED: " << what << '\n';
+            ++g_failures;
+        }
+    }
+
+    /// The scene of a shard. Every sharded entity moves one unit along x
+    /// each tick, and ticks from `fail_at` on throw.
+    class shard_scene : public mope::game_scene
+    {
+    public:
+        explicit shard_scene(int fail_at)
+        {
+            add_game_system("move", [fail_at, ticks = 0](mope::game_scene& scene, mope::tick_event const&) mutable
+                {
+                    if (++ticks == fail_at) {
+                        throw mope::game_engine_error{ "Failed on purpose." };
+                    }
+                    for (auto&& [sharded, transform] : scene.query<mope::sharded_component, mope::transform_component>().exec()) {
+                        transform.set_x(transform.x_position() + 1.0f);
+                    }
+                });
+        }
+    };
+
+    class coordinator_scene : public mope::game_scene
+    {
+    };
+
+    /// Two shards split at x = 10, with one entity starting at x = 5 in the
+    /// first. Shard `failing` fails on its tick `fail_at`.
+    auto make_options(int failing = -1, int fail_at = 0) -> mope::world_shard_options
+    {
+        auto options = mope::world_shard_options{};
+        options.shard_count = 2;
+        options.shard_width = 10.0f;
+        options.ring_bytes = 64uz << 10;
+        options.make_scene = [failing, fail_at](int shard) -> std::unique_ptr<mope::game_scene>
+            {
+                auto scene = std::make_unique<shard_scene>(shard == failing ? fail_at : 0);
+                if (0 == shard) {
+                    auto entity = scene->create_entity();
+                    scene->set_component(mope::sharded_component{ { entity } });
+                    scene->set_component(mope::transform_component{
+                        entity, mope::vec3f{ 5.0f, 0.0f, 0.0f }, mope::vec3f{ 1.0f, 1.0f, 1.0f } });
+                }
+                return scene;
+            };
+        return options;
+    }
+
+    struct proxy_view
+    {
+        int count = 0;
+        int shard = -1;
+        float x = 0.0f;
+    };
+
+    auto proxies(mope::game_scene& scene) -> proxy_view
+    {
+        auto view = proxy_view{};
+        for (auto&& [proxy, transform] : scene.query<mope::shard_proxy_component, mope::transform_component>().exec()) {
+            ++view.count;
+            view.shard = proxy.shard;
+            view.x = transform.x_position();
+        }
+        return view;
+    }
+
+    // The system is ticked directly, rather than through the scene, since a
+    // scene isn't meant to tick on after one of its systems has thrown.
+    void tick(world_shards& shards, mope::game_scene& scene)
+    {
+        auto inputs = mope::input_state{};
+        shards(scene, mope::tick_event{ 0.01, inputs });
+    }
+
+    auto tick_throws(world_shards& shards, mope::game_scene& scene, std::string const& expected) -> bool
+    {
+        try {
+            tick(shards, scene);
+        }
+        catch (mope::game_engine_error const& ex) {
+            return std::string{ ex.what() }.contains(expected);
+        }
+        return false;
+    }
+
+    /// Ticking before the workers have been started is an error, rather
+    /// than a fork from wherever the tick happens to run.
+    void check_unstarted()
+    {
+        auto shards = world_shards{ make_options() };
+        auto scene = coordinator_scene{};
+        check(tick_throws(shards, scene, "started"), "unstarted: ticking throws game_engine_error");
+    }
+
+    /// An entity crossing the border is handed to the next shard, and has
+    /// exactly one proxy, at its simulated position, on every tick.
+    void check_migration()
+    {
+        auto shards = world_shards{ make_options() };
+        shards.start();
+        auto scene = coordinator_scene{};
+
+        auto always_one = true;
+        auto in_step = true;
+        for (auto ticks = 1; ticks <= 10; ++ticks) {
+            tick(shards, scene);
+            auto view = proxies(scene);
+            always_one = always_one && 1 == view.count;
+            in_step = in_step && 5.0f + static_cast<float>(ticks) == view.x;
+        }
+        check(always_one, "migration: there is one proxy on every tick");
+        check(in_step, "migration: the proxy is where the shard simulated it");
+        check(1 == proxies(scene).shard, "migration: the entity ends up in the second shard");
+    }
+
+    /// A failing shard makes its tick throw, and neither that tick nor the
+    /// next merges what the healthy shard sent.
+    void check_failure()
+    {
+        auto shards = world_shards{ make_options(1, 3) };
+        shards.start();
+        auto scene = coordinator_scene{};
+
+        tick(shards, scene);
+        tick(shards, scene);
+        check(7.0f == proxies(scene).x, "failure: the shards tick until one fails");
+        check(tick_throws(shards, scene, "Failed on purpose."), "failure: the failing tick throws the shard's error");
+        check(tick_throws(shards, scene, "World shard 1"), "failure: so does every tick after it");
+        check(7.0f == proxies(scene).x, "failure: no snapshot of a failed tick is merged");
+    }
+
+    /// Forking while another thread runs would leave the workers with
+    /// whatever that thread had locked, so starting refuses.
+    void check_threaded_start()
+    {
+        auto release = std::latch{ 1 };
+        auto other = std::jthread{ [&release]() { release.wait(); } };
+
+        auto shards = world_shards{ make_options() };
+        auto threw = false;
+        try {
+            shards.start();
+        }
+        catch (mope::game_engine_error const&) {
+            threw = true;
+        }
+        release.count_down();
+        check(threw, "threaded start: starting with another thread throws game_engine_error");
+    }
+}
+
+int main()
+{
+#if defined(__linux__)
+    check_unstarted();
+    check_migration();
+    check_failure();
+    check_threaded_start();
+
+    if (0 != g_failures) {
+        std::cerr << g_failures << " checks failed.\n";
+        return 1;
+    }
+    std::cout << "Every world shards check passed.\n";
+    return 0;
+#else // !defined(__linux__)
+    std::cout << "World shards only run on Linux; there is nothing to check.\n";
+    return 0;
+#endif // defined(__linux__)
+}